@@ -1,1178 +1,8239 @@
-#include <stdlib.h>
-#include <io.h> // _access
-#include <stdio.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <string.h>
-#include <ctype.h>
-#include <errno.h>
-
-// Example cmd line program invocation: Inventory.exe -w 180.75 -m 4gp 42sp 69cp greatsword.json explorers-pack.json small-knife.json 2 waterskin.json leather-armor.json -c camp.log
-
-#define FILE_PATH_BUFFER_MIN 6  // minimum chars: 'single char" + ".txt" or ".log" + '\0' => minimum 6 chars 
-#define FILE_PATH_BUFFER_MAX 99 
-#define MAX_ITEM_AMOUNT      76 // Wiki: beginners can have 76 slots + 2 extra can be obtained in game after achieving favor with The Coin Lords faction
-
-
-typedef struct Money 
-{
-	int gp;
-	int sp;
-	int cp;
-} Money;
-
-typedef struct Node Item;
-struct Node
-{
-	char index[50];
-	char file_name[100];     // json file path
-	char name[50];
-	Money money;
-	float weight;
-	char url[100];
-	char equipment_category[50];
-	Item* prev;
-	Item* next;
-};
-typedef struct Node ItemList; // Used to have a more explaining typename for the variable that holds the node list
-
-typedef struct Inventory
-{
-	float max_weight;
-	Money money;
-	uint8_t item_count;
-	ItemList* items;
-	char item_file_paths[MAX_ITEM_AMOUNT][50]; 
-	char log_file_name[26];   // Min buffer length: 6, Max buffer length: 100 => Parser only handles up to 99 chars + '\0'!
-} Inventory;
-
-#ifdef _WIN32 // Windows system
-void ClearScreen(void)
-{
-	system("cls");
-}
-#else // Linux system
-void ClearScreen(void)
-{
-	system("clear");
-}
-#endif
-
-// MAIN ARGUMENT PARSING
-void PrintProgramArgs(int argc, char* argv[]);
-void ParseProgramArgs(int argc, char* argv[], Inventory* inventory);
-bool IsFloat(char* float_string);
-
-// JSON FILE PARSING
-Item* JsonParse(char* file_path);
-
-// GAME ITEM LIST / INVENTORY
-ItemList* ItemListCreate(Item* new_item);
-Item* ItemCreate(/*char* index*/);
-void ItemPush(Inventory* inventory, Item* new_item);
-void ItemPop(Inventory* inventory, char* index);      // The original Item Pointer will be set to NULL !
-void ItemFree(Item** item);                           // Item** because the original pointer variable is set to NULL
-void ItemPrintBasicInfo(Item* item);
-void ItemPrintAdvancedInfo(Item* item);
-void ItemPrintList(ItemList* items);
-void ItemPrintJsonPathList(Inventory* inventory);
-uint8_t InventoryGetItemCount(Inventory* inventory);
-bool IsInventoryEmpty(Inventory* inventory);
-
-void UserItemAdd(Inventory* inventory, char* file_path);
-
-// GAME LOOP
-void PrintInventoryHelpMenu(void);
-void PrintItemHelpMenu(void);
-
-// CHECK MONEY AMOUNT
-// SUBTRACT MONEY
-int convert_to_cp(const Money* money);
-Money convert_from_cp(int total_cp);
-int subtract_money(const Money* available, const Money* cost, Money* remaining);
-void add_money(const Money* available, const Money* cost, Money* inventory_money);
-
-void WriteToLogFile(Inventory* inventory, char* log_file_path);
-
-
-int main(int argc, char* argv[])
-{
-	// TO DO: SAVE THE CURRENT JSON PATH LIST TO THE CAMP FILE ON PROGRAM EXIST, THIS WAY THE USER CAN ENTER THE FILES WHERE HE LEFT THE INVENTORY THE LAST TIME
-
-	printf("\nDND Inventory app:\n\n");
-
-	// printf("Executable name: %s\n", argv[0]);
-
-	PrintProgramArgs(argc, argv); 
-
-	Inventory inventory = { 0 };
-	for (int i = 0; i < MAX_ITEM_AMOUNT; ++i)
-		*(inventory.item_file_paths[i]) = '\0';
-
-	ParseProgramArgs(argc, argv, &inventory); 
-
-	uint8_t item_amount_to_push = 0;
-	while (*(inventory.item_file_paths[item_amount_to_push]) != '\0')
-		++item_amount_to_push;
-	printf("Amount of json files to parse: %d\n\n", item_amount_to_push);
-
-	ItemPrintJsonPathList(&inventory);
-
-	printf("Parsing Json files to Item objects.\n");
-
-	Item* new_item = NULL;
-	for (int i = 0; i < item_amount_to_push; ++i)
-	{
-		new_item = JsonParse(inventory.item_file_paths[i]);
-
-		printf("\nNew Item created from JSON file. Index: %s, Name: %s\n\n", new_item->index, new_item->name); 
-		ItemPush(&inventory, new_item); 
-		printf("\n");
-	}
-
-	bool exit_inventory = false;
-	bool view_item_one_by_one = false;
-	char user_input = '\0';
-
-	printf("Inventory app start:\n");
-	PrintInventoryHelpMenu();
-
-	while (!exit_inventory)
-	{
-		scanf(" %c", &user_input); // NOTE: THE LEADING SPACE BEFORE THE CHARACTER SPECIFIER IN THE FORMAT STRING REMOVES ISSUES WITH CHARACTERS LIKE TRAILING NEW LINES IN THE USER INPUT.
-
-		switch (user_input)
-		{
-		case 'a':
-		case 'A':
-			printf("Total item amount: %d\n", inventory.item_count);
-			break;
-		case 'c':
-		case 'C':
-			ClearScreen();
-			break;
-		case 'h':
-		case 'H':
-			PrintInventoryHelpMenu();
-			break;
-		case 'i':
-		case 'I':
-			view_item_one_by_one = true;
-			PrintItemHelpMenu();
-
-			Item* current_item = inventory.items; // SET THE FIRST ITEM IN THE LIST AS ITEM TO VIEW
-			ItemPrintBasicInfo(current_item); // PRINT BASIC INFO ABOUT THE FIRST ITEM.
-
-			while (view_item_one_by_one) 
-			{
-				scanf(" %c", &user_input); // NOTE: THE LEADING SPACE BEFORE THE CHARACTER SPECIFIER IN THE FORMAT STRING REMOVES ISSUES WITH CHARACTERS LIKE TRAILING NEW LINES IN THE USER INPUT.
-
-				switch (user_input)
-				{
-					case 'c':
-					case 'C':
-						ClearScreen();
-						break;
-					case 'd':
-					case 'D':
-						ItemPrintAdvancedInfo(current_item);
-						break;
-					case 'h':
-					case 'H':
-						PrintItemHelpMenu(); 
-						break;
-					break;
-					case 'n':
-					case 'N':
-						if (current_item)
-						{
-							current_item = current_item->next;
-							ItemPrintBasicInfo(current_item);
-						}
-						else
-						{
-							printf("No items available to display.\n");
-						}
-						break;
-					case 'p':
-					case 'P':
-						if (current_item)
-						{
-							current_item = current_item->prev;
-							ItemPrintBasicInfo(current_item);
-						}
-						else
-						{
-							printf("No items available to display.\n");
-						}
-						break;
-					case 'q':
-					case 'Q':
-						view_item_one_by_one = false;
-						printf("Quiting item view.\n");
-						PrintInventoryHelpMenu();
-						break;
-					case 'x':
-					case 'X':
-						if (current_item)
-						{
-							bool user_answered = false;
-							while (!user_answered)
-							{
-								printf("Are you sure you want to delete this item ? ( N / Y )\n");
-								scanf(" %c", &user_input); // NOTE: THE LEADING SPACE BEFORE THE CHARACTER SPECIFIER IN THE FORMAT STRING REMOVES ISSUES WITH CHARACTERS LIKE TRAILING NEW LINES IN THE USER INPUT.
-
-								switch (user_input)
-								{
-								case 'n':
-								case 'N':
-									ItemPrintBasicInfo(current_item);
-									user_answered = true;
-									break;
-								case 'y':
-								case 'Y': // TO DO: ADJUST MONEY AND WEIGHT 
-									if (current_item)
-									{
-										Item* temp = current_item->prev; // SAVE THE PREVIOUS ITEM IN THE LIST TO SHOW IT'S INFORMATION WHEN THE CURRENT ITEM IS DELETED
-										ItemPop(&inventory, current_item->index);
-
-										if (IsInventoryEmpty(&inventory))
-											current_item = NULL;
-										else
-											current_item = temp;
-
-										ItemPrintBasicInfo(current_item);
-									}
-									else
-									{
-										printf("The list is empty.\n");
-									}
-									user_answered = true;
-									break;
+#include <stdlib.h>
+#ifdef _WIN32
+#include <io.h> // _access, _findfirst
+#include <conio.h> // _getch
+#include <windows.h> // QueryPerformanceCounter
+#include <sys/stat.h> // _stat64
+#else
+#include <unistd.h> // access
+#include <dirent.h> // opendir
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <pthread.h> // pthread_create
+#include <time.h> // clock_gettime
+#include <termios.h> // tcsetattr
+#include <sys/ioctl.h> // TIOCGWINSZ
+#include <signal.h> // signal
+#define _access access
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <float.h> // FLT_MAX
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // _mm_mul_epu32
+#define VALUATION_SSE2 // Every x86-64 cpu has SSE2, other cpus use the scalar valuation kernels
+#endif
+
+// Example cmd line program invocation: Inventory.exe -w 180.75 -m 4gp 42sp 69cp greatsword.json explorers-pack.json small-knife.json 2 waterskin.json leather-armor.json -c camp.log
+// Example pack tool invocation:          Inventory.exe --pack-build Items.pack --pack-compress
+// Afterwards the items can be read from the pack: Inventory.exe --pack Items.pack -w 180.75 -m 4gp 42sp 69cp greatsword.json 2 waterskin.json
+// Other processes can read the inventory: Inventory.exe --shm camp ... and while it runs: Inventory.exe --shm-view camp
+// Big loadouts: Inventory.exe -w 180.75 @loadout.txt "*-arrow*.json" 20 (the response file holds item arguments: "greatsword.json 2", "*.json", # comments)
+// Export for spreadsheets and analytics jobs: Inventory.exe -w 180.75 @loadout.txt --export camp.csv (or camp.jsonl for JSON Lines)
+// Camps that move between machines: Inventory.exe --save camp.inv ... keeps the camp, Inventory.exe --delta-emit old.inv camp.inv camp.delta writes the changes since old.inv
+// and Inventory.exe --delta-apply old.inv camp.delta camp.inv turns the old save file of the other machine into the new one
+// Snapshot readers against a live writer: Inventory.exe --snapshot-stress 8 5000 (up to 8 reader threads, 5000 item stacks, exit code 4 if a reader sees a torn snapshot)
+
+#define FILE_PATH_BUFFER_MIN 6  // minimum chars: 'single char" + ".txt" or ".log" + '\0' => minimum 6 chars 
+#define FILE_PATH_BUFFER_MAX 99 
+#define ITEM_REQUEST_PRINT_MAX 100   // ItemPrintJsonPathList only prints the first json files of a big loadout
+#define RESPONSE_FILE_CHUNK    65536 // Bytes read from a response file at a time
+#define NUMBER_WEIGHT_TEXT_MAX 24    // NumberFormatWeight buffer: "%.9g" of any float fits
+#define EXPORT_BUFFER_SIZE     65536 // Bytes of an export collected before one write: the memory of an export doesn't grow with the inventory
+#define EXPORT_FORMAT_JSON_LINES 0   // One json object per item stack
+#define EXPORT_FORMAT_CSV        1   // A header line, then one row per item stack, fields quoted like RFC 4180
+
+#define ITEM_FOLDER_NAME     "Items_JSON"
+#ifdef _WIN32
+#define PATH_SEPARATOR       "\\"
+#else
+#define PATH_SEPARATOR       "/"
+#endif
+
+#define JSON_PARSE_EAGER     0x00 // Only index, name, weight and cost: the fields needed by ItemPush
+#define JSON_PARSE_DETAILS   0x01 // Only url and equipment category
+#define JSON_PARSE_QUIET     0x02 // Don't print every key value pair (used when scanning the whole item folder)
+#define JSON_PARSE_MAX_DEPTH 16   // Deeper objects and arrays are skipped, item fields are never that deep
+
+// Keys that JsonParseString looks for, every other key is JSON_KEY_UNKNOWN
+#define JSON_KEY_UNKNOWN            0
+#define JSON_KEY_INDEX              1
+#define JSON_KEY_NAME               2
+#define JSON_KEY_WEIGHT             3
+#define JSON_KEY_COST               4
+#define JSON_KEY_QUANTITY           5
+#define JSON_KEY_UNIT               6
+#define JSON_KEY_URL                7
+#define JSON_KEY_EQUIPMENT_CATEGORY 8
+
+#define STATS_FILE_NAME         "Inventory_stats.json" // Written on program exit
+
+#define PARSE_CACHE_FILE_NAME   "Inventory_cache.bin"  // Next to the executable, written when the program quits
+#define PARSE_CACHE_MAGIC       "IVPC"
+#define PARSE_CACHE_VERSION     1                      // Increase when the entry layout or the meaning of a cached field changes
+
+#define PACK_MAGIC              "IVPK"
+#define PACK_VERSION            1
+#define PACK_ENTRY_COMPRESSED   0x01                   // The stored bytes are PackCompress output, else they are the json text as is
+#define PACK_HASH_BITS          12                     // PackCompress remembers the last position of 4096 hashed 4 byte sequences
+#define PACK_MIN_MATCH          4
+#define PACK_MAX_MATCH          (0x7F + PACK_MIN_MATCH)
+#define PACK_MAX_LITERALS       0x80
+#define PACK_MAX_DISTANCE       0xFFFF
+
+#define SHARED_MAGIC            "IVSM"
+#define SHARED_LAYOUT_VERSION   1
+#define SHARED_SEGMENT_SIZE     (16 * 1024 * 1024)    // Fixed size: a bigger inventory only shares the rows that fit (is_truncated)
+#define SHARED_NAME_LENGTH      64
+#define SHARED_READ_RETRIES     1000                  // A reader gives up after this many reads that overlapped a write
+
+#define SAVE_MAGIC              "IVSV"
+#define SAVE_VERSION            1
+#define DELTA_MAGIC             "IVDL"
+#define DELTA_VERSION           1
+#define CHANGE_LOG_MAX_RECORDS  65536                  // A save file keeps the newest changes, a sync from an older version sends a state diff
+
+#define CHANGE_PUSH             1                      // Copies pushed: the data of the pushed item, a new stack is made from it
+#define CHANGE_POP              2
+#define CHANGE_PRICE            3                      // New price of one copy of a stack (V command)
+#define CHANGE_MONEY            4                      // The money and the carrying capacity (-m and -w on a saved camp, the end of every delta)
+
+#define HASH_FNV1A_SEED         0xcbf29ce484222325ULL
+#define HASH_FNV1A_PRIME        0x100000001b3ULL
+#define STATS_LATENCY_BUCKETS   32 // Bucket i counts the calls that took [2^i, 2^(i+1)) nanoseconds
+
+#define TRACE_BUFFER_EVENTS     4096 // Events per trace buffer, a thread with a full buffer gets an extra buffer
+#define TRACE_DETAIL_LENGTH     48
+
+// Scoped trace events: when --trace isn't used, the cost is one test of a global bool
+#define TRACE_BEGIN(name, detail) do { if (trace_enabled) TraceAddEvent((name), 'B', (detail)); } while (0)
+#define TRACE_END(name)           do { if (trace_enabled) TraceAddEvent((name), 'E', NULL); } while (0)
+
+#define SNAPSHOT_MAX_READERS         64        // Threads that can read the published inventory at the same time
+#define SNAPSHOT_PUBLISH_INTERVAL_NS 10000000  // The loader publishes at most every 10 ms, a command publishes right away
+#define SNAPSHOT_STRESS_RUN_NS       1000000000 // --snapshot-stress: every reader count runs for 1 second
+#define SNAPSHOT_STRESS_MAX_WEIGHT   1000000.0f // Integer weights stay exact in a float below 2^24: the rows of a snapshot add up exactly
+#define SNAPSHOT_STRESS_MONEY_CP     10000000000LL
+
+#define ITEM_COMPACT_MIN_TOMBSTONES 64 // Removed stacks that wait in the list before a compaction, unless there are more tombstones than stacks
+#define ITEM_HANDLE_NULL ((ItemHandle){ 0, 0 })
+
+#define SEARCH_MAX_SUGGESTIONS 8
+#define SEARCH_MAX_DISTANCE    2  // Max amount of typos (edit distance) allowed in a fuzzy suggestion
+
+#define TERMINAL_DEFAULT_ROWS    24
+#define TERMINAL_DEFAULT_COLUMNS 80
+#define TERMINAL_MAX_ROWS        200
+#define TERMINAL_MAX_COLUMNS     512
+#define TERMINAL_RUN_GAP         8   // Unchanged cells between two changed cells that are written again instead of moving the cursor
+#define ITEM_VIEW_STATUS_LENGTH  120
+#ifdef _WIN32
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING // Missing in older MinGW headers
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#endif
+
+#define QUERY_MAX_CONDITIONS   8
+#define QUERY_TOKEN_LENGTH     50
+#define QUERY_BLOCK_ROWS       1024 // Rows per scan block: the match flags of a block stay in the L1 cache
+#define QUERY_TOP_K_MAX        64   // A limit up to this keeps the best rows sorted while scanning, a bigger one sorts every match
+
+#define QUERY_FIELD_NONE       0
+#define QUERY_FIELD_WEIGHT     1
+#define QUERY_FIELD_COST       2
+#define QUERY_FIELD_QUANTITY   3
+#define QUERY_FIELD_CATEGORY   4
+
+#define VALUATION_PERCENT_MIN  -100 // A markup of -100% makes the items free
+#define VALUATION_PERCENT_MAX  1000
+#define MONEY_MAX_CP           ((int64_t)INT32_MAX * 10000 + 9999) // The most copper a Money holds: its gold is an int
+
+#define QUERY_OP_NONE          0
+#define QUERY_OP_EQUAL         1
+#define QUERY_OP_NOT_EQUAL     2
+#define QUERY_OP_LESS          3
+#define QUERY_OP_LESS_EQUAL    4
+#define QUERY_OP_GREATER       5
+#define QUERY_OP_GREATER_EQUAL 6
+
+// One loop per operator over a block of one column, the query filters are built from it
+#define QUERY_FILTER_LOOPS(column, row_count, op, value, matches) \
+	switch (op) \
+	{ \
+	case QUERY_OP_EQUAL:         for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] == (value)); break; \
+	case QUERY_OP_NOT_EQUAL:     for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] != (value)); break; \
+	case QUERY_OP_LESS:          for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] < (value)); break; \
+	case QUERY_OP_LESS_EQUAL:    for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] <= (value)); break; \
+	case QUERY_OP_GREATER:       for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] > (value)); break; \
+	case QUERY_OP_GREATER_EQUAL: for (uint32_t row = 0; row < (row_count); ++row) (matches)[row] &= ((column)[row] >= (value)); break; \
+	}
+
+// Arguments for a "%.*s" printf conversion of a string field of an item: the fields aren't '\0' terminated
+#define ITEM_STRING_ARGS(item, field) (int)(item)->field.length, (item)->source + (item)->field.offset
+
+
+typedef struct Money 
+{
+	int gp;
+	int sp;
+	int cp;
+} Money;
+
+typedef struct StringView   // A string inside the json text of an item, nothing is copied out of the json text
+{
+	uint32_t offset;         // Byte offset from the start of the json text
+	uint32_t length;         // 0 = the key wasn't found
+} StringView;
+
+typedef struct JsonLevel    // An object or array that JsonParseString is in
+{
+	uint8_t key;             // JSON_KEY_... of the key this object or array is the value of
+	bool is_array;
+} JsonLevel;
+
+typedef struct FileMapping FileMapping;
+struct FileMapping           // A json file that is mapped read only until the program exits (--mmap)
+{
+	char file_name[100];
+	char* data;
+	long length;
+	FileMapping* next;
+};
+
+FileMapping* file_mappings = NULL;  // Every file that is mapped, a file is only mapped once
+bool json_mmap_enabled = false;
+
+typedef struct ItemHandle     // Generational handle of a stack: safe to keep, ItemHandleGet returns NULL once the stack is removed
+{
+	uint32_t slot;
+	uint32_t generation;      // 0 = no item
+} ItemHandle;
+
+typedef struct Node Item;
+struct Node
+{
+	StringView index;
+	char file_name[100];     // json file path
+	StringView name;
+	Money money;
+	float weight;
+	char* source;            // The json text of the item: the mapped file with --mmap, else one copy of the file owned by the item
+	long source_length;
+	FileMapping* mapping;    // NULL when the item owns its source
+	long details_offset;     // Byte offset in the json text where the details parse can start
+	bool is_source_cached;   // The item comes from the parse cache: the source only holds the index and the name, not the json text
+	bool is_details_loaded;  // The details are only decoded when the user asks for them (D in the item viewer)
+	StringView url;
+	StringView equipment_category;
+	uint32_t quantity;       // Copies of this item in the inventory: every copy of the same index shares this node
+	ItemHandle handle;
+	bool is_removed;         // Tombstone: the last copy is popped, the node stays linked until InventoryCompact frees it
+	Item* prev;
+	Item* next;
+};
+typedef struct Node ItemList; // Used to have a more explaining typename for the variable that holds the node list
+
+typedef struct ItemSlot       // Entry of the handle table of the inventory
+{
+	Item* item;               // NULL when the slot is free
+	uint32_t generation;      // Increased when the slot is freed: the handles of the old stack don't match anymore
+	uint32_t next_free;       // Next free slot, UINT32_MAX at the end of the free slot list
+} ItemSlot;
+
+typedef struct ItemRequest    // A json file from the command line and the amount of copies to push
+{
+	uint32_t path_offset;     // '\0' terminated path in the path buffer of the request list
+	uint32_t amount;
+} ItemRequest;
+
+typedef struct ItemRequestList // Grows with the arguments, a loadout isn't limited to a fixed amount of json files
+{
+	ItemRequest* requests;
+	uint32_t count;
+	uint32_t capacity;
+	char* paths;
+	uint32_t paths_length;
+	uint32_t paths_capacity;
+	uint32_t* slots;          // Hash table of request number + 1, 0 = empty: the same json file twice adds to the amount of one request
+	uint32_t slot_count;      // Power of 2, at most half full
+} ItemRequestList;
+
+#ifdef _WIN32 // Windows system
+typedef CRITICAL_SECTION InventoryMutex;
+typedef HANDLE LoaderThread;
+#else // Linux system
+typedef pthread_mutex_t InventoryMutex;
+typedef pthread_t LoaderThread;
+#endif
+
+typedef struct SnapshotRow    // A stack of the list when the snapshot was published. The strings are in the string pool of the snapshot
+{
+	uint32_t index_offset;
+	uint32_t name_offset;
+	uint16_t index_length;
+	uint16_t name_length;
+	float weight;
+	Money money;
+	uint32_t quantity;
+} SnapshotRow;
+
+typedef struct InventorySnapshot // Immutable once published: readers use it without the inventory lock
+{
+	uint64_t version;         // Inventory version it was built from
+	size_t size;              // Bytes of the allocation
+	float max_weight;
+	Money money;
+	uint32_t item_count;
+	uint32_t stack_count;
+	uint32_t files_loaded;
+	uint32_t files_to_load;
+	char* string_pool;        // Behind the rows, in the same allocation
+	SnapshotRow rows[];       // stack_count rows in list order
+} InventorySnapshot;
+
+typedef struct RetiredSnapshot
+{
+	InventorySnapshot* snapshot;
+	uint64_t epoch;           // Global epoch when it was replaced: readers that started in a later epoch can't see it
+} RetiredSnapshot;
+
+typedef struct SnapshotReclaimer // Epoch based reclamation of the replaced snapshots
+{
+	_Atomic uint64_t epoch;                              // Starts at 1, increased by every retire
+	_Atomic uint64_t reader_epochs[SNAPSHOT_MAX_READERS]; // Epoch when the reader took its snapshot, 0 = not reading
+	atomic_bool is_reader_used[SNAPSHOT_MAX_READERS];
+	RetiredSnapshot* retired;                            // Only used by the writer, with the inventory lock held
+	uint32_t retired_count;
+	uint32_t retired_capacity;
+} SnapshotReclaimer;
+
+typedef struct ChangeRecord   // One change of the inventory. The strings are in the string buffer of the change log
+{
+	uint64_t version;         // Inventory version after the change: the rows of one V command share their version
+	uint8_t kind;             // CHANGE_...
+	uint32_t amount;          // Copies pushed or popped
+	int64_t cp;               // PUSH and PRICE: price of one copy, MONEY: the money
+	float weight;             // PUSH: weight of one copy, MONEY: the carrying capacity
+	uint32_t index_offset;    // The index, the name and the file name one after another
+	uint16_t index_length;    // 0 for MONEY
+	uint16_t name_length;     // Only PUSH has a name and a file name
+	uint16_t file_name_length;
+} ChangeRecord;
+
+typedef struct ChangeLog      // Versioned change set: every push, pop, price and money change since start_version
+{
+	bool is_enabled;          // --save: the changes are only kept for a save file
+	uint64_t lineage;         // Random id of the camp: the records of two save files only line up when they come from the same camp
+	uint64_t start_version;   // The records cover (start_version, version of the inventory]
+	ChangeRecord* records;
+	uint32_t count;
+	uint32_t capacity;
+	char* strings;
+	uint32_t strings_length;
+	uint32_t strings_capacity;
+} ChangeLog;
+
+typedef struct Inventory
+{
+	float max_weight;
+	Money money;
+	uint32_t item_count;     // All copies of all items
+	uint32_t stack_count;    // Different items = nodes in the list that aren't removed
+	uint32_t removed_count;  // Tombstones in the list, freed together by the next compaction
+	uint64_t version;        // Increased by every push and pop that changes the list
+	ItemList* items;
+	ItemSlot* slots;         // Handle table: one slot per stack in the list, tombstones included
+	uint32_t slot_count;
+	uint32_t slot_capacity;
+	uint32_t free_slot;      // First free slot, only valid when free_slot_count > 0
+	uint32_t free_slot_count;
+	uint32_t* index_slots;   // Hash table of handle slot + 1 by item index, 0 = empty: a push finds the stack of its index without a walk over the list
+	uint32_t index_slot_count; // Power of 2, at most half full. A tombstone keeps its entry until InventoryCompact
+	ItemRequestList item_requests; // The json files to push after all the arguments are parsed
+	ChangeLog changes;        // --save: the changes since the save file was written first
+	uint32_t files_loaded;    // Progress of the item loader, published with the items
+	uint32_t files_to_load;
+	char log_file_name[26];   // Min buffer length: 6, Max buffer length: 100 => Parser only handles up to 99 chars + '\0'!
+	InventoryMutex lock;      // Held by the writers: the background loader while it parses and pushes a file, a command while it changes the items
+	_Atomic(InventorySnapshot*) snapshot; // Latest published state for the readers (A, L, M and W commands, --snapshot-stress threads)
+	uint64_t published_ns;
+	SnapshotReclaimer reclaimer;
+} Inventory;
+
+typedef struct ItemLoader     // Parses and pushes the json files from the command line, on a background thread with --progressive
+{
+	Inventory* inventory;
+	uint32_t file_count;
+	bool is_stop_requested;   // The fields below are only read and written with the inventory lock held
+	bool is_quiet;
+	bool is_started;          // Running on its own thread
+	LoaderThread thread;
+} ItemLoader;
+
+bool progressive_load_enabled = false;
+
+typedef struct SnapshotStressReader // One reader thread of --snapshot-stress
+{
+	Inventory* inventory;
+	int reader;               // Snapshot reader slot, registered before the thread starts
+	atomic_bool* is_stopped;
+	uint64_t reads;           // The counters are only read after the thread is joined
+	uint64_t rows_read;
+	uint64_t torn_reads;      // Snapshots whose rows don't add up to the totals of the snapshot
+	LoaderThread thread;
+} SnapshotStressReader;
+
+uint32_t snapshot_stress_readers = 0; // --snapshot-stress readers stacks: the snapshot tool
+uint32_t snapshot_stress_stacks = 0;
+
+typedef struct SaveRow        // A stack of a save file. The strings are in the string buffer of the save state
+{
+	uint32_t index_offset;    // The index, the name and the file name one after another
+	uint16_t index_length;
+	uint16_t name_length;
+	uint16_t file_name_length;
+	float weight;
+	int64_t cost;             // In copper
+	uint32_t quantity;        // 0 = popped by a delta, not written to the save file
+} SaveRow;
+
+typedef struct SaveState      // The stacks and the totals of a save file, no Item is made: --delta-emit and --delta-apply work on these
+{
+	uint64_t version;
+	float max_weight;
+	int64_t money;            // In copper
+	SaveRow* rows;
+	uint32_t row_count;
+	uint32_t row_capacity;
+	char* strings;
+	uint32_t strings_length;
+	uint32_t strings_capacity;
+	uint32_t* slots;          // Hash table of row number + 1 by index, 0 = empty
+	uint32_t slot_count;      // Power of 2, at most half full
+} SaveState;
+
+typedef struct SyncBuffer     // Encoded save file or delta. Reads never go past length: a short or corrupted file sets is_failed
+{
+	char* data;
+	uint32_t length;
+	uint32_t capacity;
+	uint32_t position;
+	bool is_failed;
+} SyncBuffer;
+
+char save_file_name[FILE_PATH_BUFFER_MAX + 1] = { 0 };           // --save: the camp is restored from the file and written to it when the program quits
+char delta_paths[3][FILE_PATH_BUFFER_MAX + 1] = { { 0 } };       // --delta-emit old new delta, --delta-apply base delta result: the sync tools
+bool is_delta_apply = false;
+
+typedef struct ExportWriter   // Buffered output of an export: no allocation per item, one write per full buffer
+{
+	FILE* file;
+	uint64_t bytes_written;
+	uint32_t length;          // Bytes waiting in the buffer
+	bool is_failed;           // A write failed: the rest of the export is skipped
+	char buffer[EXPORT_BUFFER_SIZE];
+} ExportWriter;
+
+char export_file_name[FILE_PATH_BUFFER_MAX + 1] = { 0 }; // --export: write the loaded inventory to the file and quit
+
+typedef struct ForkEntry      // The change of one item index in a fork
+{
+	char* index;              // '\0' terminated copy
+	Item* item;               // Parsed json file of a push, pushed to the base on commit. NULL when the fork only popped copies of a stack of the base
+	float weight;
+	Money money;
+	uint32_t base_quantity;   // Copies in the base when the entry was made
+	int64_t quantity_delta;
+} ForkEntry;
+
+typedef struct InventoryFork  // What-if copy of an inventory: the totals are copied, the item list is shared and the changes are kept in the entries
+{
+	Inventory* base;
+	uint64_t base_version;    // A commit after the base changed still works: ItemPush and ItemPop check the current weight and money again
+	float max_weight;
+	Money money;
+	uint32_t base_item_count;
+	uint32_t base_stack_count;
+	ForkEntry* entries;       // One per changed index, a plan only touches a few items
+	uint32_t entry_count;
+	uint32_t entry_capacity;
+} InventoryFork;
+
+typedef struct SharedInventoryHeader // Start of the shared memory segment. Only offsets from the start of the segment, no pointers: every process maps it at another address
+{
+	char magic[4];
+	uint32_t layout_version;
+	_Atomic uint32_t sequence;   // Seqlock: odd while the writer changes the segment, a reader retries when it changed during its read
+	uint32_t segment_size;
+	uint32_t writer_process_id;
+	uint32_t row_offset;         // SnapshotRow array, the string offsets of a row are from the start of the string pool
+	uint32_t row_count;
+	uint32_t string_pool_offset;
+	uint32_t string_pool_length;
+	uint32_t item_count;
+	uint32_t stack_count;        // Can be more than row_count when is_truncated is set
+	uint32_t files_loaded;
+	uint32_t files_to_load;
+	float max_weight;
+	Money money;
+	uint8_t is_truncated;
+	uint64_t inventory_version;
+	uint64_t publish_count;
+} SharedInventoryHeader;
+
+typedef struct SharedSegment  // Named shared memory: written by the inventory with --shm, mapped read only by --shm-view
+{
+	char name[SHARED_NAME_LENGTH];
+	SharedInventoryHeader* header;
+	size_t size;
+	bool is_writer;
+#ifdef _WIN32 // Windows system
+	HANDLE mapping;
+#endif
+} SharedSegment;
+
+SharedSegment shared_segment = { 0 };      // --shm
+char shared_view_name[SHARED_NAME_LENGTH] = { 0 }; // --shm-view: print the inventory of another process and quit
+
+typedef struct ParseCacheEntry // The eager parse result of one json file
+{
+	char file_name[100];
+	int64_t file_size;
+	int64_t file_mtime;          // Nanoseconds
+	uint64_t content_hash;       // FNV-1a of the whole file: a file with a new mtime but the same content isn't parsed again
+	float weight;
+	Money money;
+	int64_t details_offset;
+	StringView index;            // Views into the json file
+	StringView name;
+	char* strings;               // The index followed by the name
+} ParseCacheEntry;
+
+typedef struct ParseCache
+{
+	ParseCacheEntry* entries;
+	uint32_t entry_count;
+	uint32_t entry_capacity;
+	uint32_t* slots;             // Hash table of entry number + 1 by file path, 0 = empty: a lookup doesn't compare every cached path
+	uint32_t slot_count;         // Power of 2, at most half full
+	bool is_dirty;               // Changed since it was loaded: written back when the program quits
+} ParseCache;
+
+typedef struct ParseCacheHeader // Start of the cache file, followed by payload_size bytes of entries
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t payload_size;
+	uint64_t payload_hash;       // FNV-1a of the payload: any corruption makes the whole cache unused
+} ParseCacheHeader;
+
+ParseCache parse_cache = { 0 };  // Only used with the inventory lock held once the items are loading
+char parse_cache_file_name[FILE_PATH_BUFFER_MAX + 1] = { 0 };
+
+typedef struct PackHeader    // Start of the pack file, followed by the stored json files. The tables are at the end
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t string_pool_size;
+	uint64_t table_offset;       // The entry table, then the file name order, then the string pool until the end of the file
+	uint64_t table_hash;         // FNV-1a of everything from table_offset to the end of the file
+} PackHeader;
+
+typedef struct PackEntry     // One json file in the pack. The entry table is sorted by item index
+{
+	uint64_t data_offset;        // Byte offset of the stored json file in the pack
+	uint32_t stored_length;
+	uint32_t length;             // Length of the json text, the same as stored_length when it isn't compressed
+	uint32_t index_offset;       // Offsets in the string pool, every string ends with a '\0'
+	uint32_t name_offset;
+	uint32_t file_name_offset;
+	uint16_t index_length;
+	uint16_t name_length;
+	uint16_t file_name_length;
+	uint16_t flags;              // PACK_ENTRY_...
+	uint32_t reserved;           // No padding: the entries are written and read as they are in memory
+} PackEntry;
+
+typedef struct ItemPack      // The pack of --pack: opened once, the json files are read from it with random access
+{
+	char file_name[FILE_PATH_BUFFER_MAX + 1];
+	FILE* file;                  // Stays open, PackLoadSource seeks in it: only used with the inventory lock held
+	FileMapping* mapping;        // Only with --mmap: the uncompressed json files are used in place
+	PackHeader header;
+	PackEntry* entries;          // One allocation holds the entries, the file name order and the string pool
+	uint32_t* file_name_order;   // Entry numbers sorted by file name
+	char* string_pool;
+	bool is_open;
+} ItemPack;
+
+typedef struct PackFileList  // The json files of the item folder that PackBuild packs, also the sorted folder list of the glob arguments
+{
+	char (*file_names)[100];
+	uint32_t count;
+	uint32_t capacity;
+} PackFileList;
+
+PackFileList item_folder_files = { 0 }; // Sorted, only read for the first response file or glob argument: one directory scan instead of two _access calls per item
+bool is_item_folder_listed = false;
+
+ItemPack item_pack = { 0 };
+char pack_build_file_name[FILE_PATH_BUFFER_MAX + 1] = { 0 }; // --pack-build: write a pack of the item folder and quit
+bool pack_compress_enabled = false;                            // --pack-compress: PackBuild compresses every entry that gets smaller
+PackEntry* pack_sort_entries = NULL;                           // qsort has no context argument: PackCompareIndex and PackCompareFileName read these
+const char* pack_sort_pool = NULL;
+
+typedef struct LatencyHistogram
+{
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t buckets[STATS_LATENCY_BUCKETS];
+} LatencyHistogram;
+
+typedef struct RuntimeStats // Cheap counters that are always on: an increment per event and a clock read per timed call
+{
+	// JsonParse
+	uint64_t json_files_parsed;
+	uint64_t json_bytes_parsed;
+	LatencyHistogram json_parse_latency;
+	// PARSE CACHE
+	uint64_t parse_cache_hits;         // The file didn't change: no read and no parse
+	uint64_t parse_cache_content_hits; // New mtime, same content: read and hashed, but not parsed
+	uint64_t parse_cache_misses;
+	// ITEM PACK
+	uint64_t pack_entries_read;
+	uint64_t pack_bytes_decompressed;
+	// ItemCreate / ItemFree
+	uint64_t items_created;
+	uint64_t items_freed;
+	uint64_t items_live;
+	uint64_t item_bytes_live;  // Item nodes + json text owned by the items
+	uint64_t item_bytes_peak;
+	// ItemPush / ItemPop
+	uint64_t items_pushed;
+	uint64_t push_rejects_weight;
+	uint64_t push_rejects_money;
+	LatencyHistogram push_latency;
+	uint64_t items_popped;
+	uint64_t pop_rejects_empty;
+	uint64_t pop_rejects_not_found;
+	LatencyHistogram pop_latency;
+	// TOMBSTONES / InventoryCompact
+	uint64_t stacks_removed;
+	uint64_t compactions;
+	uint64_t tombstones_freed;
+	uint64_t stale_handles;    // ItemHandleGet calls with a handle of a removed stack
+	// INVENTORY SNAPSHOTS
+	uint64_t snapshots_published;
+	uint64_t snapshots_reclaimed;
+	uint64_t snapshot_bytes_live;
+	// FILE CALLS (stdio calls, the C library can combine or split the real system calls)
+	uint64_t file_opens;
+	uint64_t file_open_failures;
+	uint64_t file_reads;
+	uint64_t file_bytes_read;
+	uint64_t file_writes;
+	uint64_t file_bytes_written;
+	uint64_t file_seeks;        // fseek + ftell
+	uint64_t file_closes;
+	uint64_t file_access_checks;
+	uint64_t directory_reads;
+	uint64_t file_maps;
+	uint64_t file_bytes_mapped;
+	LatencyHistogram file_read_latency;
+} RuntimeStats;
+
+RuntimeStats runtime_stats = { 0 };
+
+typedef struct TraceEvent
+{
+	const char* name;                  // Always a string literal
+	char phase;                        // 'B' = begin, 'E' = end
+	uint64_t time_ns;
+	char detail[TRACE_DETAIL_LENGTH];  // Copied: file paths and item indexes don't have to outlive the event
+} TraceEvent;
+
+typedef struct TraceBuffer TraceBuffer;
+struct TraceBuffer                     // Only written by its own thread, so adding an event needs no lock
+{
+	uint32_t thread_id;
+	uint32_t event_count;
+	TraceEvent events[TRACE_BUFFER_EVENTS];
+	TraceBuffer* next;                 // Next buffer in the list of all buffers of all threads
+};
+
+bool trace_enabled = false;
+char trace_file_name[FILE_PATH_BUFFER_MAX + 1] = { 0 };
+uint64_t trace_start_ns = 0;
+TraceBuffer* _Atomic trace_buffers = NULL;     // Every buffer ever created, newest first
+atomic_uint trace_thread_count = 0;
+_Thread_local TraceBuffer* trace_thread_buffer = NULL;
+_Thread_local uint32_t trace_thread_id = 0;   // 0 = this thread didn't record an event yet
+
+typedef struct SearchEntry // One json file in the item folder
+{
+	char file_name[50];      // Example: greatsword.json
+	char index[50];
+	char name[50];
+} SearchEntry;
+
+typedef struct SearchNode SearchNode;
+struct SearchNode            // Prefix tree node: first child / next sibling. Keys are stored in lower case
+{
+	char c;
+	int32_t entry;           // Entry of the key that ends in this node, -1 if no key ends here
+	SearchNode* child;
+	SearchNode* sibling;
+};
+
+typedef struct SearchIndex   // Prefix tree over the index, display name and file name of every json file in the item folder
+{
+	SearchNode* root;
+	SearchEntry* entries;
+	int32_t entry_count;
+	int32_t entry_capacity;
+} SearchIndex;
+
+typedef struct SearchResult
+{
+	int32_t entry;
+	uint8_t distance;        // 0 for exact and prefix matches, amount of typos for fuzzy matches
+	uint8_t key_length;      // Shorter keys are ranked first when the distance is equal
+} SearchResult;
+
+typedef struct QueryCondition
+{
+	uint8_t field;               // QUERY_FIELD_...
+	uint8_t op;                  // QUERY_OP_...
+	float weight;
+	int64_t number;              // Cost in copper or quantity
+	char category[QUERY_TOKEN_LENGTH];
+} QueryCondition;
+
+typedef struct QueryPlan      // A compiled query: conditions that are all true, the sort column and the amount of rows
+{
+	QueryCondition conditions[QUERY_MAX_CONDITIONS];
+	uint8_t condition_count;
+	uint8_t order_field;         // QUERY_FIELD_NONE: the order of the list
+	bool is_descending;
+	uint32_t limit;              // 0 = every matching row
+	bool needs_categories;
+} QueryPlan;
+
+typedef struct QueryColumns   // The items of the list as packed columns, one row per item. Rebuilt when the inventory changed
+{
+	uint32_t row_count;
+	uint32_t row_capacity;
+	uint64_t inventory_version;
+	bool is_valid;
+	bool has_categories;         // The category column is filled: the details of every item are decoded
+	Item** items;
+	float* weights;
+	int64_t* costs;              // In copper
+	uint32_t* quantities;
+	uint16_t* categories;        // Number of the category name, 0 = no category
+	char (*category_names)[50];
+	uint16_t category_count;
+	uint16_t category_capacity;
+} QueryColumns;
+
+typedef struct ValuationPlan  // A compiled V command: the total value of the matching items, or a markup of their price first
+{
+	QueryPlan query;             // Only the conditions are used
+	bool is_repricing;
+	int32_t basis_points;        // The markup in 1/100 percent: -1050 = -10.5%
+} ValuationPlan;
+
+QueryPlan* query_sort_plan = NULL;       // qsort has no context argument: QuerySortCompare reads these
+QueryColumns* query_sort_columns = NULL;
+
+typedef struct Terminal       // Raw key input and a diff renderer for the item viewer, only used when stdin and stdout are a terminal
+{
+	bool is_raw;                 // Keys are read without waiting for enter and without echo
+	bool is_front_valid;         // false: the screen content is unknown (other output, a new size), the next flush draws every cell
+	int rows;
+	int columns;
+	char* front;                 // The cells the terminal shows
+	char* back;                  // The cells of the next frame
+	char* output;                // The escape sequences and cells of one frame, written at once
+	uint32_t output_length;
+	uint32_t output_capacity;
+#ifdef _WIN32 // Windows system
+	HANDLE output_handle;
+#else // Linux system
+	struct termios original_settings;
+	struct termios raw_settings;
+#endif
+} Terminal;
+
+Terminal terminal = { 0 };
+
+// TERMINAL UI (C COMMAND, ITEM VIEWER)
+void ClearScreen(void);                                          // ANSI escape sequences, no shell is started
+void TerminalInit(Terminal* terminal);                           // Raw key input when stdin and stdout are a terminal, else nothing changes
+void TerminalRestore(Terminal* terminal);
+void TerminalRestoreOnExit(void);                                // atexit() handler, also covers the exit(n) paths
+#ifndef _WIN32 // Linux system
+void TerminalRestoreOnSignal(int signal_number);                 // Ctrl+C doesn't leave the shell without echo
+#endif
+int TerminalReadKey(Terminal* terminal);                         // One key, whitespace is skipped like scanf(" %c"). The arrow keys give 'n' and 'p'. '\0' at the end of the input
+void TerminalReadLine(Terminal* terminal, char* buffer, int buffer_size); // A line with echo and line editing, leading whitespace is skipped
+void TerminalResize(Terminal* terminal);                         // Follows the window size, a new size redraws every cell
+void TerminalSetSize(Terminal* terminal, int rows, int columns);
+void TerminalBeginFrame(Terminal* terminal);                     // Empties the back buffer
+void TerminalPrint(Terminal* terminal, int row, const char* format, ...); // printf into a row of the back buffer, cut off at the screen width
+void TerminalFlush(Terminal* terminal);                          // Only writes the cells that differ from what the terminal shows
+
+// MAIN ARGUMENT PARSING
+void PrintProgramArgs(int argc, char* argv[]);
+void ParseProgramArgs(int argc, char* argv[], Inventory* inventory);
+
+// NUMBER PARSING AND FORMATTING (NO LOCALE: '.' IS THE ONLY DECIMAL POINT)
+const char* NumberParseInteger(const char* text, const char* text_end, int64_t* value); // [-]digits. NULL if there is no digit or it doesn't fit in 64 bits, else the char after the number. text_end NULL: the text is '\0' terminated
+const char* NumberParseDecimal(const char* text, const char* text_end, double* value);  // [-]digits[.digits][e[+-]digits] in one pass. NULL if it isn't a number, else the char after the number
+bool NumberParseWeight(const char* text, float* weight);               // The whole string has to be a finite number of 0 or more. Example: 180.75
+bool NumberParseMoney(const char* text, const char* unit, int* amount); // The whole string has to be digits followed by the unit. Example: 42sp
+int NumberFormatWeight(float weight, char* buffer, size_t buffer_size); // The shortest text that NumberParseDecimal reads back as the same float
+
+// ITEM ARGUMENTS (@RESPONSE FILES, GLOB PATTERNS)
+void ItemRequestAdd(ItemRequestList* list, char* file_path, uint32_t amount); // Adds the amount to the request of the file when it is already in the list
+bool ItemArgumentAdd(Inventory* inventory, char* argument, uint32_t amount, bool is_quiet); // A json file name or a glob pattern, "Items_JSON/" in front is allowed. false if it is ignored
+void ItemResponseFileRead(Inventory* inventory, char* file_path); // Streams the item arguments of the file, an amount follows its item like on the command line
+bool ItemAmountParse(const char* token, uint32_t* amount);         // false if the token isn't a positive integer that fits in 32 bits
+bool GlobMatch(const char* pattern, const char* name);             // '*' matches any amount of chars, '?' one char
+void ItemFolderListLoad(void);                                     // Reads the sorted item folder list once
+bool ItemFolderContains(char* file_name);
+int ItemFolderCompareFileName(const void* file_name_a, const void* file_name_b);
+
+// JSON FILE PARSING
+Item* JsonParse(char* file_path, uint8_t parse_flags);                  // Eager pass only, JSON_PARSE_QUIET also silences the progress messages
+char* JsonLoadFile(char* file_path, long* file_length);                  // Returns a '\0' terminated copy of the whole file that the caller has to free, NULL if the file can't be opened
+void JsonParseString(char* json_string, long json_start, long json_end, Item* item, uint8_t parse_flags); // Parses [json_start, json_end), the string views of the item are offsets from json_string. JSON_PARSE_EAGER, JSON_PARSE_DETAILS, optionally combined with JSON_PARSE_QUIET
+uint8_t JsonClassifyKey(const char* key, uint32_t key_length);          // JSON_KEY_... of a key, JSON_KEY_UNKNOWN if it isn't an item field
+FileMapping* FileMappingOpen(char* file_path);                          // Maps the file the first time, afterwards the same mapping is returned. NULL if the file can't be mapped
+bool ItemLoadSource(Item* item, char* file_path);                       // Maps (--mmap) or reads the json file as the source of the item. false if the file can't be opened
+uint64_t HashFnv1a(const char* data, size_t length, uint64_t hash);     // Start with HASH_FNV1A_SEED, pass the result again to continue the hash
+void BufferAppend(char** buffer, uint32_t* length, uint32_t* capacity, const void* data, uint32_t size); // Grows the buffer when needed
+bool ItemFolderScan(void (*add_file)(void* context, char* file_name), void* context); // Calls add_file for every json file in the item folder, false if the folder can't be read
+
+// PARSE CACHE (Inventory_cache.bin)
+void ParseCacheInit(char* executable_path);                                // Loads the cache file next to the executable
+ParseCacheEntry* ParseCacheFind(char* file_path);                          // NULL if the file isn't cached
+ParseCacheEntry* ParseCacheAddEntry(char* file_path);                      // An empty entry with the file name, added to the path hash table
+bool ParseCacheFileStatus(char* file_path, int64_t* file_size, int64_t* file_mtime); // false if the file doesn't exist
+void ParseCacheStore(char* file_path, int64_t file_mtime, uint64_t content_hash, Item* item); // Adds or replaces the entry of the file with the eager parse result of the item
+Item* ParseCacheItemCreate(ParseCacheEntry* entry);
+bool ParseCacheRead(const char* payload, uint32_t payload_size, uint32_t* position, void* data, uint32_t size); // false instead of reading past the payload
+void ParseCacheLoad(char* cache_path);                                     // A corrupted cache is dropped as a whole
+void ParseCacheSave(char* cache_path);                                     // Only when an entry changed
+
+// ITEM PACK (--pack, --pack-build)
+bool PackBuild(char* pack_path, bool is_compressed);        // Packs every json file of the item folder, false if the pack can't be written
+void PackBuildAddFile(void* file_list, char* file_name);
+int PackCompareIndex(const void* entry_a, const void* entry_b);      // qsort of the entry table
+int PackCompareFileName(const void* number_a, const void* number_b); // qsort of the file name order
+bool PackOpen(ItemPack* pack, char* pack_path);             // Reads the tables, false if the pack can't be opened or is corrupted
+void PackClose(ItemPack* pack);
+bool PackCheckString(ItemPack* pack, uint32_t offset, uint16_t length); // The string lies in the string pool and ends with a '\0'
+PackEntry* PackFind(ItemPack* pack, char* file_path);       // By file name, else by item index: rations-1-day.json finds rations.json. NULL if the pack isn't open or doesn't hold the item
+bool PackLoadSource(ItemPack* pack, PackEntry* entry, Item* item); // Reads (or with --mmap points to) the json text of the entry as the source of the item. false if the entry can't be read
+uint32_t PackCompress(const char* input, uint32_t length, char* output, uint32_t capacity); // Returns the compressed length, 0 if it doesn't fit in capacity
+bool PackWriteLiterals(const char* literals, uint32_t literal_count, char* output, uint32_t* output_length, uint32_t capacity);
+bool PackDecompress(const char* input, uint32_t stored_length, char* output, uint32_t length); // false if the input is corrupted or doesn't give exactly length bytes
+
+// GAME ITEM LIST / INVENTORY
+ItemList* ItemListCreate(Item* new_item);
+Item* ItemCreate(/*char* index*/);
+void InventoryAppendStack(Inventory* inventory, Item* item);          // Links the item at the end of the list as a new stack and gives it a handle
+void ItemPush(Inventory* inventory, Item* new_item, uint32_t amount, bool is_quiet); // The inventory owns new_item afterwards: it is freed when it joins an existing stack or doesn't fit at all. Quiet only prints the copies that don't fit
+uint32_t ItemFitAmount(float max_weight, const Money* money, Item* item, uint32_t amount, bool* is_weight_limited); // Copies of the item that fit in the carrying capacity and the money that is left
+void ItemPop(Inventory* inventory, char* index, uint32_t amount);    // The stack becomes a tombstone when its last copy is popped, InventoryCompact frees it later
+uint32_t ItemPopHandle(Inventory* inventory, ItemHandle handle, uint32_t amount, bool is_quiet); // O(1), no search by index. Returns the copies that are popped, 0 for a stale handle
+uint32_t ItemPopStack(Inventory* inventory, Item* stack, uint32_t amount, bool is_quiet);       // Call with a stack that isn't removed. Returns the copies that are popped
+void ItemFree(Item** item);                           // Item** because the original pointer variable is set to NULL
+void ItemLoadDetails(Item* item, bool is_quiet);      // Decodes the details on first access, afterwards nothing is done
+char* ItemCopyString(Item* item, StringView string, char* buffer, size_t buffer_size); // '\0' terminated copy of a string field, cut off when the buffer is too small. Returns buffer
+bool ItemIndexEquals(Item* item, const char* index, uint32_t index_length);
+void ItemPrintBasicInfo(Item* item);
+void ItemPrintAdvancedInfo(Item* item);
+void ItemPrintList(InventorySnapshot* snapshot);
+void ItemPrintJsonPathList(Inventory* inventory);
+Item* InventoryFindItem(Inventory* inventory, const char* index, uint32_t index_length); // NULL if no item with this index is in the list
+void InventoryIndexInsert(Inventory* inventory, Item* item);          // Adds the stack to the index hash table, grows the table when it is half full
+void InventoryIndexRebuild(Inventory* inventory, uint32_t slot_count); // Refills the index hash table from the list: after a compaction the handle slots of the tombstones are gone
+Item* InventoryStep(Inventory* inventory, ItemHandle from, bool is_forward); // The next stack that isn't removed, also from a tombstone. A stale handle starts at the first or last stack
+void InventoryCompact(Inventory* inventory, bool is_forced);          // Frees the tombstones in one walk over the list. Not forced: only when ITEM_COMPACT_MIN_TOMBSTONES are waiting or more than the stacks
+void UserItemDrop(Inventory* inventory, char* pattern);               // Pops every copy of the stacks with a matching index. Example: rations*
+ItemHandle ItemHandleAssign(Inventory* inventory, Item* item);
+Item* ItemHandleGet(Inventory* inventory, ItemHandle handle);          // NULL when the stack is removed or the handle is ITEM_HANDLE_NULL
+uint32_t InventoryGetItemCount(Inventory* inventory);
+bool IsInventoryEmpty(Inventory* inventory);
+void InventoryLockInit(Inventory* inventory);
+void InventoryLock(Inventory* inventory);
+void InventoryUnlock(Inventory* inventory);
+
+// WHAT-IF FORKS (T COMMAND)
+void InventoryForkCreate(InventoryFork* fork, Inventory* base);              // O(1): only the totals are copied. Call with the inventory lock held
+uint32_t InventoryForkPush(InventoryFork* fork, Item* new_item, uint32_t amount); // Returns the copies that fit. The fork owns new_item afterwards
+uint32_t InventoryForkPop(InventoryFork* fork, const char* index, uint32_t amount); // Returns the copies that are popped, 0 if neither the fork nor the base has the index
+ForkEntry* InventoryForkFindEntry(InventoryFork* fork, const char* index, uint32_t index_length, bool is_added); // NULL if the fork didn't change the index and it isn't added
+uint32_t InventoryForkItemCount(InventoryFork* fork, uint32_t* stack_count);
+void InventoryForkCommit(InventoryFork* fork);                                // Call with the inventory lock held: the changes are pushed and popped on the base, then the fork is discarded
+void InventoryForkDiscard(InventoryFork* fork);
+void UserItemPlan(Inventory* inventory, char* plan_text);                     // Evaluates a plan on a fork and commits it when the user agrees
+bool PlanNextToken(const char** cursor, char* token, size_t token_size);      // Copies the next word of the plan, cut off when the buffer is too small. false at the end of the plan
+
+// INVENTORY SNAPSHOTS (LOCK FREE READERS)
+void InventorySnapshotInit(Inventory* inventory);                        // Publishes the empty inventory, readers never get NULL
+void InventoryPublish(Inventory* inventory, bool is_forced);             // Call with the inventory lock held after a change. Not forced: skipped when the last publish is less than SNAPSHOT_PUBLISH_INTERVAL_NS ago. Copies every row: O(stacks) per publish
+InventorySnapshot* InventorySnapshotBuild(Inventory* inventory);
+int InventoryReaderRegister(Inventory* inventory);                       // Reader slot of the calling thread, -1 if all slots are used
+void InventoryReaderUnregister(Inventory* inventory, int reader);
+InventorySnapshot* InventorySnapshotAcquire(Inventory* inventory, int reader); // Valid until the release, no lock is taken
+void InventorySnapshotRelease(Inventory* inventory, int reader);
+void InventoryReclaim(Inventory* inventory);                             // Frees the retired snapshots that no reader can see anymore
+bool SnapshotStress(uint32_t reader_count, uint32_t stack_count);        // Reader threads against a writer that pops, pushes and publishes, for 1, 2, 4 ... reader_count readers. false if a reader saw a torn snapshot
+Item* SnapshotStressItemCreate(uint32_t number);                         // A synthetic item without a json file: integer weight and price
+double SnapshotStressWeight(uint32_t stack_count);                       // Weight of the initial 2 copies of every stack, must fit in SNAPSHOT_STRESS_MAX_WEIGHT
+void SnapshotStressRead(SnapshotStressReader* reader);                   // Takes and checks snapshots until is_stopped
+#ifdef _WIN32 // Windows system
+DWORD WINAPI SnapshotStressReaderMain(LPVOID reader);
+#else // Linux system
+void* SnapshotStressReaderMain(void* reader);
+#endif
+
+void UserItemAdd(Inventory* inventory, char* file_path);
+void UserItemSearchAdd(Inventory* inventory, SearchIndex* search_index, char* query);
+
+// ITEM SEARCH INDEX (N COMMAND)
+void SearchIndexBuild(SearchIndex* search_index);                          // Scans the item folder once at startup
+void SearchIndexAddFile(void* search_index, char* file_name);
+void SearchIndexAddEntry(SearchIndex* search_index, char* file_name, const char* index, uint32_t index_length, const char* name, uint32_t name_length);
+void SearchIndexInsert(SearchIndex* search_index, char* key, int32_t entry);
+SearchNode* SearchNodeCreate(char c);
+uint8_t SearchIndexSuggest(SearchIndex* search_index, char* query, SearchResult* results, uint8_t max_results); // Returns the amount of ranked suggestions
+void SearchIndexWalk(SearchNode* node, char* query, int query_length, int* previous_row, uint8_t max_distance, uint8_t depth, SearchResult* results, uint8_t* result_count, uint8_t max_results);
+void SearchIndexCollect(SearchNode* node, uint8_t distance, uint8_t depth, SearchResult* results, uint8_t* result_count, uint8_t max_results);
+void SearchResultInsert(int32_t entry, uint8_t distance, uint8_t key_length, SearchResult* results, uint8_t* result_count, uint8_t max_results);
+
+// INVENTORY QUERIES (F COMMAND). Example: category=weapon and weight<5 order by cost desc limit 10
+bool QueryCompile(char* query_text, QueryPlan* plan);                  // false and an error message if the query isn't valid
+bool QueryNextToken(const char** cursor, char* token, size_t token_size); // Lower case token, false at the end of the query
+uint8_t QueryParseField(char* token);                                  // QUERY_FIELD_NONE if the token isn't a field
+uint8_t QueryParseOperator(char* token);                               // QUERY_OP_NONE if the token isn't an operator
+bool QueryParseValue(QueryCondition* condition, char* token);
+void QueryColumnsBuild(QueryColumns* columns, Inventory* inventory, bool with_categories); // Nothing is done when the inventory didn't change since the last build
+uint16_t QueryCategoryNumber(QueryColumns* columns, const char* category, uint32_t category_length, bool is_added); // 0 if the category isn't known and isn't added
+uint32_t QueryExecute(QueryPlan* plan, QueryColumns* columns, uint32_t* result_rows); // Returns the amount of result rows
+void QueryBindCategories(QueryPlan* plan, QueryColumns* columns, uint16_t* category_numbers); // QUERY_MAX_CONDITIONS numbers, 0 for the conditions that aren't about the category
+void QueryFilterBlock(QueryPlan* plan, QueryColumns* columns, const uint16_t* category_numbers, uint32_t block_start, uint32_t block_rows, uint8_t* matches); // matches[i] = 1 if row block_start + i fulfills every condition
+void QueryFilterFloat(const float* restrict column, uint32_t row_count, uint8_t op, float value, uint8_t* restrict matches);
+void QueryFilterInt64(const int64_t* restrict column, uint32_t row_count, uint8_t op, int64_t value, uint8_t* restrict matches);
+void QueryFilterUint32(const uint32_t* restrict column, uint32_t row_count, uint8_t op, uint32_t value, uint8_t* restrict matches);
+void QueryFilterUint16(const uint16_t* restrict column, uint32_t row_count, uint8_t op, uint16_t value, uint8_t* restrict matches);
+int QueryCompareRows(QueryPlan* plan, QueryColumns* columns, uint32_t row_a, uint32_t row_b); // Order of the rows in the result
+int QuerySortCompare(const void* row_a, const void* row_b);            // qsort, with query_sort_plan and query_sort_columns set
+void UserItemQuery(Inventory* inventory, QueryColumns* columns, char* query_text);
+
+// BULK VALUATION AND REPRICING (V COMMAND). Example: markup 15 category=weapon
+bool ValuationCompile(char* valuation_text, ValuationPlan* plan);      // total [conditions] or markup <percent> [conditions]. false and an error message if it isn't valid
+int64_t ValuationTotal(const int64_t* restrict costs, const uint32_t* restrict quantities, const uint8_t* restrict matches, uint32_t row_count); // Copper value of the matching rows
+int64_t ValuationTotalScalar(const int64_t* restrict costs, const uint32_t* restrict quantities, const uint8_t* restrict matches, uint32_t row_count);
+void ValuationScale(int64_t* restrict costs, const uint8_t* restrict matches, uint32_t row_count, int32_t basis_points); // cost * (10000 + basis_points) / 10000 of the matching rows, rounded half to even
+int64_t ValuationScaleCost(int64_t cost, int32_t basis_points);        // Exact integer math, prices of 0 or less don't change
+void ValuationPrintMoney(int64_t total_cp);                            // gp, sp and cp of a 64 bit copper amount
+void UserItemValuation(Inventory* inventory, QueryColumns* columns, char* valuation_text);
+
+// INVENTORY EXPORT (E COMMAND, --export)
+bool InventoryExport(Inventory* inventory, int reader, char* file_path);        // Streams the latest snapshot as JSON Lines or CSV (.csv file name). false if the file can't be written
+uint8_t ExportFormatFromFileName(char* file_path);                             // EXPORT_FORMAT_CSV for a .csv file, else EXPORT_FORMAT_JSON_LINES
+void ExportWrite(ExportWriter* writer, const void* data, uint32_t size);
+void ExportFlush(ExportWriter* writer);
+void ExportWriteUnsigned(ExportWriter* writer, uint64_t value);
+void ExportWriteSigned(ExportWriter* writer, int64_t value);
+void ExportWriteJsonString(ExportWriter* writer, const char* text, uint32_t length); // The text of a json string view: its escape sequences stay, other quotes, backslashes and control chars are escaped
+void ExportWriteCsvField(ExportWriter* writer, const char* text, uint32_t length);   // The escape sequences of the json string view are decoded, the field is quoted when needed
+void ExportWriteRow(ExportWriter* writer, uint8_t format, InventorySnapshot* snapshot, SnapshotRow* row);
+int32_t ExportHexValue(const char* hex);                                       // The value of 4 hex digits, -1 if one of them isn't a hex digit
+
+// SAVE FILES AND DELTA SYNC (--save, --delta-emit, --delta-apply)
+void InventoryRestore(Inventory* inventory, char* save_path);    // Continues the camp of the save file, a new camp when the file doesn't exist. Exits when the file is corrupted
+bool InventorySave(Inventory* inventory, char* save_path);       // The stacks, the totals and the newest CHANGE_LOG_MAX_RECORDS changes. false if the file can't be written
+void InventoryLogChange(Inventory* inventory, uint8_t kind, Item* item, uint32_t amount); // Call after the change, with the inventory lock held. Nothing is done without --save
+void ChangeLogAdd(ChangeLog* log, ChangeRecord* record, const char* index, const char* name, const char* file_name); // The lengths in the record tell how much of every string is copied
+void ChangeLogAddCopy(ChangeLog* log, ChangeRecord* record, const char* strings); // A record of another log: its strings lie one after the other at strings + index_offset
+uint32_t ChangeLogTrim(ChangeLog* log);                              // First record that is saved: the newest CHANGE_LOG_MAX_RECORDS, never half of a version
+void ChangeLogFree(ChangeLog* log);
+bool SaveStateLoad(char* save_path, SaveState* state, ChangeLog* log); // false and a message when the file can't be read or is corrupted
+bool SaveStateWrite(char* save_path, SaveState* state, ChangeLog* log, uint32_t first_record); // The records from first_record on are written
+SaveRow* SaveStateAddRow(SaveState* state, ChangeRecord* record, const char* index, const char* name, const char* file_name); // A row with the strings, weight and price of a push record and no copies yet
+SaveRow* SaveStateFind(SaveState* state, const char* index, uint32_t index_length); // NULL if no row has the index
+bool SaveStateApply(SaveState* state, ChangeRecord* record, const char* strings); // Same math as ItemPush and ItemPop. false if a pop or a price change has no stack to change
+uint64_t SaveStateHash(SaveState* state);                          // Doesn't depend on the order of the rows: two machines can list the same stacks in another order
+void SaveStateFree(SaveState* state);
+bool DeltaEmit(char* old_path, char* new_path, char* delta_path);  // The changes of the new save file since the version of the old one. false if a file can't be read or written
+void DeltaDiff(SaveState* old_state, SaveState* new_state, ChangeLog* delta); // Changes that turn the old stacks into the new ones, when the change log doesn't reach back far enough
+bool DeltaApply(char* base_path, char* delta_path, char* result_path); // false if a file can't be read or written, or the delta isn't made for this base
+void SyncWriteBytes(SyncBuffer* buffer, const void* data, uint32_t size);
+void SyncWriteVarint(SyncBuffer* buffer, uint64_t value);        // 7 bits per byte: small amounts and version steps take one byte
+void SyncWriteSigned(SyncBuffer* buffer, int64_t value);         // Zigzag varint
+void SyncWriteFloat(SyncBuffer* buffer, float value);            // The bits, little endian: the value is restored exactly
+void SyncWriteFixed64(SyncBuffer* buffer, uint64_t value);       // Little endian
+void SyncWriteString(SyncBuffer* buffer, const char* text, uint16_t length);
+void SyncWriteRecord(SyncBuffer* buffer, ChangeRecord* record, const char* strings, uint64_t* previous_version);
+bool SyncWriteFile(char* file_path, SyncBuffer* buffer);         // Appends the FNV-1a hash of the content. false if the file can't be written
+bool SyncReadBytes(SyncBuffer* buffer, void* data, uint32_t size); // false and is_failed instead of reading past the data
+uint64_t SyncReadVarint(SyncBuffer* buffer);
+int64_t SyncReadSigned(SyncBuffer* buffer);
+float SyncReadFloat(SyncBuffer* buffer);
+uint64_t SyncReadFixed64(SyncBuffer* buffer);
+const char* SyncReadString(SyncBuffer* buffer, uint16_t* length); // Points into the data, not '\0' terminated. NULL and is_failed when it doesn't fit
+void SyncReadRecord(SyncBuffer* buffer, ChangeLog* log, uint64_t* previous_version); // Adds the record to the log
+bool SyncLoadFile(char* file_path, SyncBuffer* buffer, const char* magic, uint8_t format_version); // Checks the magic, the format version and the hash. false and a message when the file can't be used
+
+// ITEM LOADING (--progressive)
+void ItemLoaderRun(ItemLoader* loader);            // Loads every file on the calling thread
+void ItemLoaderStart(ItemLoader* loader);          // Loads every file on a background thread
+void ItemLoaderStop(ItemLoader* loader);           // Stops the background thread after the file it is loading and waits for it
+void ItemLoaderPrintProgress(InventorySnapshot* snapshot); // The progress of the same snapshot as the items that are printed
+#ifdef _WIN32 // Windows system
+DWORD WINAPI ItemLoaderThreadMain(LPVOID loader);
+#else // Linux system
+void* ItemLoaderThreadMain(void* loader);
+#endif
+
+// GAME LOOP
+void PrintInventoryHelpMenu(void);
+void PrintItemHelpMenu(void);
+void ItemViewRender(Inventory* inventory, Item* item, bool show_details, char* status); // Draws the item viewer with the terminal, call with the inventory lock held
+void ItemViewMessage(char* status, const char* message);         // On the status line of the item viewer with a terminal, else printed
+
+// CHECK MONEY AMOUNT
+// SUBTRACT MONEY
+int64_t convert_to_cp(const Money* money); // 64 bit: A STACK OF EXPENSIVE ITEMS OVERFLOWS AN int
+Money convert_from_cp(int64_t total_cp);
+int subtract_money(const Money* available, const Money* cost, Money* remaining);
+void add_money(const Money* available, const Money* cost, Money* inventory_money);
+
+void WriteToLogFile(Inventory* inventory, char* log_file_path);
+
+// RUNTIME STATS (S COMMAND)
+uint64_t StatsTimeNs(void);                                                // Monotonic clock in nanoseconds
+void StatsRecordLatency(LatencyHistogram* histogram, uint64_t start_ns);  // Adds the time since start_ns to the histogram
+void StatsItemBytesAdd(uint64_t bytes);
+uint64_t StatsLatencyPercentile(LatencyHistogram* histogram, uint8_t percentile); // Upper bound of the bucket that holds the percentile
+void StatsPrintLatency(char* name, LatencyHistogram* histogram);
+void StatsPrint(void);
+void StatsWriteJson(char* file_path);
+void StatsWriteJsonLatency(FILE* file, char* name, LatencyHistogram* histogram);
+void StatsWriteOnExit(void);                                               // atexit() handler, also covers the exit(n) paths
+FILE* StatsFileOpen(char* file_path, char* mode);
+size_t StatsFileRead(void* buffer, size_t size, size_t count, FILE* file);
+size_t StatsFileWrite(const void* buffer, size_t size, size_t count, FILE* file);
+int StatsFileSeek(FILE* file, long offset, int origin);
+long StatsFileTell(FILE* file);
+int StatsFileClose(FILE* file);
+int StatsFileAccess(char* file_path, int mode);
+
+// CHROME TRACE PROFILER (--trace)
+void TraceStart(int argc, char* argv[]);                    // Looks for "--trace out.json" before the other arguments are parsed, so ParseProgramArgs is traced too
+void TraceAddEvent(const char* name, char phase, const char* detail);
+TraceBuffer* TraceBufferCreate(void);
+void TraceWriteJsonString(FILE* file, const char* string);
+void TraceWrite(char* file_path);                           // Chrome trace event format, open it in Perfetto or chrome://tracing
+void TraceWriteOnExit(void);
+
+// SHARED MEMORY SEGMENT (--shm, --shm-view)
+bool SharedSegmentName(char* segment_name, const char* name);         // Platform name of the segment, false if the name is too long
+bool SharedSegmentCreate(SharedSegment* segment);                     // The writer, segment->name is set. false if the segment can't be created
+bool SharedSegmentOpen(SharedSegment* segment);                       // Read only view, false if the segment doesn't exist or isn't an inventory
+void SharedSegmentClose(SharedSegment* segment);                      // The writer also removes the name
+void SharedSegmentCloseOnExit(void);                                  // atexit() handler, also covers the exit(n) paths
+void SharedSegmentWrite(SharedSegment* segment, InventorySnapshot* snapshot); // Call with the inventory lock held: one writer
+InventorySnapshot* SharedSegmentRead(SharedSegment* segment, uint32_t* stack_count); // Consistent copy of the shared inventory that the caller has to free, NULL if no read succeeded. stack_count: items of the inventory, the copy only has the rows that fit in the segment
+bool SharedSegmentView(char* name);                                   // Prints the shared inventory, false if it can't be read
+
+
+int main(int argc, char* argv[])
+{
+	// TO DO: SAVE THE CURRENT JSON PATH LIST TO THE CAMP FILE ON PROGRAM EXIST, THIS WAY THE USER CAN ENTER THE FILES WHERE HE LEFT THE INVENTORY THE LAST TIME
+
+	printf("\nDND Inventory app:\n\n");
+
+	atexit(StatsWriteOnExit);
+	TraceStart(argc, argv);
+	TerminalInit(&terminal);
+
+	// printf("Executable name: %s\n", argv[0]);
+
+	PrintProgramArgs(argc, argv); 
+
+	Inventory inventory = { 0 };
+	InventoryLockInit(&inventory);
+	InventorySnapshotInit(&inventory);
+	int snapshot_reader = InventoryReaderRegister(&inventory); // THE MAIN THREAD READS SNAPSHOTS WHILE THE LOADER PUSHES
+
+	TRACE_BEGIN("ParseProgramArgs", NULL);
+	ParseProgramArgs(argc, argv, &inventory); 
+	TRACE_END("ParseProgramArgs");
+
+	if (*pack_build_file_name != '\0') // PACK TOOL: ONLY THE PACK IS WRITTEN
+	{
+		TRACE_BEGIN("PackBuild", pack_build_file_name);
+		bool is_built = PackBuild(pack_build_file_name, pack_compress_enabled);
+		TRACE_END("PackBuild");
+		return (is_built) ? 0 : 3;
+	}
+
+	if (**delta_paths != '\0') // SYNC TOOLS: ONLY THE SAVE FILES AND THE DELTA ARE READ AND WRITTEN
+	{
+		TRACE_BEGIN((is_delta_apply) ? "DeltaApply" : "DeltaEmit", delta_paths[1]);
+		bool is_synced = (is_delta_apply) ? DeltaApply(delta_paths[0], delta_paths[1], delta_paths[2]) : DeltaEmit(delta_paths[0], delta_paths[1], delta_paths[2]);
+		TRACE_END((is_delta_apply) ? "DeltaApply" : "DeltaEmit");
+		return (is_synced) ? 0 : 3;
+	}
+
+	if (snapshot_stress_readers > 0) // SNAPSHOT TOOL: ONLY A SYNTHETIC INVENTORY, NO ITEM FILES ARE READ
+	{
+		TRACE_BEGIN("SnapshotStress", NULL);
+		bool is_consistent = SnapshotStress(snapshot_stress_readers, snapshot_stress_stacks);
+		TRACE_END("SnapshotStress");
+		return (is_consistent) ? 0 : 4;
+	}
+
+	if (*shared_view_name != '\0') // VIEWER: ONLY THE INVENTORY OF THE OTHER PROCESS IS PRINTED
+	{
+		TRACE_BEGIN("SharedSegmentView", shared_view_name);
+		bool is_viewed = SharedSegmentView(shared_view_name);
+		TRACE_END("SharedSegmentView");
+		return (is_viewed) ? 0 : 3;
+	}
+
+	if (*(shared_segment.name) != '\0' && SharedSegmentCreate(&shared_segment))
+	{
+		atexit(SharedSegmentCloseOnExit);
+		SharedSegmentWrite(&shared_segment, atomic_load(&(inventory.snapshot))); // THE ARGUMENTS ARE PARSED, THE LOADER ISN'T RUNNING YET: NO LOCK NEEDED
+		printf("The inventory is shared as %s.\n", shared_segment.name);
+	}
+
+	TRACE_BEGIN("ParseCacheInit", NULL);
+	ParseCacheInit(argv[0]);
+	TRACE_END("ParseCacheInit");
+
+	SearchIndex search_index = { 0 };
+	QueryColumns query_columns = { 0 };
+	TRACE_BEGIN("SearchIndexBuild", (item_pack.is_open) ? item_pack.file_name : ITEM_FOLDER_NAME);
+	SearchIndexBuild(&search_index);
+	TRACE_END("SearchIndexBuild");
+
+	uint32_t item_amount_to_push = inventory.item_requests.count;
+	printf("Amount of json files to parse: %u\n\n", item_amount_to_push);
+
+	ItemPrintJsonPathList(&inventory);
+
+	ItemLoader loader = { 0 };
+	loader.inventory = &inventory;
+	loader.file_count = item_amount_to_push;
+	inventory.files_to_load = item_amount_to_push;
+	InventoryPublish(&inventory, true);
+
+	if (progressive_load_enabled && *export_file_name == '\0') // THE MENU IS AVAILABLE RIGHT AWAY, THE ITEMS ARE ADDED WHILE THE USER ENTERS COMMANDS
+	{
+		printf("Loading %u json files in the background.\n", item_amount_to_push);
+		loader.is_quiet = true;
+		ItemLoaderStart(&loader);
+	}
+	else
+	{
+		printf("Parsing Json files to Item objects.\n");
+		ItemLoaderRun(&loader);
+	}
+
+	if (*export_file_name != '\0') // EXPORT TOOL: THE LOADED INVENTORY IS WRITTEN, NO MENU
+	{
+		bool is_exported = InventoryExport(&inventory, snapshot_reader, export_file_name);
+		if (*save_file_name != '\0')
+			InventorySave(&inventory, save_file_name);
+		ParseCacheSave(parse_cache_file_name);
+		PackClose(&item_pack);
+		SharedSegmentClose(&shared_segment);
+		return (is_exported) ? 0 : 3;
+	}
+
+	bool exit_inventory = false;
+	bool view_item_one_by_one = false;
+	char user_input = '\0';
+	InventorySnapshot* snapshot = NULL; // Of the A, L, M and W commands, only valid between acquire and release
+
+	printf("Inventory app start:\n");
+	PrintInventoryHelpMenu();
+
+	while (!exit_inventory)
+	{
+		user_input = (char)TerminalReadKey(&terminal); // WITH A TERMINAL THE COMMAND RUNS WHEN THE KEY IS PRESSED, WITHOUT ENTER
+
+		char command_name[2] = { user_input, '\0' };
+		TRACE_BEGIN("Command", command_name);
+
+		switch (user_input)
+		{
+		case 'a':
+		case 'A':
+			snapshot = InventorySnapshotAcquire(&inventory, snapshot_reader);
+			printf("Total item amount: %u (%u different items)\n", snapshot->item_count, snapshot->stack_count);
+			ItemLoaderPrintProgress(snapshot);
+			InventorySnapshotRelease(&inventory, snapshot_reader);
+			break;
+		case 'c':
+		case 'C':
+			ClearScreen();
+			break;
+		case 'h':
+		case 'H':
+			PrintInventoryHelpMenu();
+			break;
+		case 'i':
+		case 'I':
+			view_item_one_by_one = true;
+			bool show_details = false;
+			char view_status[ITEM_VIEW_STATUS_LENGTH] = { 0 };
+			if (terminal.is_raw) // THE VIEWER TAKES THE WHOLE SCREEN: AFTER EVERY KEY ONLY THE CELLS THAT CHANGED ARE DRAWN
+				ClearScreen();
+			else
+				PrintItemHelpMenu();
+
+			InventoryLock(&inventory); // THE LOCK IS ONLY HELD WHILE A VIEWER COMMAND RUNS, NOT WHILE WAITING FOR THE USER: THE VIEWER KEEPS A HANDLE, NOT A POINTER
+			Item* current_item = InventoryStep(&inventory, ITEM_HANDLE_NULL, true); // SET THE FIRST ITEM IN THE LIST AS ITEM TO VIEW
+			ItemHandle current_handle = (current_item) ? current_item->handle : ITEM_HANDLE_NULL;
+			if (terminal.is_raw)
+				ItemViewRender(&inventory, current_item, show_details, view_status);
+			else
+				ItemPrintBasicInfo(current_item); // PRINT BASIC INFO ABOUT THE FIRST ITEM.
+			InventoryUnlock(&inventory);
+
+			while (view_item_one_by_one) 
+			{
+				user_input = (char)TerminalReadKey(&terminal);
+				*view_status = '\0';
+
+				switch (user_input)
+				{
+					case 'c':
+					case 'C':
+						if (terminal.is_raw)
+							terminal.is_front_valid = false; // THE NEXT DRAW CLEARS THE SCREEN AND DRAWS EVERY CELL
+						else
+							ClearScreen();
+						break;
+					case 'd':
+					case 'D':
+						show_details = true;
+						if (!terminal.is_raw)
+						{
+							InventoryLock(&inventory);
+							ItemPrintAdvancedInfo(ItemHandleGet(&inventory, current_handle));
+							InventoryUnlock(&inventory);
+						}
+						break;
+					case 'h':
+					case 'H':
+						if (terminal.is_raw)
+							ItemViewMessage(view_status, "D: more data about the item, N: next item, P: previous item, X: delete the item, C: redraw the screen, Q: quit the item view");
+						else
+							PrintItemHelpMenu(); 
+						break;
+					break;
+					case 'n':
+					case 'N':
+						InventoryLock(&inventory);
+						current_item = InventoryStep(&inventory, current_handle, true); // THE LIST WAS EMPTY: ITEMS CAN BE ADDED IN THE BACKGROUND SINCE THEN, THE STEP STARTS AT THE FIRST ONE
+						if (current_item)
+						{
+							current_handle = current_item->handle;
+							show_details = false;
+							if (!terminal.is_raw)
+								ItemPrintBasicInfo(current_item);
+						}
+						else
+						{
+							ItemViewMessage(view_status, "No items available to display.");
+						}
+						InventoryUnlock(&inventory);
+						break;
+					case 'p':
+					case 'P':
+						InventoryLock(&inventory);
+						current_item = InventoryStep(&inventory, current_handle, false); // THE LIST WAS EMPTY: ITEMS CAN BE ADDED IN THE BACKGROUND SINCE THEN, THE STEP STARTS AT THE LAST ONE
+						if (current_item)
+						{
+							current_handle = current_item->handle;
+							show_details = false;
+							if (!terminal.is_raw)
+								ItemPrintBasicInfo(current_item);
+						}
+						else
+						{
+							ItemViewMessage(view_status, "No items available to display.");
+						}
+						InventoryUnlock(&inventory);
+						break;
+					case '\0':
+					case 'q':
+					case 'Q':
+						view_item_one_by_one = false;
+						if (terminal.is_raw)
+							ClearScreen();
+						printf("Quiting item view.\n");
+						PrintInventoryHelpMenu();
+						break;
+					case 'x':
+					case 'X':
+						InventoryLock(&inventory);
+						current_item = ItemHandleGet(&inventory, current_handle);
+						InventoryUnlock(&inventory);
+						if (current_item)
+						{
+							bool user_answered = false;
+							while (!user_answered)
+							{
+								ItemViewMessage(view_status, "Are you sure you want to delete this item ? ( N / Y )");
+								if (terminal.is_raw)
+								{
+									InventoryLock(&inventory);
+									ItemViewRender(&inventory, ItemHandleGet(&inventory, current_handle), show_details, view_status);
+									InventoryUnlock(&inventory);
+								}
+								user_input = (char)TerminalReadKey(&terminal);
+								*view_status = '\0';
+
+								switch (user_input)
+								{
+								case '\0': // NOTHING IS DELETED AT THE END OF THE INPUT
+								case 'n':
+								case 'N':
+									if (!terminal.is_raw)
+									{
+										InventoryLock(&inventory);
+										ItemPrintBasicInfo(ItemHandleGet(&inventory, current_handle));
+										InventoryUnlock(&inventory);
+									}
+									user_answered = true;
+									break;
+								case 'y':
+								case 'Y': // TO DO: ADJUST MONEY AND WEIGHT 
+									InventoryLock(&inventory);
+									current_item = ItemHandleGet(&inventory, current_handle);
+									if (current_item)
+									{
+										char index[current_item->index.length + 1];
+										ItemCopyString(current_item, current_item->index, index, sizeof index);
+										ItemPopHandle(&inventory, current_handle, 1, false);
+										InventoryPublish(&inventory, true);
+
+										// THE ITEM ONLY DISAPPEARS WHEN ITS LAST COPY IS DELETED. THEN THE PREVIOUS ITEM IS SHOWN: THE TOMBSTONE STILL KNOWS ITS NEIGHBOURS
+										current_item = ItemHandleGet(&inventory, current_handle);
+										if (current_item == NULL)
+										{
+											current_item = InventoryStep(&inventory, current_handle, false);
+											current_handle = (current_item) ? current_item->handle : ITEM_HANDLE_NULL;
+										}
+
+										show_details = false;
+										if (terminal.is_raw)
+										{
+											terminal.is_front_valid = false; // ItemPop PRINTED OVER THE VIEW
+											snprintf(view_status, sizeof view_status, "Deleted one copy of %s.", index);
+										}
+										else
+										{
+											ItemPrintBasicInfo(current_item);
+										}
+									}
+									else
+									{
+										ItemViewMessage(view_status, "The list is empty.");
+									}
+									InventoryUnlock(&inventory);
+									user_answered = true;
+									break;
 								default:
 									printf("Non valid command enterd, please enter yes (Y) or no (N).\n");
-									break;
-								}
-							}
-						}
-						else
-						{
-							printf("No items available to delete.\n");
-						}
-
-						break;
+									break;
+								}
+							}
+						}
+						else
+						{
+							ItemViewMessage(view_status, "No items available to delete.");
+						}
+
+						break;
 					default:
-						printf("Non valid command entered.\n");
-						break;
-				}
-			}
-
-			break;
-		case 'l': // Note: Lower case letter l, not number 1
-		case 'L':
-			ItemPrintList(inventory.items);
-			break;
-		case 'm':
-		case 'M':
-			printf("Money amount: %dgp %dsp %dcp\n", inventory.money.gp, inventory.money.sp, inventory.money.cp);
-			break;
-		case 'n':
-		case 'N':
-			printf("Enter json file name of the item to add. Please make sure the file is located in the folder: Items_JSON. Example: sword.json\n");
-			char file_name[50];
-			// fgets(file_name, sizeof(file_name), stdin);
-			scanf("%s", file_name);
-			UserItemAdd(&inventory, file_name);
-			break;
-		case 'q':
-		case 'Q':
-			bool user_answered = false;
-			while (!user_answered)
-			{
-				printf("Are you sure you want to quit the inventory ? ( N / Y )\n");
-				scanf(" %c", &user_input); // NOTE: THE LEADING SPACE BEFORE THE CHARACTER SPECIFIER IN THE FORMAT STRING REMOVES ISSUES WITH CHARACTERS LIKE TRAILING NEW LINES IN THE USER INPUT.
-
-				switch (user_input)
-				{
-				case 'n':
-				case 'N':
-					PrintInventoryHelpMenu();
-					user_answered = true;
-					break;
-				case 'y':
-				case 'Y': 
-					exit_inventory = true;
-					user_answered = true;
-					break;
+						ItemViewMessage(view_status, "Non valid command entered.");
+						break;
+				}
+
+				if (terminal.is_raw && view_item_one_by_one)
+				{
+					InventoryLock(&inventory);
+					ItemViewRender(&inventory, ItemHandleGet(&inventory, current_handle), show_details, view_status);
+					InventoryUnlock(&inventory);
+				}
+			}
+
+			break;
+		case 'l': // Note: Lower case letter l, not number 1
+		case 'L':
+			snapshot = InventorySnapshotAcquire(&inventory, snapshot_reader); // THE LOADER KEEPS PUSHING WHILE A LONG LIST IS PRINTED
+			ItemPrintList(snapshot);
+			ItemLoaderPrintProgress(snapshot);
+			InventorySnapshotRelease(&inventory, snapshot_reader);
+			break;
+		case 'm':
+		case 'M':
+			snapshot = InventorySnapshotAcquire(&inventory, snapshot_reader);
+			printf("Money amount: %dgp %dsp %dcp\n", snapshot->money.gp, snapshot->money.sp, snapshot->money.cp);
+			ItemLoaderPrintProgress(snapshot);
+			InventorySnapshotRelease(&inventory, snapshot_reader);
+			break;
+		case 'n':
+		case 'N':
+			printf("Enter the name, index or json file name of the item to add, the start of it is enough. Example: great\n");
+			char file_name[50];
+			// fgets(file_name, sizeof(file_name), stdin);
+			TerminalReadLine(&terminal, file_name, sizeof file_name); // THE NAME OF AN ITEM CAN CONTAIN SPACES
+			if (search_index.entry_count > 0)
+				UserItemSearchAdd(&inventory, &search_index, file_name);
+			else
+				UserItemAdd(&inventory, file_name);
+			break;
+		case 'f':
+		case 'F':
+			printf("Enter a query. Fields: weight, cost (5gp, 3sp, 7cp, without a unit in gp), quantity, category. Example: category=weapon and weight<5 order by cost desc limit 10\n");
+			char query_text[200];
+			TerminalReadLine(&terminal, query_text, sizeof query_text); // THE QUERY CONTAINS SPACES
+			UserItemQuery(&inventory, &query_columns, query_text);
+			break;
+		case 't':
+		case 'T':
+			printf("Enter a what-if plan: json files to buy with an optional amount, -index to sell copies. Example: greatsword.json 2 -dagger 1\n");
+			char plan_text[200];
+			TerminalReadLine(&terminal, plan_text, sizeof plan_text); // THE PLAN CONTAINS SPACES
+			UserItemPlan(&inventory, plan_text);
+			break;
+		case 'x':
+		case 'X':
+			printf("Enter the index of the items to drop, * matches any chars and ? one char. Example: rations*\n");
+			char drop_pattern[100];
+			TerminalReadLine(&terminal, drop_pattern, sizeof drop_pattern);
+			UserItemDrop(&inventory, drop_pattern);
+			break;
+		case 'v':
+		case 'V':
+			printf("Enter 'total' or 'markup <percent>', optionally followed by query conditions. Example: markup -10 category=weapon and cost>5gp\n");
+			char valuation_text[200];
+			TerminalReadLine(&terminal, valuation_text, sizeof valuation_text); // THE CONDITIONS CONTAIN SPACES
+			UserItemValuation(&inventory, &query_columns, valuation_text);
+			break;
+		case 'e':
+		case 'E':
+			printf("Enter the export file name: a .csv file is written as CSV, any other name as JSON Lines. Example: camp.jsonl\n");
+			char export_path[FILE_PATH_BUFFER_MAX + 1];
+			TerminalReadLine(&terminal, export_path, sizeof export_path);
+			InventoryExport(&inventory, snapshot_reader, export_path);
+			break;
+		case 's':
+		case 'S':
+			InventoryLock(&inventory); // THE LOADER UPDATES THE STATS TOO
+			StatsPrint();
+			InventoryUnlock(&inventory);
+			break;
+		case '\0': // END OF THE INPUT (PIPED COMMANDS): QUIT INSTEAD OF READING NOTHING FOREVER
+		case 'q':
+		case 'Q':
+			bool user_answered = false;
+			while (!user_answered)
+			{
+				printf("Are you sure you want to quit the inventory ? ( N / Y )\n");
+				user_input = (char)TerminalReadKey(&terminal);
+
+				switch (user_input)
+				{
+				case 'n':
+				case 'N':
+					PrintInventoryHelpMenu();
+					user_answered = true;
+					break;
+				case '\0':
+				case 'y':
+				case 'Y': 
+					ItemLoaderStop(&loader); // THE FILES THAT AREN'T LOADED YET ARE SKIPPED
+					exit_inventory = true;
+					user_answered = true;
+					break;
 				default:
 					printf("Non valid command enterd, please enter yes (Y) or no (N).\n");
-					break;
-				}
-			}
-			break;
-		case 'w':
-		case 'W':
-			printf("Carring weight left: %.2f\n", inventory.max_weight);
-			break;
+					break;
+				}
+			}
+			break;
+		case 'w':
+		case 'W':
+			snapshot = InventorySnapshotAcquire(&inventory, snapshot_reader);
+			printf("Carring weight left: %.2f\n", snapshot->max_weight);
+			ItemLoaderPrintProgress(snapshot);
+			InventorySnapshotRelease(&inventory, snapshot_reader);
+			break;
 		default:
 			printf("Non valid command entered.\n");
-			break;
-		}
-	}
-
-	printf("Quiting inventory app.");
-	return 0;
-}
-
-void PrintProgramArgs(int argc, char* argv[])
-{
-	printf("Program arguments:\n");
-	for (int i = 1; i < argc; ++i)
-		// printf("%s ", argv[i]);
-		printf("%s ", *(argv + i));
-	printf("\n\n");
-}
-
-void ParseProgramArgs(int argc, char* argv[], Inventory* inventory)
-{
-	for (int i = 1; i < argc; ++i)
-	{
-		// TO DO: STORE *(argv + i) IN A VARIABLE FOR READABLITY
-
-		if (strcmp(*(argv + i), "-w") == 0) // Inventory max weight
-		{	
-			++i; // Proceed the loop to check if the next string is a valid number (int or float)
-
-			if (IsFloat(*(argv + i)))
-			{
-				inventory->max_weight = strtof(*(argv + i), NULL); // Note: strtof() is locale dependend so watch out for '.' vs ',' decimal points!
-				printf("Inventory max weight: %.2f\n", inventory->max_weight);
-			}
-			else
-			{
-				printf("Invalid max weight entered. Example: -w 25.5\nExiting program.\n");
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-		}
-		else if (strcmp(*(argv + i), "-m") == 0) // Inventory money: example format -m 4gp 42sp 69cp 
-		{
-			++i; // Proceed the loop to check if the following string has the format "%dgp"
-
-			char money_type[3]; // "gp\0" or "sp\0" or "cp\0"
-			if (sscanf(*(argv + i), "%d%2s", &(inventory->money.gp), &money_type) == 2) // Note only read 2bytes of money type to prevent buffer overflow => Check if the money type string endend after 2 chars, else the string is too long and can't be a valid money type
-			{
-				if(strcmp("gp", money_type) == 0 && money_type[2] == '\0')
-				{
-					printf("Money gp: %d\n", inventory->money.gp);
-					++i; // Proceed the loop to check if the following string has the format "%dsp"
-				}
-				else // NON VALID INTEGER ENTERED
-				{
-					printf("Invalid money 'gp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-				}
-			}
-			else // NON VALID INTEGER ENTERED
-			{
-				printf("Invalid money 'gp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-
-			if (sscanf(*(argv + i), "%d%2s", &(inventory->money.sp), &money_type) == 2)
-			{
-				if (strcmp("sp", money_type) == 0 && money_type[2] == '\0')
-				{
-					printf("Money sp: %d\n", inventory->money.sp);
-					++i; // Proceed the loop to check if the following string has the format "%dcp"
-				}
-				else
-				{
-					printf("Invalid money 'sp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-				}
-			}
-			else
-			{
-				printf("Invalid money 'sp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-
-			if (sscanf(*(argv + i), "%d%2s", &(inventory->money.cp), &money_type) == 2)
-			{
-				if (strcmp("cp", money_type) == 0 && money_type[2] == '\0')
-				{
-					printf("Money cp: %d\n", inventory->money.cp);
-				}
-				else
-				{
-					printf("Invalid money 'cp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-				}
-			}
-			else
-			{
-				printf("Invalid money 'cp' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n");
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-		}
-		else if (strcmp(*(argv + i), "-c") == 0) // Inventory camp log file
-		{
-			// 1.) ALLOW THE PROGRAMMER TO ADJUST THE LOG FILENAME LENGTH IN THE INVENTORY STRUCT FROM 6chars TO 99chars:
-			int filename_max_size = sizeof(inventory->log_file_name) - 1; // -1 for the '\0' char
-			if(filename_max_size < FILE_PATH_BUFFER_MIN || filename_max_size > FILE_PATH_BUFFER_MAX) // minimum chars: 'single char" + ".txt" or ".log" + '\0' => minimum 6 chars 
-			{
-				printf("Invalid Log file name buffer length => min characters: %d, max characters: %d\nExiting program!", FILE_PATH_BUFFER_MIN, FILE_PATH_BUFFER_MAX);
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-
-			int snprintf_ret = -1;
-
-			// 2.) CHECK IF THE CAMP LOG FILENAME ENTERED BY THE USER IS VALID:
-			++i; // Proceed the loop to check if the following string is a valid .txt or .log filename
-
-			snprintf_ret = snprintf(inventory->log_file_name, sizeof(inventory->log_file_name), "%s", *(argv + i)); // Try to copy the entered log file path name to the Inventory struct and retreive the length (excl '\0') in the snprintf() return
-			if(snprintf_ret > 0 && snprintf_ret < sizeof(inventory->log_file_name)) // Check if the copy succeed and if the length of the entered file path name isnt't to large
-			{
-				if (snprintf_ret >= FILE_PATH_BUFFER_MIN - 1) // minimum 5 chars needed for a valid path: 'single char" + ".txt" or ".log"
-				{
-					int filename_str_length = snprintf_ret;
-
-					// printf("Camp log file name: %s\nCamp log file name length: %d\n", inventory->log_file_name, filename_str_length);
-					
-					if (!strcmp(inventory->log_file_name + filename_str_length - 4, ".log")) // Check if the file path name ends with ".log" or ".txt"
-						;// printf("File name extension: .log\n");
-					else if (!strcmp(inventory->log_file_name + filename_str_length - 4, ".txt"))
-						;// printf("File name extension: .txt\n");
-					else
-					{
-						printf("Log file name doesn't have a valid extension! => please use .txt or .log!\nExiting program.\n");
-						exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-					}
-					
-					char c = '\0';
-					for (int index = 0; index < filename_str_length - 4; ++index) // Loop over the log file path (skip extension .log or .txt) to check for invalid characters. Valid characters: Letters, integers and underscore
-					{
-						c = *((*(argv + i)) + index);
-						// printf("Character: %c\n", c);
-						if (!(isalpha(c) || c == '_'))
-						{
-							printf("Invalid character used in file name! => Valid characters: Letters, integers and underscore ('_')\nExiting program.\n");
-							exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-						}
-					}
-				}
-				else
-				{
-					printf("Log file name to short ! => min 1 char + \".log\" or \".txt\"\nExiting program.\n");
-					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-				}
-			}
-			else
-			{
-				printf("Log file name to long ! => max characters: %d\nExiting program.\n", filename_max_size);
-				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
-			}
-		}
-		else // Inventory items or unknown commands
-		{
-			size_t json_filename_len = strlen(*(argv + i));
-			if (json_filename_len < 6) // A json file name needs at least 6 chars to be valid: minimun 1char + 5chars for ".json"
-			{
-				printf("Entered unknown command: %s => this command is ignored!\n", *(argv + i));
-				// exit(1); // Just ignore the command and keep the program running as long as the other commands are valid
-				continue;
-			}
-
-			if (!strcmp(*(argv + i) + json_filename_len - 5, ".json")) // Check if the string contains ".json"
-			{
-				// COMBINE FOLDER NAME WITH FILENAME: "Items_JSON\\FILENAME"
-				char json_item_folder_name[11] = "Items_JSON";
-				unsigned int json_item_full_path_len = (sizeof (json_item_folder_name) + json_filename_len + 1); // sizeof includes '\0' char, +1 for the backslash '\'
-				char json_item_full_path[json_item_full_path_len]; 
-
-				int snprintf_ret = snprintf(json_item_full_path, json_item_full_path_len, "%s\\%s", json_item_folder_name, *(argv + i));
-				
-				if (snprintf_ret < 0 && snprintf_ret >= json_item_full_path_len)
-				{
-					printf("Failed to copy full json item path name!\nExiting program!\n");
-					exit(1);
-				}
-				// printf("Full json path: %s, length; %d\n", json_item_full_path, json_item_full_path_len);
-
-				// Check for existence
-				if ((_access(json_item_full_path, 0)) != -1)
-				{
-					static int total_item_amount = 0;
-
-					printf("File %s exists\n", json_item_full_path);
-					// Check for read permission
-					if ((_access(json_item_full_path, 4)) != -1)
-					{
-						// printf("File %s has read permission\n", json_item_full_path);
-
-						++i; // Proceed the loop to check if the following string is an integer. If it is, this is the item amount
-						
-						int item_amount = 1;
-						if (sscanf(*(argv + i), "%d", &item_amount) != 1) // If the next argv string isn't an integer, the item is just included once
-						{
-							--i; // Decrease the loop index again so the main for loop can do another check on this argv string to check if it is a valid command
-							item_amount = 1;
-						}
-						
-						// printf("Iventory current item amount: %d\n", inventory->item_count);
-						for (int i = total_item_amount; i < total_item_amount + item_amount; ++i) // Copy the full path of the json file to the json file path list of the inventory to parse these files after all the arguments are parsed.
-						{
-							// printf("Loop index: %d, Trying to copy full json path to inventory file path array.\n", i);
-							snprintf_ret = snprintf(inventory->item_file_paths[i], json_item_full_path_len, "%s", json_item_full_path);
-							if (snprintf_ret < 0 && snprintf_ret >= json_item_full_path_len)
-								printf("Failed to copy full json item path name!\nExiting program!\n");
-							// else
-								// printf("Copying full json path succeeded: %s\n", inventory->item_file_paths[i]);
-						}
-						total_item_amount += item_amount;
-
-						printf("Item amount to add: %d\n", item_amount);
-					}
-				}
-				else
-				{
-					// printf("%s does not exist!\nExiting program\n", *(argv + i));
-					// exit(1);
-					printf("%s does not exist! Item is ignored!\n", *(argv + i));
-				}
-			}
-			else
-			{
-				printf("Entered unknown command: %s => this command is ignored!\n", *(argv + i));
-				// exit(1); // Just ignore the command and keep the program running as long as the other commands are valid
-			}
-		}
-	}
-
-	printf("\n");
-}
-
-bool IsFloat(char* float_string) // Only accepts '.' as decimal point
-{
-	bool has_decimal_point = false;
-	char c = '\0';
-
-	uint8_t i = 0;
-	while ((c = *(float_string + i)) != '\0')
-	{
-		if (!isdigit(c) && c != '.')
-		{
-			return false;
-		}
-		else if (c == '.') // Avoid double decimal points => example: 15.25.13
-		{
-			if (!has_decimal_point)
-				has_decimal_point = true;
-			else
-				return false;
-		}
-
-		++i;
-	}
-
-	return true;
-}
-
-Item* JsonParse(char* file_path)
-{
-	if (file_path)
-	{
-		Item* item = ItemCreate();
-		printf("Parsing file: %s\n", file_path);
-		FILE* file = fopen(file_path, "r");
-
-		if (file)
-		{
-			printf("Scanning file for the index.\n");
-
-			// READ THE WHOLE FILE INTO AN ARRAY
-			char file_buffer[1000] = { 0 };
-			char* buffer_pointer = file_buffer; // POINTER TO TRAVERSE THE JSON STRING WITH
-
-			fseek(file, 0, SEEK_END);           // SEARCH FOR THE END OF THE FILE
-			long file_length = ftell(file);	    // STORE THE AMOUNT OF CHARACTERS IN THE FILE
-			fseek(file, 0, SEEK_SET);           // REPOINT THE FILE POINTER TO THE FIRST CHARACTER OF THE FILE
-			if (( sizeof file_buffer - 1) < file_length)
-			{
-				printf("Error: Buffer isn't large enough to store the json file content.\n");
-				exit(4);
-			}
-			else
-			{
-				fread(file_buffer, 1, file_length, file);
-				file_buffer[file_length] = '\0';
-			}
-
-			// printf("%s\n", file_buffer); // PRINT THE FULL JSON STRING
-
-			// TO DO: IF NEW OBJECT KEY IS FOUND, RESET THE JSON_KEY_INDEX TO 0
-			// uint8_t json_obj_index_count = 0; // !!!!! ONLY THE MAIN INDEX FOR NOW !!!!!! KEEP TRACK OF THE INDEX COUNT OF AN OBJECT, SOME OBJECTS CONSIST OF MUTIPLE OBJECTS SO THEY HAVE MORE THAN 1 INDEX KEYS
-			bool is_main_index_found = false; // USED TO SEE IF THE CURRENT MEMBERS ARE FROM THE MAIN JSON OBJECT OR FROM A NESTED OBJECT => TO DO: DETECT THE END OF A NESTED OBJECT
-			// bool is_new_object_found = false; // SET A FLAG WHEN A NEW JSON OBJECT STARTS
-			bool is_main_name_found = false;
-			bool is_main_weight_found = false;
-			bool is_cost_found = false;
-			bool is_cost_quantity_found = false;
-			bool is_cost_unit_found = false;
-			int coin_amount = -1;
-			char money_unit[3] = { 0 };
-			bool is_equipment_category_found = false;
-			bool is_equipment_category_index_found = false;
-			bool is_main_url_found = false;
-
-			bool is_open_accolade = false;
-			bool is_closing_accolade = false;
-			bool is_opening_square_bracket = false;
-			bool is_open_quote = false;
-			bool is_closing_quote = false;
-			bool is_colon_reached = false; 
-			bool is_key = false;
-			bool is_digit = false;
-
-			char key[50] = { 0 };
-			char value[50] = { 0 };
-			int index = 0;
-			while (*buffer_pointer != '\0')
-			{
-				if (*buffer_pointer == ' ' && !is_open_quote)	  // SKIP WHITESPACE => WHY DOES IT CRASH WITHOUT THIS ?????
-				{
-					++buffer_pointer;
-					continue;
-				}
-				if (*buffer_pointer == '"' && !is_open_quote)     // OPENINGS "
-				{
-					is_open_quote = true;
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == '"' && is_open_quote) // CLOSINGS "
-				{
-					is_open_quote = false;
-
-					if (is_key)
-					{
-						key[index] = '\0';
-						if (strcmp(key, "index") == 0 && !is_main_index_found) // printf("Main index found\n");
-							is_main_index_found = true;
-						else if (strcmp(key, "name") == 0 && !is_main_name_found)
-							is_main_name_found = true;
-						else if (strcmp(key, "weight") == 0 && !is_main_weight_found)
-							is_main_weight_found = true;
-						else if (strcmp(key, "quantity") == 0 && !is_cost_quantity_found)
-							is_cost_quantity_found = true;
-						else if (strcmp(key, "unit") == 0 && is_cost_found && is_cost_quantity_found && !is_cost_unit_found)
-							is_cost_unit_found = true;
-						else if (strcmp(key, "index") == 0 && is_equipment_category_found)
-							is_equipment_category_index_found = true;
-						else if (strcmp(key, "url") == 0  && !is_main_url_found)
-							is_main_url_found = true;
-					}
-					else
-					{
-						value[index] = '\0';
-						// TO DO: CHECK IF THE KEY FLAG FOR INDEX IS FOUND INDEX, IF SO, ADD IT TO THE ITEM
-						if (item->index[0] == '\0' && is_main_index_found) 
-						{
-							strcpy(item->index, value);
-							// printf("Added the main index to the item: %s.\n", item->index);
-						}
-						else if (item->name[0] == '\0' && is_main_name_found) 
-						{
-							strcpy(item->name, value);
-							// printf("Added the main name to the item: %s.\n", item->name);
-						}
-						else if (money_unit[0] == '\0' && is_cost_found && is_cost_unit_found)
-						{
-							strcpy(money_unit, value);
-							printf("Money unit is found: %s.\n", money_unit);
-							if (strcmp(money_unit, "gp") == 0)
-								item->money.gp = coin_amount;
-							else if (strcmp(money_unit, "sp") == 0)
-								item->money.sp = coin_amount;
-							else if (strcmp(money_unit, "cp") == 0)
-								item->money.cp = coin_amount;
-							// printf("Item money should be: %dgp, %dsp, %dcp.\n", item->money.gp, item->money.sp, item->money.cp);
-						}
-						else if (is_equipment_category_found) // THE MAIN URL IS ALWAYS THE LAST KEY VALUE PAIR WITH THE KEY URL. THIS STORE AL URLS IT WILL COME BY BUT EVENTUALLY WILL HOLD THE LAST URL.
-						{
-							strcpy(item->equipment_category, value);
-							is_equipment_category_found = false;
-						}
-						else if (is_main_url_found) // THE MAIN URL IS ALWAYS THE LAST KEY VALUE PAIR WITH THE KEY URL. THIS STORE AL URLS IT WILL COME BY BUT EVENTUALLY WILL HOLD THE LAST URL.
-						{
-							strcpy(item->url, value);
-							is_main_url_found = false;
-						}
-
-						printf("Key: %s, Value: %s\n", key, value);
-					}
-
-					index = 0;
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == ':')				  // KEY VALUE DELIMITER :
-				{
-					is_colon_reached = true;
-					// index = 0;
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == ',')				  // KEY VALUE PAIR DELIMITER ,
-				{
-					if (is_digit)
-					{
-						is_digit = false;
-						value[index] = '\0';
-						if (item->weight < 0.0f && is_main_weight_found)
-						{
-							item->weight = (float)atof(value);
-							// printf("The weight is found: %s\n", value);
-							// printf("Added the main weight to the item: %.2f.\n", item->weight);
-						}
-						else if (coin_amount == -1 && is_cost_found && is_cost_quantity_found)
-						{
-							coin_amount = atoi(value);
-							printf("Coin amount is found: %d.\n", coin_amount);
-						}
-
-						index = 0;
-						printf("Key: %s, Value: %s\n", key, value);
-					}
-					is_colon_reached = false;
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == '{')				  // OBJECT OPENING {
-				{
-					if (is_colon_reached) // WHEN A COLON IS FOLLOWED BY {, A NEW OBJECT STARTS
-					{
-						if (strcmp(key, "cost") == 0 && !is_cost_found)
-						{
-							printf("Cost is found\n");
-							is_cost_found = true;
-						}
-						else if (strcmp(key, "equipment_category") == 0 && !is_equipment_category_found) // HERE IT IS !!!!!!!!!!!
-						{
-							printf("equipment_category is found\n");
-							is_equipment_category_found = true;
-						}
-
-						printf("Object Key: %s\n", key);
-					}
-
-					is_colon_reached = false;
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == '[')				  // ARRAY OPENING [
-				{
-					++buffer_pointer;
-					continue;
-				}
-				else if (*buffer_pointer == ']')				  // ARRAY CLOSING ]
-				{
-					// TO DO: CHECK EVERYTHING IN BETWEEN THE []
-					value[index] = '\0';
-					printf("Key: %s, Value: %s\n", key, value);
-					++buffer_pointer;
-					continue;
-				}
-				
-				if (isdigit(*buffer_pointer))
-				{
-					is_digit = true;
-					value[index++] = *buffer_pointer;
-				}
-				else if (is_open_quote && !is_colon_reached)	   // SAVE THE KEY
-				{
-					is_key = true;
-					key[index++] = *buffer_pointer;
-				}
-				else if (is_open_quote && is_colon_reached)       // SAVE THE VALUE
-				{
-					is_key = false;
-					value[index++] = *buffer_pointer;
-				}
-
-				++buffer_pointer;
-			}
-			// printf("End of json string reached. %d chars read.\n", char_count);
-
-			fclose(file);
-		}
-		else
-		{
-			printf("Failed to open file.\n");
-			exit(3);
-		}
-
-		return item;
-	}
-	else
-	{
-		printf("Failed to parse json file. File path is NULL.\n");
-		exit(3);
-	}
-}
-
-ItemList* ItemListCreate(Item* new_item) 
-{
-	ItemList* items = new_item; // The head of the list
-	items->next = items;        // Point the head to itself
-	items->prev = items;
-
-	return items;
-}
-
-Item* ItemCreate(/*char* index*/)
-{
-	Item* item = (Item*)calloc(1, sizeof(Item));
-	item->weight = -1.0f;
-
-	if (item)
-	{
-		// item->index = index;
-		return item;
-	}
-	else
-	{
-		printf("Failed to allocate memory for a new Item!\nExiting program!\n");
-		exit(2);
-	}
-}
-
-void ItemPush(Inventory* inventory, Item* new_item) // Push item at the end of the list
-{
-	printf("Pushing item: %s\n", new_item->index);
-
-	if (inventory == NULL)
-	{
-		printf("inventory is NULL pointer!\n");
-		return;
-	}
-
-	// CHECK IF THE INVENTORY HAS ENOUGH MONEY AND WEIGHT BEFORE ADDING => ELSE GIVE A WARNING AND DONT ADD THE ITEM
-	// WEIGHT CHECK
-	if ((inventory->max_weight - new_item->weight) < 0.0f)
-	{
-		printf("Item index %s can't be added to the inventory because it exceeds the carrying capacity left. Item is not included!\n", new_item->index);
-		return;
-	}
-	else
-	{
-		inventory->max_weight -= new_item->weight;
-		printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
-	}
-	// MONEY CHECK
-	Money remaining;
-	if (subtract_money(&(inventory->money), &(new_item->money), &remaining)) 
-	{
-		printf("Sufficient funds.\n");
-		printf("Remaining: %d gp, %d sp, %d cp\n", remaining.gp, remaining.sp, remaining.cp);
-		inventory->money = remaining;
-	}
-	else 
-	{
-		printf("Not enough money left to include %s. Item is not included!\n", new_item->index); 
-		return;
-	}
-
-
-
-	if (inventory->items)
-	{
-		Item* head = inventory->items;
-		Item* temp = head;
-		Item* temp_prev = temp->prev;
-
-		while (temp->next != head) // Get the current last item of the list
-			temp = temp->next;
-
-		new_item->prev = temp;     // Point the previous pointer of the newly pushed item to the previously last item.
-		new_item->next = head;     // Point the next pointer of the newly pushed item to the head.
-		temp->next = new_item;     // Point the previously last item to the newly pushed item.
-		head->prev = new_item;     // Point the previous pointer of the head to the newly pushed (last) item.
-	}
-	else // If the list is a NULL pointer, create a new list
-	{
-		inventory->items = ItemListCreate(new_item);
-	}
-
-	++(inventory->item_count);
-}
-
-void ItemPop(Inventory* inventory, char* index) // Pop the chosen item from the list
-{
-	if (inventory == NULL)
-	{
-		printf("inventory is NULL pointer!\n");
-		return;
-	}
-
-	uint8_t item_count = InventoryGetItemCount(inventory);
-	if(item_count == 0)
-	{
-		printf("items list is empty! (NULL pointer)\n");
-		return;
-	}
-
-	Item** head = &(inventory->items);
-	Item* temp = *head;
-
-	do // CHECK IF THE LIST CONTAINS THE GIVEN INDEX TO POP AND POP IT WHEN FOUND
-	{
-		if (strcmp(temp->index, index) == 0)     // THE ITEM INDEX IS FOUND IN THE LIST
-		{
-			printf("Popping item: %s\n", index);
-
-			if (inventory->item_count == 1)      // LIST CONTAINS ONLY 1 ITEM WHICH IS THE HEAD: AFTER POPPING LIST IS EMPTY
-			{
-				// INCREASE THE CARRYING CAPACITY WITH THE ITEM WEIGHT
-				inventory->max_weight += (*head)->weight;
-				printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
-				// INCREASE IVENTORY MONEY
-				add_money(&(inventory->money), &((*head)->money), &(inventory->money));
-
-				ItemFree(head);
-			}
-			else if (inventory->item_count == 2) // LIST CONTAINS 2 ITEMS: AFTER POPPING THE LIST CONTAINS ONLY 1 ITEM WHICH BECOMES THE HEAD
-			{
-				// printf("Pop(): List has only %d item left after popping this item\n\r", inventory->item_count - 1);
-
-				*head = temp->next;     // ASSIGN THE ONE ITEM OF THE TWO THAT ISN'T POPPED TO THE HEAD OF THE LIST. THE NOT POPPED ITEM IS ALWAYS THE NEXT OR PREV POINTER OF THE POPPED ITEM BECAUSE THERE ARE ONLY 2 ITEMS IN THE LIST AT THIS POINT
-				(*head)->next = *head;  // POINT THE HEAD TO ITSELF
-				(*head)->prev = *head;  // POINT THE HEAD TO ITSELF
-
-				// INCREASE THE CARRYING CAPACITY WITH THE ITEM WEIGHT
-				inventory->max_weight += temp->weight;
-				printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
-				// INCREASE IVENTORY MONEY
-				add_money(&(inventory->money), &(temp->money), &(inventory->money));
-
-				ItemFree(&temp);        // FREE THE ITEM THAT NEEDS TO BE POPPED. WHEN THE HEAD NEEDS TO BE REMOVED, temp WILL HOLD THE HEAD ADDRESS. WHEN THE TAIL NEEDS TO BE REMOVED, temp WILL HOLD THE TAIL ADDRESS.
-			}
-			else
-			{
-				if (*head == temp) // IF THE 'TO BE POPPED ITEM' IS THE CURRENT HEAD, REPLACE ORIGINAL HEAD. NOTE: temp WILL HOLD THE POINTER TO THE OLD HEAD THAT IS TO BE POPPED.
-				{
-					(*head)->prev->next = (*head)->next;  // POINT THE LAST ITEM'S NEXT POINTER TO THE SECOND ITEM OF THE LIST.
-					(*head)->next->prev = (*head)->prev;  // POINT THE SECOND ITEM'S PREV POINTER TO THE LAST ITEM OF THE LIST.
-					*head = temp->next;                   // ASSIGN THE SECOND ITEM OF THE LIST TO THE OLD HEAD OF THE LIST.
-
-					// INCREASE THE CARRYING CAPACITY WITH THE ITEM WEIGHT
-					inventory->max_weight += temp->weight;
-					printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
-					// INCREASE IVENTORY MONEY
-					add_money(&(inventory->money), &(temp->money), &(inventory->money));
-
-					ItemFree(&temp);                      // POP/FREE THE OLD HEAD OF THE LIST.
-				}
-				else
-				{
-					temp->prev->next = temp->next;
-					temp->next->prev = temp->prev;
-
-					// INCREASE THE CARRYING CAPACITY WITH THE ITEM WEIGHT
-					inventory->max_weight += temp->weight;
-					printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
-					// INCREASE IVENTORY MONEY
-					add_money(&(inventory->money), &(temp->money), &(inventory->money));
-
-					ItemFree(&temp);                      // POP/FREE THE ITEM.
-				}
-				
-			}
-
-			--(inventory->item_count);                    // DECREASE THE ITEM COUNT WHEN A 'TO POPPED' INDEX IS FOUND
-
-			return;
-		}
-
-		temp = temp->next;								  // SET THE temp POINTER TO THE NEXT POINTER OF THE CURRENT ITEM
-
-	} while (temp != *head);
-
-	// NOTIFY THE PLAYER IF THE INDEX IS NOT FOUND
-	printf("Index: %s is not found in the list!\n\r", index);
-}
-
-void ItemFree(Item** item)
-{
-	if (*item)
-	{
-		free(*item);
-		*item = NULL;
-	}
-}
-
-void ItemPrintBasicInfo(Item* item)
-{
-	if (item)
-	{
-		printf("Index: %s\nName: %s\nweight: %.2f\nMoney: %dgp, %dsp, %dcp.\n", item->index, item->name, item->weight, item->money.gp, item->money.sp, item->money.cp);
-	}
-	else
-		printf("List is empty.\n");
-}
-
-void ItemPrintAdvancedInfo(Item* item)
-{
-	printf("Item url: %s\nEquipment category: %s\n", item->url, item->equipment_category);
-}
-
-void ItemPrintList(ItemList* items)
-{
-	if (items)
-	{
-		Item* head = items;
-		Item* temp = head;
-
-		uint8_t item_num = 1;
-		do
-		{
-			printf("Index: %s\nName: %s\nweight: %.2f\nMoney: %dgp, %dsp, %dcp.\n\n", temp->index, temp->name, temp->weight, temp->money.gp, temp->money.sp, temp->money.cp);
-			temp = temp->next;
-			++item_num;
-		} while (temp != head);
-	}
-	else
-	{
-		printf("List is empty.\n");
-	}
-}
-
-void ItemPrintJsonPathList(Inventory* inventory)
-{
-	printf("Printing json file paths:\n");
-	uint8_t path_amount = 0;
-	while (*(inventory->item_file_paths[path_amount]) != '\0')
-	{
-		printf("%s\n", inventory->item_file_paths[path_amount]);
-		++path_amount;
-	}
-	printf("\n");
-}
-
-uint8_t InventoryGetItemCount(Inventory* inventory)
-{
-	if (inventory)
-		return inventory->item_count;
-	else
-		printf("Inventory is NULL pointer!\n");
-	return 0;
-}
-
-bool IsInventoryEmpty(Inventory* inventory)
-{
-	return (inventory->item_count == 0) ? true : false;
-}
-
-void UserItemAdd(Inventory* inventory, char* file_path)
-{
-	// COMBINE FOLDER NAME WITH FILENAME: "Items_JSON\\FILENAME"
-	size_t json_filename_len = strlen(file_path);
-	char json_item_folder_name[11] = "Items_JSON";
-	unsigned int json_item_full_path_len = (sizeof(json_item_folder_name) + json_filename_len + 1); // sizeof includes '\0' char, +1 for the backslash '\'
-	char json_item_full_path[json_item_full_path_len];
-
-	int snprintf_ret = snprintf(json_item_full_path, json_item_full_path_len, "%s\\%s", json_item_folder_name, file_path);
-
-	if (snprintf_ret < 0 && snprintf_ret >= json_item_full_path_len)
-	{
-		printf("Failed to copy full json item path name!\nExiting program!\n");
-		exit(1);
-	}
-
-	Item* new_item = NULL;
-	new_item = JsonParse(json_item_full_path);
-
-	printf("\nNew Item created from JSON file. Index: %s, Name: %s\n\n", new_item->index, new_item->name);
-	ItemPush(inventory, new_item); 
-	printf("\n");
-}
-
-void PrintInventoryHelpMenu(void)
-{
-	printf("Inventory help menu:\n");
-	printf("- Press H to display the inventory help menu.\n");
-	printf("- Press M to display the current money amount.\n- Press W to display the carrying weight capacity left.\n- Press A to display item amount.\n");
-	printf("- Press L to display basic item information of the whole list.\n- Press I to display item one by one.\n- Press N to add a new item.\n");
-	printf("- Press C to clear the screen.\n- Press Q to quit the inventory.\n\n");
-}
-
-void PrintItemHelpMenu(void)
-{
-	printf("Item help menu:\n- Press H to display the item help menu.\n");
-	printf("- Press D to display more data about the current item.\n- Press N to visit the next item.\n- Press P to visit the previous item.\n- Press X to delete the current item.\n- Press Q to quit the item view.\n");
-	printf("- Press C to clear the screen.\n\n");
-}
-
-int convert_to_cp(const Money* money) 
-{
-	return (money->gp * 10000) + (money->sp * 100) + money->cp;
-}
-
-Money convert_from_cp(int total_cp) 
-{
-	Money result;
-	result.gp = total_cp / 10000;
-	total_cp %= 10000;
-	result.sp = total_cp / 100;
-	result.cp = total_cp % 100;
-	return result;
-}
-
-int subtract_money(const Money* available, const Money* cost, Money* remaining) 
-{
-	int total_cp_available = convert_to_cp(available);
-	// printf("Total money available in cp: %d\n", total_cp_available);
-	int total_cp_cost = convert_to_cp(cost);
-	// printf("Item money in cp: %d\n", total_cp_cost);
-
-	if (total_cp_available < total_cp_cost) 
-	{
-		return 0; 
-	}
-
-	int total_cp_remaining = total_cp_available - total_cp_cost;
-	*remaining = convert_from_cp(total_cp_remaining);
-	return 1; 
-}
-
-void add_money(const Money* available, const Money* cost, Money* inventory_money)
-{
-	printf("Adding money back\n");
-
-	int total_cp_available = convert_to_cp(available);
-	// printf("Total money available in cp: %d\n", total_cp_available);
-	int total_cp_cost = convert_to_cp(cost);
-	// printf("Item money in cp: %d\n", total_cp_cost);
-
-	int total_cp = total_cp_available + total_cp_cost;
-	*inventory_money = convert_from_cp(total_cp);
-}
-
-void WriteToLogFile(Inventory* inventory, char* log_file_path)
-{
-	/*FILE* file = fopen(log_file_path, "a");
-
-	if (file)
-	{
-		char* weigth_string = "Inventory weigth capacity left: ";
-		fwrite(ltoa(weigth_string), 1, sizeof weigth_string, file);
-		fwrite(inventory->max_weight, 1, sizeof inventory->max_weight, file);
-
-		fclose(file);
-	}
-	else
-	{
-		printf("%s does not exitst.\n", log_file_path);
-	}*/
-
-}
\ No newline at end of file
+			break;
+		}
+
+		// BETWEEN TWO COMMANDS NO STACK IS BEING VIEWED OR WALKED: THE TOMBSTONES OF ALL THE POPS SINCE THE LAST COMPACTION ARE FREED TOGETHER
+		InventoryLock(&inventory);
+		InventoryCompact(&inventory, false);
+		InventoryUnlock(&inventory);
+
+		TRACE_END("Command");
+	}
+
+	if (*save_file_name != '\0') // THE LOADER IS STOPPED: NOTHING CHANGES THE INVENTORY ANYMORE
+		InventorySave(&inventory, save_file_name);
+	ParseCacheSave(parse_cache_file_name); // THE LOADER IS STOPPED: NOTHING CHANGES THE CACHE ANYMORE
+	PackClose(&item_pack);
+	SharedSegmentClose(&shared_segment);
+
+	printf("Quiting inventory app.");
+	return 0;
+}
+
+void PrintProgramArgs(int argc, char* argv[])
+{
+	printf("Program arguments:\n");
+	for (int i = 1; i < argc; ++i)
+		// printf("%s ", argv[i]);
+		printf("%s ", *(argv + i));
+	printf("\n\n");
+}
+
+void ParseProgramArgs(int argc, char* argv[], Inventory* inventory)
+{
+	for (int i = 1; i < argc - 1; ++i) // OPEN THE PACK FIRST: THE ITEM ARGUMENTS BEFORE --pack ARE LOOKED UP IN IT TOO
+	{
+		if (strcmp(*(argv + i), "--pack") == 0 && !item_pack.is_open)
+			PackOpen(&item_pack, *(argv + i + 1));
+	}
+
+	for (int i = 1; i < argc - 1; ++i) // RESTORE THE SAVE FILE FIRST: -w AND -m CHANGE THE TOTALS OF THE CAMP, THE ITEM ARGUMENTS ARE PUSHED ON TOP OF ITS STACKS
+	{
+		if (strcmp(*(argv + i), "--save") == 0 && *save_file_name == '\0')
+		{
+			int snprintf_ret = snprintf(save_file_name, sizeof save_file_name, "%s", *(argv + i + 1));
+			if (snprintf_ret <= 0 || snprintf_ret >= sizeof save_file_name)
+			{
+				printf("Invalid save file name entered. Example: --save camp.inv\nExiting program.\n");
+				exit(1);
+			}
+			InventoryRestore(inventory, save_file_name);
+		}
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		// TO DO: STORE *(argv + i) IN A VARIABLE FOR READABLITY
+
+		if (strcmp(*(argv + i), "-w") == 0) // Inventory max weight
+		{	
+			++i; // Proceed the loop to check if the next string is a valid number (int or float)
+
+			if (i < argc && NumberParseWeight(*(argv + i), &(inventory->max_weight)))
+			{
+				char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+				NumberFormatWeight(inventory->max_weight, weight_text, sizeof weight_text);
+				printf("Inventory max weight: %s\n", weight_text);
+				if (inventory->changes.is_enabled) // THE CARRYING CAPACITY OF A SAVED CAMP CHANGES: SYNCED LIKE A PUSH OR A POP
+				{
+					++(inventory->version);
+					InventoryLogChange(inventory, CHANGE_MONEY, NULL, 0);
+				}
+			}
+			else
+			{
+				printf("Invalid max weight entered. Example: -w 25.5\nExiting program.\n");
+				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+			}
+		}
+		else if (strcmp(*(argv + i), "-m") == 0) // Inventory money: example format -m 4gp 42sp 69cp 
+		{
+			const char* money_units[3] = { "gp", "sp", "cp" };
+			int* money_amounts[3] = { &(inventory->money.gp), &(inventory->money.sp), &(inventory->money.cp) };
+			for (int unit = 0; unit < 3; ++unit)
+			{
+				++i; // Proceed the loop to check if the following string has the format "%dgp", then "%dsp" and "%dcp"
+				if (i == argc || !NumberParseMoney(*(argv + i), money_units[unit], money_amounts[unit]))
+				{
+					printf("Invalid money '%s' format entered. Example format: -m 4gp 42sp 69cp\nExiting program.\n", money_units[unit]);
+					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+				}
+				printf("Money %s: %d\n", money_units[unit], *(money_amounts[unit]));
+			}
+			if (inventory->changes.is_enabled) // THE MONEY OF A SAVED CAMP CHANGES: SYNCED LIKE A PUSH OR A POP
+			{
+				++(inventory->version);
+				InventoryLogChange(inventory, CHANGE_MONEY, NULL, 0);
+			}
+		}
+		else if (strcmp(*(argv + i), "--mmap") == 0) // Map the item json files instead of reading them: the item strings point into the mapped files
+		{
+			json_mmap_enabled = true;
+			printf("Item json files are memory mapped.\n");
+		}
+		else if (strcmp(*(argv + i), "--progressive") == 0) // Show the menu right away and load the items in the background
+		{
+			progressive_load_enabled = true;
+			printf("Items are loaded in the background.\n");
+		}
+		else if (strcmp(*(argv + i), "--trace") == 0) // Chrome trace output file: already handled by TraceStart()
+		{
+			++i; // Skip the trace file name
+		}
+		else if (strcmp(*(argv + i), "--pack") == 0) // Item pack to read the json files from: already opened before this loop
+		{
+			++i; // Skip the pack file name
+		}
+		else if (strcmp(*(argv + i), "--pack-build") == 0) // Pack tool: write every json file of the item folder to one pack and quit
+		{
+			++i; // Proceed the loop to copy the pack file name
+
+			int snprintf_ret = (i < argc) ? snprintf(pack_build_file_name, sizeof pack_build_file_name, "%s", *(argv + i)) : -1;
+			if (snprintf_ret <= 0 || snprintf_ret >= sizeof pack_build_file_name)
+			{
+				printf("Invalid pack file name entered. Example: --pack-build Items.pack\nExiting program.\n");
+				exit(1);
+			}
+		}
+		else if (strcmp(*(argv + i), "--export") == 0) // Write the inventory to a CSV or JSON Lines file when the items are loaded and quit
+		{
+			++i; // Proceed the loop to copy the export file name
+
+			int snprintf_ret = (i < argc) ? snprintf(export_file_name, sizeof export_file_name, "%s", *(argv + i)) : -1;
+			if (snprintf_ret <= 0 || snprintf_ret >= sizeof export_file_name)
+			{
+				printf("Invalid export file name entered. Example: --export camp.csv\nExiting program.\n");
+				exit(1);
+			}
+		}
+		else if (strcmp(*(argv + i), "--snapshot-stress") == 0) // Snapshot tool: reader threads against a live writer, then quit
+		{
+			i += 2; // Proceed the loop past the reader count and the stack count
+			if (i >= argc || !ItemAmountParse(*(argv + i - 1), &snapshot_stress_readers) || !ItemAmountParse(*(argv + i), &snapshot_stress_stacks) || snapshot_stress_readers > SNAPSHOT_MAX_READERS
+				|| SnapshotStressWeight(snapshot_stress_stacks) > SNAPSHOT_STRESS_MAX_WEIGHT)
+			{
+				printf("Invalid snapshot stress arguments entered, at most %d readers and %.0f lb of stacks. Example: --snapshot-stress 8 5000\nExiting program.\n", SNAPSHOT_MAX_READERS, SNAPSHOT_STRESS_MAX_WEIGHT);
+				exit(1);
+			}
+		}
+		else if (strcmp(*(argv + i), "--save") == 0) // Save file of the camp: already restored before this loop
+		{
+			++i; // Skip the save file name
+		}
+		else if (strcmp(*(argv + i), "--delta-emit") == 0 || strcmp(*(argv + i), "--delta-apply") == 0) // Sync tools: write the delta between two save files, or apply a delta to a save file, and quit
+		{
+			is_delta_apply = (strcmp(*(argv + i), "--delta-apply") == 0);
+			for (int path = 0; path < 3; ++path)
+			{
+				++i; // Proceed the loop to copy the next file name
+				int snprintf_ret = (i < argc) ? snprintf(delta_paths[path], sizeof delta_paths[path], "%s", *(argv + i)) : -1;
+				if (snprintf_ret <= 0 || snprintf_ret >= sizeof delta_paths[path])
+				{
+					printf("Invalid sync file names entered. Example: --delta-emit old.inv new.inv camp.delta or --delta-apply old.inv camp.delta new.inv\nExiting program.\n");
+					exit(1);
+				}
+			}
+		}
+		else if (strcmp(*(argv + i), "--pack-compress") == 0) // Pack tool: compress the entries that get smaller
+		{
+			pack_compress_enabled = true;
+		}
+		else if (strcmp(*(argv + i), "--shm") == 0 || strcmp(*(argv + i), "--shm-view") == 0) // Share the inventory with other processes, or print the inventory another process shares
+		{
+			char* segment_name = (strcmp(*(argv + i), "--shm") == 0) ? shared_segment.name : shared_view_name;
+			++i; // Proceed the loop to check the segment name
+
+			if (i == argc || !SharedSegmentName(segment_name, *(argv + i)))
+			{
+				printf("Invalid shared memory name entered. Example: --shm camp\nExiting program.\n");
+				exit(1);
+			}
+		}
+		else if (strcmp(*(argv + i), "-c") == 0) // Inventory camp log file
+		{
+			// 1.) ALLOW THE PROGRAMMER TO ADJUST THE LOG FILENAME LENGTH IN THE INVENTORY STRUCT FROM 6chars TO 99chars:
+			int filename_max_size = sizeof(inventory->log_file_name) - 1; // -1 for the '\0' char
+			if(filename_max_size < FILE_PATH_BUFFER_MIN || filename_max_size > FILE_PATH_BUFFER_MAX) // minimum chars: 'single char" + ".txt" or ".log" + '\0' => minimum 6 chars 
+			{
+				printf("Invalid Log file name buffer length => min characters: %d, max characters: %d\nExiting program!", FILE_PATH_BUFFER_MIN, FILE_PATH_BUFFER_MAX);
+				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+			}
+
+			int snprintf_ret = -1;
+
+			// 2.) CHECK IF THE CAMP LOG FILENAME ENTERED BY THE USER IS VALID:
+			++i; // Proceed the loop to check if the following string is a valid .txt or .log filename
+
+			snprintf_ret = snprintf(inventory->log_file_name, sizeof(inventory->log_file_name), "%s", *(argv + i)); // Try to copy the entered log file path name to the Inventory struct and retreive the length (excl '\0') in the snprintf() return
+			if(snprintf_ret > 0 && snprintf_ret < sizeof(inventory->log_file_name)) // Check if the copy succeed and if the length of the entered file path name isnt't to large
+			{
+				if (snprintf_ret >= FILE_PATH_BUFFER_MIN - 1) // minimum 5 chars needed for a valid path: 'single char" + ".txt" or ".log"
+				{
+					int filename_str_length = snprintf_ret;
+
+					// printf("Camp log file name: %s\nCamp log file name length: %d\n", inventory->log_file_name, filename_str_length);
+					
+					if (!strcmp(inventory->log_file_name + filename_str_length - 4, ".log")) // Check if the file path name ends with ".log" or ".txt"
+						;// printf("File name extension: .log\n");
+					else if (!strcmp(inventory->log_file_name + filename_str_length - 4, ".txt"))
+						;// printf("File name extension: .txt\n");
+					else
+					{
+						printf("Log file name doesn't have a valid extension! => please use .txt or .log!\nExiting program.\n");
+						exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+					}
+					
+					char c = '\0';
+					for (int index = 0; index < filename_str_length - 4; ++index) // Loop over the log file path (skip extension .log or .txt) to check for invalid characters. Valid characters: Letters, integers and underscore
+					{
+						c = *((*(argv + i)) + index);
+						// printf("Character: %c\n", c);
+						if (!(isalpha(c) || c == '_'))
+						{
+							printf("Invalid character used in file name! => Valid characters: Letters, integers and underscore ('_')\nExiting program.\n");
+							exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+						}
+					}
+				}
+				else
+				{
+					printf("Log file name to short ! => min 1 char + \".log\" or \".txt\"\nExiting program.\n");
+					exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+				}
+			}
+			else
+			{
+				printf("Log file name to long ! => max characters: %d\nExiting program.\n", filename_max_size);
+				exit(1); // TO DO: CHOOSE EXIT NUMBERS FOR EACH POSSIBLE EXIT
+			}
+		}
+		else if (**(argv + i) == '@') // Response file with item arguments: a loadout that doesn't fit on the command line
+		{
+			ItemResponseFileRead(inventory, *(argv + i) + 1);
+		}
+		else if (strpbrk(*(argv + i), "*?") != NULL) // Glob pattern: every matching json file of the item folder, or of the pack with --pack
+		{
+			char* pattern = *(argv + i);
+			uint32_t item_amount = 1;
+			if (i + 1 < argc && ItemAmountParse(*(argv + i + 1), &item_amount))
+				++i; // The next string is the amount of copies of every match
+			ItemArgumentAdd(inventory, pattern, item_amount, false);
+		}
+		else // Inventory items or unknown commands
+		{
+			size_t json_filename_len = strlen(*(argv + i));
+			if (json_filename_len < 6) // A json file name needs at least 6 chars to be valid: minimun 1char + 5chars for ".json"
+			{
+				printf("Entered unknown command: %s => this command is ignored!\n", *(argv + i));
+				// exit(1); // Just ignore the command and keep the program running as long as the other commands are valid
+				continue;
+			}
+
+			if (!strcmp(*(argv + i) + json_filename_len - 5, ".json")) // Check if the string contains ".json"
+			{
+				// COMBINE FOLDER NAME WITH FILENAME: "Items_JSON\\FILENAME"
+				char json_item_folder_name[] = ITEM_FOLDER_NAME;
+				unsigned int json_item_full_path_len = (sizeof (json_item_folder_name) + json_filename_len + 1); // sizeof includes '\0' char, +1 for the backslash '\'
+				char json_item_full_path[json_item_full_path_len]; 
+
+				int snprintf_ret = snprintf(json_item_full_path, json_item_full_path_len, "%s" PATH_SEPARATOR "%s", json_item_folder_name, *(argv + i));
+				
+				if (snprintf_ret < 0 && snprintf_ret >= json_item_full_path_len)
+				{
+					printf("Failed to copy full json item path name!\nExiting program!\n");
+					exit(1);
+				}
+				// printf("Full json path: %s, length; %d\n", json_item_full_path, json_item_full_path_len);
+
+				// Check for existence: in the pack when there is one, else in the item folder
+				int access_ret = 0;
+				bool is_in_pack = PackFind(&item_pack, json_item_full_path) != NULL;
+				if (!is_in_pack)
+				{
+					TRACE_BEGIN("_access", json_item_full_path);
+					access_ret = StatsFileAccess(json_item_full_path, 0);
+					TRACE_END("_access");
+				}
+				if (access_ret != -1)
+				{
+					if (is_in_pack)
+					{
+						printf("File %s found in the pack %s\n", *(argv + i), item_pack.file_name);
+					}
+					else
+					{
+						printf("File %s exists\n", json_item_full_path);
+						// Check for read permission
+						TRACE_BEGIN("_access", json_item_full_path);
+						access_ret = StatsFileAccess(json_item_full_path, 4);
+						TRACE_END("_access");
+					}
+					if (access_ret != -1)
+					{
+						// printf("File %s has read permission\n", json_item_full_path);
+
+						++i; // Proceed the loop to check if the following string is an integer. If it is, this is the item amount
+						
+						uint32_t item_amount = 1;
+						if (i == argc || !ItemAmountParse(*(argv + i), &item_amount)) // If the next argv string isn't a positive integer (or there is no next string), the item is just included once
+						{
+							--i; // Decrease the loop index again so the main for loop can do another check on this argv string to check if it is a valid command
+							item_amount = 1;
+						}
+
+						if (snprintf_ret > FILE_PATH_BUFFER_MAX) // THE ITEM REMEMBERS ITS FILE NAME IN 100 CHARS
+						{
+							printf("Full json item path name %s is to long! Item is ignored!\n", json_item_full_path);
+							continue;
+						}
+
+						// Add the full path of the json file to the request list of the inventory, together with the amount of copies, to parse these files after all the arguments are parsed.
+						ItemRequestAdd(&(inventory->item_requests), json_item_full_path, item_amount);
+
+						printf("Item amount to add: %u\n", item_amount);
+					}
+				}
+				else
+				{
+					// printf("%s does not exist!\nExiting program\n", *(argv + i));
+					// exit(1);
+					printf("%s does not exist! Item is ignored!\n", *(argv + i));
+				}
+			}
+			else
+			{
+				printf("Entered unknown command: %s => this command is ignored!\n", *(argv + i));
+				// exit(1); // Just ignore the command and keep the program running as long as the other commands are valid
+			}
+		}
+	}
+
+	printf("\n");
+}
+
+// text_end NULL: '\0' ENDS THE TEXT, IT ISN'T A DIGIT SO THE LOOPS STOP THERE ANYWAY
+#define NUMBER_IN_TEXT(c, text_end) ((text_end) == NULL || (c) < (text_end))
+
+const char* NumberParseInteger(const char* text, const char* text_end, int64_t* value)
+{
+	const char* c = text;
+	bool is_negative = NUMBER_IN_TEXT(c, text_end) && *c == '-';
+	if (is_negative)
+		++c;
+
+	const char* digits_start = c;
+	uint64_t magnitude = 0;
+	for (; NUMBER_IN_TEXT(c, text_end) && *c >= '0' && *c <= '9'; ++c)
+	{
+		uint64_t digit = (uint64_t)(*c - '0');
+		if (magnitude > (UINT64_MAX - digit) / 10)
+			return NULL;
+		magnitude = magnitude * 10 + digit;
+	}
+
+	if (c == digits_start || magnitude > (uint64_t)INT64_MAX + is_negative) // -2^63 STILL FITS
+		return NULL;
+	*value = is_negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+	return c;
+}
+
+const char* NumberParseDecimal(const char* text, const char* text_end, double* value)
+{
+	// 10^0 ... 10^22 ARE EXACT DOUBLES
+	static const double powers_of_ten[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* c = text;
+	bool is_negative = NUMBER_IN_TEXT(c, text_end) && *c == '-';
+	if (is_negative)
+		++c;
+
+	// THE NUMBER IS mantissa * 10^exponent. ONLY THE FIRST 19 SIGNIFICANT DIGITS FIT IN THE MANTISSA, LATER DIGITS CAN'T CHANGE A FLOAT
+	uint64_t mantissa = 0;
+	int digit_count = 0;
+	int exponent = 0;
+	bool has_digit = false;
+	for (; NUMBER_IN_TEXT(c, text_end) && *c >= '0' && *c <= '9'; ++c)
+	{
+		has_digit = true;
+		if (digit_count < 19)
+		{
+			mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+			digit_count += (mantissa != 0); // LEADING ZEROS AREN'T SIGNIFICANT
+		}
+		else
+			++exponent;
+	}
+	if (NUMBER_IN_TEXT(c, text_end) && *c == '.')
+	{
+		++c;
+		for (; NUMBER_IN_TEXT(c, text_end) && *c >= '0' && *c <= '9'; ++c)
+		{
+			has_digit = true;
+			if (digit_count < 19)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+				digit_count += (mantissa != 0);
+				--exponent;
+			}
+		}
+	}
+	if (!has_digit) // "", "-" AND "." AREN'T NUMBERS
+		return NULL;
+
+	if (NUMBER_IN_TEXT(c, text_end) && (*c == 'e' || *c == 'E'))
+	{
+		const char* exponent_digit = c + 1;
+		bool is_exponent_negative = false;
+		if (NUMBER_IN_TEXT(exponent_digit, text_end) && (*exponent_digit == '+' || *exponent_digit == '-'))
+			is_exponent_negative = (*(exponent_digit++) == '-');
+
+		if (NUMBER_IN_TEXT(exponent_digit, text_end) && *exponent_digit >= '0' && *exponent_digit <= '9') // ELSE THE 'e' ISN'T PART OF THE NUMBER
+		{
+			int exponent_value = 0;
+			for (c = exponent_digit; NUMBER_IN_TEXT(c, text_end) && *c >= '0' && *c <= '9'; ++c)
+			{
+				if (exponent_value < 100000) // FAR BEYOND THE DOUBLE RANGE, THE RESULT IS 0 OR INFINITE ANYWAY
+					exponent_value = exponent_value * 10 + (*c - '0');
+			}
+			exponent += is_exponent_negative ? -exponent_value : exponent_value;
+		}
+	}
+
+	double result = (double)mantissa;
+	if (mantissa != 0 && exponent != 0)
+	{
+		if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) // BOTH OPERANDS ARE EXACT: ONE CORRECTLY ROUNDED OPERATION, LIKE strtod
+		{
+			result = (exponent < 0) ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+		}
+		else // LONG MANTISSAS AND BIG EXPONENTS: THE EXTENDED PRECISION KEEPS THE ERROR FAR BELOW THE PRECISION OF A FLOAT WEIGHT
+		{
+			long double scaled = (long double)mantissa;
+			int steps = (exponent < 0) ? -exponent : exponent;
+			if (steps > 5000)
+				steps = 5000;
+			long double power = 10.0L;
+			long double factor = 1.0L;
+			for (; steps > 0; steps >>= 1, power *= power) // SQUARE AND MULTIPLY
+			{
+				if (steps & 1)
+					factor *= power;
+			}
+			result = (double)((exponent < 0) ? scaled / factor : scaled * factor);
+		}
+	}
+
+	*value = is_negative ? -result : result;
+	return c;
+}
+
+bool NumberParseWeight(const char* text, float* weight)
+{
+	double value = 0.0;
+	const char* number_end = (text != NULL) ? NumberParseDecimal(text, NULL, &value) : NULL;
+	if (number_end == NULL || *number_end != '\0' || *text == '-' || value > FLT_MAX)
+		return false;
+
+	*weight = (float)value;
+	return true;
+}
+
+bool NumberParseMoney(const char* text, const char* unit, int* amount)
+{
+	int64_t value = 0;
+	const char* number_end = (text != NULL && *text != '-') ? NumberParseInteger(text, NULL, &value) : NULL;
+	if (number_end == NULL || value > INT32_MAX || strcmp(number_end, unit) != 0)
+		return false;
+
+	*amount = (int)value;
+	return true;
+}
+
+int NumberFormatWeight(float weight, char* buffer, size_t buffer_size)
+{
+	int length = 0;
+	for (int precision = 1; precision <= 9; ++precision) // 9 SIGNIFICANT DIGITS ALWAYS READ BACK AS THE SAME FLOAT
+	{
+		length = snprintf(buffer, buffer_size, "%.*g", precision, (double)weight);
+		for (char* c = buffer; *c != '\0'; ++c) // A LOCALE WITH A ',' DECIMAL POINT DOESN'T CHANGE THE TEXT
+		{
+			if (*c == ',')
+				*c = '.';
+		}
+
+		double value = 0.0;
+		if (NumberParseDecimal(buffer, NULL, &value) != NULL && (float)value == weight)
+			break;
+	}
+
+	char* exponent_text = strchr(buffer, 'e');
+	if (exponent_text != NULL) // "%g" WRITES 100 AS 1e+02: THE SAME DIGITS WITHOUT EXPONENT ARE EASIER TO READ
+	{
+		int64_t exponent = 0;
+		int significant_digits = (int)(exponent_text - buffer) - (buffer[0] == '-') - (strchr(buffer, '.') != NULL); // THE DIGITS IN FRONT OF THE 'e
+		if (NumberParseInteger(exponent_text + 1 + (exponent_text[1] == '+'), NULL, &exponent) != NULL && exponent >= -6 && exponent < 16)
+		{
+			int decimals = (significant_digits - 1 - (int)exponent > 0) ? significant_digits - 1 - (int)exponent : 0;
+			length = snprintf(buffer, buffer_size, "%.*f", decimals, (double)weight);
+			for (char* c = buffer; *c != '\0'; ++c)
+			{
+				if (*c == ',')
+					*c = '.';
+			}
+		}
+	}
+	return length;
+}
+
+void ItemRequestAdd(ItemRequestList* list, char* file_path, uint32_t amount)
+{
+	if (list->count * 2 >= list->slot_count) // GROW AND REFILL THE HASH TABLE
+	{
+		uint32_t new_slot_count = (list->slot_count == 0) ? 256 : list->slot_count * 2;
+		uint32_t* new_slots = (uint32_t*)calloc(new_slot_count, sizeof(uint32_t));
+		if (new_slots == NULL)
+		{
+			printf("Failed to allocate memory for the item request list!\nExiting program!\n");
+			exit(2);
+		}
+
+		for (uint32_t number = 0; number < list->count; ++number)
+		{
+			char* path = list->paths + list->requests[number].path_offset;
+			uint32_t slot = (uint32_t)HashFnv1a(path, strlen(path), HASH_FNV1A_SEED) & (new_slot_count - 1);
+			while (new_slots[slot] != 0)
+				slot = (slot + 1) & (new_slot_count - 1);
+			new_slots[slot] = number + 1;
+		}
+
+		free(list->slots);
+		list->slots = new_slots;
+		list->slot_count = new_slot_count;
+	}
+
+	uint32_t path_length = (uint32_t)strlen(file_path);
+	uint32_t slot = (uint32_t)HashFnv1a(file_path, path_length, HASH_FNV1A_SEED) & (list->slot_count - 1);
+	while (list->slots[slot] != 0)
+	{
+		ItemRequest* request = &(list->requests[list->slots[slot] - 1]);
+		if (strcmp(list->paths + request->path_offset, file_path) == 0) // ALREADY REQUESTED: ONE PARSE FOR ALL COPIES
+		{
+			request->amount = (amount > UINT32_MAX - request->amount) ? UINT32_MAX : request->amount + amount;
+			return;
+		}
+		slot = (slot + 1) & (list->slot_count - 1);
+	}
+
+	if (list->count == list->capacity) // GROW THE REQUEST ARRAY
+	{
+		uint32_t new_capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+		ItemRequest* new_requests = (ItemRequest*)realloc(list->requests, new_capacity * sizeof(ItemRequest));
+		if (new_requests == NULL)
+		{
+			printf("Failed to allocate memory for the item request list!\nExiting program!\n");
+			exit(2);
+		}
+		list->requests = new_requests;
+		list->capacity = new_capacity;
+	}
+
+	ItemRequest* request = &(list->requests[list->count]);
+	request->path_offset = list->paths_length;
+	request->amount = amount;
+	BufferAppend(&(list->paths), &(list->paths_length), &(list->paths_capacity), file_path, path_length + 1);
+	list->slots[slot] = ++(list->count);
+}
+
+bool ItemArgumentAdd(Inventory* inventory, char* argument, uint32_t amount, bool is_quiet)
+{
+	// "Items_JSON/greatsword.json" IS "greatsword.json": A PATH COMPLETED BY THE SHELL WORKS TOO
+	size_t folder_name_length = sizeof(ITEM_FOLDER_NAME) - 1;
+	if (strncmp(argument, ITEM_FOLDER_NAME, folder_name_length) == 0 && (argument[folder_name_length] == '/' || argument[folder_name_length] == '\\'))
+		argument += folder_name_length + 1;
+
+	char json_item_full_path[FILE_PATH_BUFFER_MAX + 1];
+	if (strpbrk(argument, "*?") == NULL) // ONE JSON FILE
+	{
+		size_t json_filename_len = strlen(argument);
+		if (json_filename_len < 6 || strcmp(argument + json_filename_len - 5, ".json") != 0)
+		{
+			printf("Entered unknown command: %s => this command is ignored!\n", argument);
+			return false;
+		}
+
+		int snprintf_ret = snprintf(json_item_full_path, sizeof json_item_full_path, "%s" PATH_SEPARATOR "%s", ITEM_FOLDER_NAME, argument);
+		if (snprintf_ret < 0 || snprintf_ret >= sizeof json_item_full_path)
+		{
+			printf("Full json item path name of %s is to long! Item is ignored!\n", argument);
+			return false;
+		}
+
+		if (PackFind(&item_pack, json_item_full_path) == NULL && !ItemFolderContains(argument))
+		{
+			printf("%s does not exist! Item is ignored!\n", argument);
+			return false;
+		}
+
+		ItemRequestAdd(&(inventory->item_requests), json_item_full_path, amount);
+		if (!is_quiet)
+			printf("File %s exists\nItem amount to add: %u\n", json_item_full_path, amount);
+		return true;
+	}
+
+	// GLOB PATTERN: WITH --pack THE FILES OF THE PACK ARE MATCHED, ELSE THE FILES OF THE ITEM FOLDER
+	uint32_t match_count = 0;
+	uint32_t file_count = (item_pack.is_open) ? item_pack.header.entry_count : 0;
+	if (!item_pack.is_open)
+	{
+		ItemFolderListLoad();
+		file_count = item_folder_files.count;
+	}
+
+	for (uint32_t i = 0; i < file_count; ++i) // IN FILE NAME ORDER
+	{
+		char* file_name = (item_pack.is_open) ? item_pack.string_pool + item_pack.entries[item_pack.file_name_order[i]].file_name_offset : item_folder_files.file_names[i];
+		if (!GlobMatch(argument, file_name))
+			continue;
+
+		int snprintf_ret = snprintf(json_item_full_path, sizeof json_item_full_path, "%s" PATH_SEPARATOR "%s", ITEM_FOLDER_NAME, file_name);
+		if (snprintf_ret < 0 || snprintf_ret >= sizeof json_item_full_path)
+		{
+			printf("Full json item path name of %s is to long! Item is ignored!\n", file_name);
+			continue;
+		}
+
+		ItemRequestAdd(&(inventory->item_requests), json_item_full_path, amount);
+		++match_count;
+	}
+
+	if (match_count == 0)
+	{
+		printf("No json file matches %s! Pattern is ignored!\n", argument);
+		return false;
+	}
+
+	if (!is_quiet)
+		printf("Pattern %s matches %u json files, item amount to add: %u each\n", argument, match_count, amount);
+	return true;
+}
+
+void ItemResponseFileRead(Inventory* inventory, char* file_path)
+{
+	FILE* file = StatsFileOpen(file_path, "rb");
+	if (file == NULL)
+	{
+		printf("Response file %s can't be opened! Its items are ignored!\n", file_path);
+		return;
+	}
+	TRACE_BEGIN("ItemResponseFileRead", file_path);
+
+	static char chunk[RESPONSE_FILE_CHUNK]; // ONLY THE MAIN THREAD PARSES THE ARGUMENTS
+	char token[FILE_PATH_BUFFER_MAX + 1];
+	char pending_item[FILE_PATH_BUFFER_MAX + 1]; // THE ITEM OF THE PREVIOUS TOKEN: THE NEXT TOKEN CAN BE ITS AMOUNT
+	uint32_t token_length = 0;
+	bool is_token_too_long = false;
+	bool is_comment = false;
+	bool has_pending_item = false;
+	bool is_end_of_file = false;
+	uint32_t argument_count = 0;
+	uint32_t ignored_count = 0;
+	uint32_t request_count = inventory->item_requests.count;
+
+	while (!is_end_of_file)
+	{
+		size_t chunk_length = StatsFileRead(chunk, 1, sizeof chunk, file);
+		if (chunk_length == 0) // THE END OF THE FILE ENDS THE LAST TOKEN LIKE A NEW LINE
+		{
+			chunk[0] = '\n';
+			chunk_length = 1;
+			is_end_of_file = true;
+		}
+
+		for (size_t i = 0; i < chunk_length; ++i)
+		{
+			char c = chunk[i];
+			if (is_comment)
+			{
+				is_comment = (c != '\n');
+				continue;
+			}
+
+			if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+			{
+				if (c == '#' && token_length == 0 && !is_token_too_long) // COMMENT UNTIL THE END OF THE LINE
+					is_comment = true;
+				else if (token_length < sizeof(token) - 1)
+					token[token_length++] = c;
+				else
+					is_token_too_long = true;
+				continue;
+			}
+
+			if (token_length == 0 && !is_token_too_long)
+				continue;
+
+			// A WHOLE TOKEN: AN AMOUNT FOR THE PENDING ITEM, OR THE NEXT ITEM
+			token[token_length] = '\0';
+			uint32_t amount = 1;
+			++argument_count;
+			if (is_token_too_long)
+			{
+				printf("Argument %.20s... in %s is too long! It is ignored!\n", token, file_path);
+				++ignored_count;
+			}
+			else if (ItemAmountParse(token, &amount))
+			{
+				if (has_pending_item)
+					ignored_count += !ItemArgumentAdd(inventory, pending_item, amount, true);
+				else
+				{
+					printf("Amount %s in %s doesn't follow an item! It is ignored!\n", token, file_path);
+					++ignored_count;
+				}
+				has_pending_item = false;
+			}
+			else
+			{
+				if (has_pending_item)
+					ignored_count += !ItemArgumentAdd(inventory, pending_item, 1, true);
+				memcpy(pending_item, token, token_length + 1);
+				has_pending_item = true;
+			}
+			token_length = 0;
+			is_token_too_long = false;
+		}
+	}
+
+	if (has_pending_item)
+		ignored_count += !ItemArgumentAdd(inventory, pending_item, 1, true);
+
+	TRACE_END("ItemResponseFileRead");
+	StatsFileClose(file);
+	printf("Response file %s: %u arguments, %u ignored, %u new json files to load.\n", file_path, argument_count, ignored_count, inventory->item_requests.count - request_count);
+}
+
+bool ItemAmountParse(const char* token, uint32_t* amount)
+{
+	int64_t value = 0;
+	const char* number_end = NumberParseInteger(token, NULL, &value);
+	if (number_end == NULL || *number_end != '\0' || value < 1 || value > UINT32_MAX)
+		return false;
+	*amount = (uint32_t)value;
+	return true;
+}
+
+bool GlobMatch(const char* pattern, const char* name)
+{
+	const char* star = NULL;       // THE LAST '*' OF THE PATTERN, A MISMATCH AFTER IT LETS THE STAR TAKE ONE MORE CHAR
+	const char* star_name = NULL;
+	while (*name != '\0')
+	{
+		if (*pattern == '*')
+		{
+			star = pattern++;
+			star_name = name;
+		}
+		else if (*pattern == '?' || *pattern == *name)
+		{
+			++pattern;
+			++name;
+		}
+		else if (star != NULL)
+		{
+			pattern = star + 1;
+			name = ++star_name;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	while (*pattern == '*')
+		++pattern;
+	return *pattern == '\0';
+}
+
+void ItemFolderListLoad(void)
+{
+	if (is_item_folder_listed)
+		return;
+	is_item_folder_listed = true;
+
+	TRACE_BEGIN("ItemFolderListLoad", ITEM_FOLDER_NAME);
+	if (!ItemFolderScan(PackBuildAddFile, &item_folder_files))
+		printf("Item folder %s can't be read!\n", ITEM_FOLDER_NAME);
+	qsort(item_folder_files.file_names, item_folder_files.count, sizeof(item_folder_files.file_names[0]), ItemFolderCompareFileName);
+	TRACE_END("ItemFolderListLoad");
+}
+
+bool ItemFolderContains(char* file_name)
+{
+	ItemFolderListLoad();
+
+	uint32_t low = 0;
+	uint32_t high = item_folder_files.count;
+	while (low < high)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		int compare = strcmp(file_name, item_folder_files.file_names[middle]);
+		if (compare == 0)
+			return true;
+		else if (compare < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return false;
+}
+
+int ItemFolderCompareFileName(const void* file_name_a, const void* file_name_b)
+{
+	return strcmp((const char*)file_name_a, (const char*)file_name_b);
+}
+
+Item* JsonParse(char* file_path, uint8_t parse_flags)
+{
+	if (file_path)
+	{
+		TRACE_BEGIN("JsonParse", file_path);
+		uint64_t start_ns = StatsTimeNs();
+		bool is_quiet = (parse_flags & JSON_PARSE_QUIET) != 0;
+		if (!is_quiet)
+			printf("Parsing file: %s\n", file_path);
+
+		int64_t file_size = -1;
+		int64_t file_mtime = 0;
+		bool has_file_status = false;
+		ParseCacheEntry* cache_entry = NULL;
+		PackEntry* pack_entry = PackFind(&item_pack, file_path);
+		if (pack_entry == NULL) // THE PARSE CACHE IS ONLY FOR THE FILES IN THE ITEM FOLDER: A PACK ENTRY IS ONE SEEK AND ONE READ
+		{
+			has_file_status = ParseCacheFileStatus(file_path, &file_size, &file_mtime);
+			cache_entry = ParseCacheFind(file_path);
+		}
+
+		Item* item = NULL;
+		if (cache_entry && has_file_status && cache_entry->file_size == file_size && cache_entry->file_mtime == file_mtime) // UNCHANGED SINCE IT WAS CACHED: THE FILE ISN'T EVEN OPENED
+		{
+			item = ParseCacheItemCreate(cache_entry);
+			++(runtime_stats.parse_cache_hits);
+		}
+		else if (pack_entry)
+		{
+			item = ItemCreate();
+			if (!PackLoadSource(&item_pack, pack_entry, item))
+			{
+				printf("Failed to read %s from the pack %s.\n", item_pack.string_pool + pack_entry->file_name_offset, item_pack.file_name);
+				exit(3);
+			}
+
+			JsonParseString(item->source, 0, item->source_length, item, JSON_PARSE_EAGER | (parse_flags & JSON_PARSE_QUIET)); // EAGER PASS: ONLY THE FIELDS NEEDED BY ItemPush
+
+			++(runtime_stats.json_files_parsed);
+			runtime_stats.json_bytes_parsed += item->source_length;
+		}
+		else
+		{
+			item = ItemCreate();
+			if (!ItemLoadSource(item, file_path))
+			{
+				printf((json_mmap_enabled) ? "Failed to map file.\n" : "Failed to open file.\n");
+				exit(3);
+			}
+
+			uint64_t content_hash = HashFnv1a(item->source, item->source_length, HASH_FNV1A_SEED);
+			if (cache_entry && cache_entry->file_size == item->source_length && cache_entry->content_hash == content_hash) // ONLY THE MTIME CHANGED (A COPY OR A CHECKOUT): THE CACHED VIEWS POINT INTO THIS SAME TEXT
+			{
+				item->index = cache_entry->index;
+				item->name = cache_entry->name;
+				item->weight = cache_entry->weight;
+				item->money = cache_entry->money;
+				item->details_offset = (long)cache_entry->details_offset;
+
+				cache_entry->file_mtime = file_mtime;
+				parse_cache.is_dirty = true;
+				++(runtime_stats.parse_cache_content_hits);
+			}
+			else
+			{
+				if (!is_quiet)
+					printf("Scanning file for the index.\n");
+				// printf("%.*s\n", (int)item->source_length, item->source); // PRINT THE FULL JSON STRING
+
+				JsonParseString(item->source, 0, item->source_length, item, JSON_PARSE_EAGER | (parse_flags & JSON_PARSE_QUIET)); // EAGER PASS: ONLY THE FIELDS NEEDED BY ItemPush
+
+				++(runtime_stats.json_files_parsed);
+				runtime_stats.json_bytes_parsed += item->source_length;
+				++(runtime_stats.parse_cache_misses);
+				if (has_file_status)
+					ParseCacheStore(file_path, file_mtime, content_hash, item);
+			}
+		}
+
+		snprintf(item->file_name, sizeof(item->file_name), "%s", file_path); // REMEMBER THE FILE TO DECODE THE DETAILS FROM WHEN THEY ARE NEEDED
+		StatsRecordLatency(&(runtime_stats.json_parse_latency), start_ns);
+		TRACE_END("JsonParse");
+		return item;
+	}
+	else
+	{
+		printf("Failed to parse json file. File path is NULL.\n");
+		exit(3);
+	}
+}
+
+char* JsonLoadFile(char* file_path, long* file_length)
+{
+	FILE* file = StatsFileOpen(file_path, "rb"); // BINARY MODE: THE DETAILS OFFSET MUST BE A REAL BYTE OFFSET IN THE FILE, ALSO ON WINDOWS
+	if (file == NULL)
+		return NULL;
+
+	StatsFileSeek(file, 0, SEEK_END);
+	long length = StatsFileTell(file);
+	StatsFileSeek(file, 0, SEEK_SET);
+
+	char* file_buffer = (char*)malloc(length + 1); // THE BUFFER HAS THE SIZE OF THE FILE: NO LIMIT ON THE LENGTH OF THE NAME OR THE URL
+	if (file_buffer == NULL)
+	{
+		printf("Failed to allocate memory for the json file %s!\nExiting program!\n", file_path);
+		exit(2);
+	}
+
+	*file_length = (long)StatsFileRead(file_buffer, 1, length, file);
+	file_buffer[*file_length] = '\0';
+
+	StatsFileClose(file);
+	return file_buffer;
+}
+
+FileMapping* FileMappingOpen(char* file_path)
+{
+	for (FileMapping* mapping = file_mappings; mapping; mapping = mapping->next) // THE SAME FILE CAN BE PARSED AGAIN WHEN THE USER ADDS THE SAME ITEM (N COMMAND)
+	{
+		if (strcmp(mapping->file_name, file_path) == 0)
+			return mapping;
+	}
+
+	char* data = NULL;
+	long length = 0;
+
+	++(runtime_stats.file_opens);
+#ifdef _WIN32 // Windows system
+	HANDLE file_handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		++(runtime_stats.file_open_failures);
+		return NULL;
+	}
+
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0) // AN EMPTY FILE CAN'T BE MAPPED
+	{
+		HANDLE mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping_handle)
+		{
+			data = (char*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+			length = (long)file_size.QuadPart;
+			CloseHandle(mapping_handle); // THE VIEW KEEPS THE MAPPING ALIVE
+		}
+	}
+	CloseHandle(file_handle);
+#else // Linux system
+	int file_descriptor = open(file_path, O_RDONLY);
+	if (file_descriptor == -1)
+	{
+		++(runtime_stats.file_open_failures);
+		return NULL;
+	}
+
+	struct stat file_status;
+	if (fstat(file_descriptor, &file_status) == 0 && file_status.st_size > 0) // AN EMPTY FILE CAN'T BE MAPPED
+	{
+		void* map_address = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		if (map_address != MAP_FAILED)
+		{
+			data = (char*)map_address;
+			length = (long)file_status.st_size;
+		}
+	}
+	close(file_descriptor); // THE MAPPING STAYS VALID AFTER THE FILE IS CLOSED
+#endif
+	++(runtime_stats.file_closes);
+
+	if (data == NULL)
+		return NULL;
+
+	FileMapping* mapping = (FileMapping*)calloc(1, sizeof(FileMapping));
+	if (mapping == NULL)
+	{
+		printf("Failed to allocate memory for the file mapping!\nExiting program!\n");
+		exit(2);
+	}
+
+	snprintf(mapping->file_name, sizeof(mapping->file_name), "%s", file_path);
+	mapping->data = data;
+	mapping->length = length;
+	mapping->next = file_mappings;
+	file_mappings = mapping;
+
+	++(runtime_stats.file_maps);
+	runtime_stats.file_bytes_mapped += length;
+
+	return mapping;
+}
+
+bool ItemLoadSource(Item* item, char* file_path)
+{
+	if (json_mmap_enabled) // MAP THE FILE: THE ITEM STRINGS POINT INTO THE MAPPING, NO BYTES ARE COPIED
+	{
+		FileMapping* mapping = FileMappingOpen(file_path);
+		if (mapping == NULL)
+			return false;
+
+		item->mapping = mapping;
+		item->source = mapping->data;
+		item->source_length = mapping->length;
+	}
+	else                   // READ THE WHOLE FILE INTO ONE BUFFER THAT IS OWNED BY THE ITEM
+	{
+		long source_length = 0;
+		char* source = JsonLoadFile(file_path, &source_length);
+		if (source == NULL)
+			return false;
+
+		item->mapping = NULL;
+		item->source = source;
+		item->source_length = source_length;
+		StatsItemBytesAdd(item->source_length + 1);
+	}
+
+	return true;
+}
+
+uint64_t HashFnv1a(const char* data, size_t length, uint64_t hash)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= (uint8_t)data[i];
+		hash *= HASH_FNV1A_PRIME;
+	}
+	return hash;
+}
+
+void BufferAppend(char** buffer, uint32_t* length, uint32_t* capacity, const void* data, uint32_t size)
+{
+	if (*length + size > *capacity)
+	{
+		uint32_t new_capacity = (*capacity == 0) ? 4096 : *capacity;
+		while (*length + size > new_capacity)
+			new_capacity *= 2;
+
+		char* new_buffer = (char*)realloc(*buffer, new_capacity);
+		if (new_buffer == NULL)
+		{
+			printf("Failed to allocate memory for a buffer!\nExiting program!\n");
+			exit(2);
+		}
+		*buffer = new_buffer;
+		*capacity = new_capacity;
+	}
+
+	memcpy(*buffer + *length, data, size);
+	*length += size;
+}
+
+bool ItemFolderScan(void (*add_file)(void* context, char* file_name), void* context)
+{
+#ifdef _WIN32 // Windows system
+	struct _finddata_t find_data;
+	intptr_t find_handle = _findfirst(ITEM_FOLDER_NAME PATH_SEPARATOR "*.json", &find_data);
+	if (find_handle == -1)
+		return false;
+
+	do
+	{
+		++(runtime_stats.directory_reads);
+		add_file(context, find_data.name);
+	}
+	while (_findnext(find_handle, &find_data) == 0);
+
+	_findclose(find_handle);
+#else // Linux system
+	DIR* directory = opendir(ITEM_FOLDER_NAME);
+	if (directory == NULL)
+		return false;
+
+	struct dirent* directory_entry = NULL;
+	while ((directory_entry = readdir(directory)) != NULL)
+	{
+		++(runtime_stats.directory_reads);
+		size_t file_name_len = strlen(directory_entry->d_name);
+		if (file_name_len > 5 && strcmp(directory_entry->d_name + file_name_len - 5, ".json") == 0)
+			add_file(context, directory_entry->d_name);
+	}
+
+	closedir(directory);
+#endif
+
+	return true;
+}
+
+void ParseCacheInit(char* executable_path)
+{
+	// THE CACHE FILE IS PUT NEXT TO THE EXECUTABLE: KEEP THE DIRECTORY PART OF argv[0]
+	char* separator = strrchr(executable_path, '/');
+#ifdef _WIN32 // Windows system
+	char* backslash = strrchr(executable_path, '\\');
+	if (backslash > separator)
+		separator = backslash;
+#endif
+	int directory_length = (separator) ? (int)(separator - executable_path + 1) : 0; // NO SEPARATOR: THE EXECUTABLE WAS STARTED FROM THE CURRENT DIRECTORY OR FOUND IN THE PATH
+
+	int snprintf_ret = snprintf(parse_cache_file_name, sizeof parse_cache_file_name, "%.*s%s", directory_length, executable_path, PARSE_CACHE_FILE_NAME);
+	if (snprintf_ret < 0 || snprintf_ret >= sizeof parse_cache_file_name)
+		snprintf(parse_cache_file_name, sizeof parse_cache_file_name, "%s", PARSE_CACHE_FILE_NAME);
+
+	ParseCacheLoad(parse_cache_file_name);
+}
+
+ParseCacheEntry* ParseCacheFind(char* file_path)
+{
+	if (parse_cache.slot_count == 0)
+		return NULL;
+
+	uint32_t slot = (uint32_t)HashFnv1a(file_path, strlen(file_path), HASH_FNV1A_SEED) & (parse_cache.slot_count - 1);
+	while (parse_cache.slots[slot] != 0)
+	{
+		ParseCacheEntry* entry = &(parse_cache.entries[parse_cache.slots[slot] - 1]);
+		if (strcmp(entry->file_name, file_path) == 0)
+			return entry;
+		slot = (slot + 1) & (parse_cache.slot_count - 1);
+	}
+	return NULL;
+}
+
+bool ParseCacheFileStatus(char* file_path, int64_t* file_size, int64_t* file_mtime)
+{
+	++(runtime_stats.file_access_checks);
+#ifdef _WIN32 // Windows system
+	struct _stat64 file_status;
+	if (_stat64(file_path, &file_status) != 0)
+		return false;
+#else // Linux system
+	struct stat file_status;
+	if (stat(file_path, &file_status) != 0)
+		return false;
+#endif
+
+	*file_size = (int64_t)file_status.st_size;
+#ifdef _WIN32 // Windows system
+	*file_mtime = (int64_t)file_status.st_mtime * 1000000000; // ONLY SECONDS: A CHANGE WITH THE SAME SIZE IN THE SAME SECOND IS ONLY NOTICED BY A CONTENT HASH
+#else // Linux system
+	*file_mtime = (int64_t)file_status.st_mtim.tv_sec * 1000000000 + file_status.st_mtim.tv_nsec;
+#endif
+	return true;
+}
+
+ParseCacheEntry* ParseCacheAddEntry(char* file_path)
+{
+	if (parse_cache.entry_count * 2 >= parse_cache.slot_count) // GROW AND REFILL THE HASH TABLE
+	{
+		uint32_t new_slot_count = (parse_cache.slot_count == 0) ? 256 : parse_cache.slot_count * 2;
+		uint32_t* new_slots = (uint32_t*)calloc(new_slot_count, sizeof(uint32_t));
+		if (new_slots == NULL)
+		{
+			printf("Failed to allocate memory for the parse cache!\nExiting program!\n");
+			exit(2);
+		}
+
+		for (uint32_t number = 0; number < parse_cache.entry_count; ++number)
+		{
+			char* path = parse_cache.entries[number].file_name;
+			uint32_t slot = (uint32_t)HashFnv1a(path, strlen(path), HASH_FNV1A_SEED) & (new_slot_count - 1);
+			while (new_slots[slot] != 0)
+				slot = (slot + 1) & (new_slot_count - 1);
+			new_slots[slot] = number + 1;
+		}
+
+		free(parse_cache.slots);
+		parse_cache.slots = new_slots;
+		parse_cache.slot_count = new_slot_count;
+	}
+
+	if (parse_cache.entry_count == parse_cache.entry_capacity) // GROW THE ENTRY ARRAY
+	{
+		uint32_t new_capacity = (parse_cache.entry_capacity == 0) ? 64 : parse_cache.entry_capacity * 2;
+		ParseCacheEntry* new_entries = (ParseCacheEntry*)realloc(parse_cache.entries, new_capacity * sizeof(ParseCacheEntry));
+		if (new_entries == NULL)
+		{
+			printf("Failed to allocate memory for the parse cache!\nExiting program!\n");
+			exit(2);
+		}
+		parse_cache.entries = new_entries;
+		parse_cache.entry_capacity = new_capacity;
+	}
+
+	ParseCacheEntry* entry = &(parse_cache.entries[parse_cache.entry_count]);
+	memset(entry, 0, sizeof(ParseCacheEntry));
+	snprintf(entry->file_name, sizeof(entry->file_name), "%s", file_path);
+
+	uint32_t slot = (uint32_t)HashFnv1a(entry->file_name, strlen(entry->file_name), HASH_FNV1A_SEED) & (parse_cache.slot_count - 1);
+	while (parse_cache.slots[slot] != 0)
+		slot = (slot + 1) & (parse_cache.slot_count - 1);
+	parse_cache.slots[slot] = ++(parse_cache.entry_count);
+	return entry;
+}
+
+void ParseCacheStore(char* file_path, int64_t file_mtime, uint64_t content_hash, Item* item)
+{
+	if (strlen(file_path) >= sizeof(parse_cache.entries[0].file_name))
+		return;
+
+	ParseCacheEntry* entry = ParseCacheFind(file_path);
+	if (entry == NULL)
+		entry = ParseCacheAddEntry(file_path);
+
+	char* strings = (char*)malloc(item->index.length + item->name.length + 1);
+	if (strings == NULL)
+	{
+		printf("Failed to allocate memory for the parse cache!\nExiting program!\n");
+		exit(2);
+	}
+	memcpy(strings, item->source + item->index.offset, item->index.length);
+	memcpy(strings + item->index.length, item->source + item->name.offset, item->name.length);
+
+	free(entry->strings); // THE FILE CHANGED: THE OLD STRINGS ARE REPLACED
+	entry->strings = strings;
+	entry->file_size = item->source_length;
+	entry->file_mtime = file_mtime;
+	entry->content_hash = content_hash;
+	entry->weight = item->weight;
+	entry->money = item->money;
+	entry->details_offset = item->details_offset;
+	entry->index = item->index;
+	entry->name = item->name;
+
+	parse_cache.is_dirty = true;
+}
+
+Item* ParseCacheItemCreate(ParseCacheEntry* entry)
+{
+	Item* item = ItemCreate();
+
+	// THE SOURCE ONLY HOLDS THE INDEX AND THE NAME: THE JSON FILE IS NOT OPENED UNTIL THE DETAILS ARE NEEDED
+	uint32_t strings_length = entry->index.length + entry->name.length;
+	item->source = (char*)malloc(strings_length + 1);
+	if (item->source == NULL)
+	{
+		printf("Failed to allocate memory for a new Item!\nExiting program!\n");
+		exit(2);
+	}
+	memcpy(item->source, entry->strings, strings_length);
+	item->source[strings_length] = '\0';
+	item->source_length = strings_length;
+	item->is_source_cached = true;
+	StatsItemBytesAdd(strings_length + 1);
+
+	item->index.offset = 0;
+	item->index.length = entry->index.length;
+	item->name.offset = entry->index.length;
+	item->name.length = entry->name.length;
+	item->weight = entry->weight;
+	item->money = entry->money;
+	item->details_offset = (long)entry->details_offset;
+
+	return item;
+}
+
+bool ParseCacheRead(const char* payload, uint32_t payload_size, uint32_t* position, void* data, uint32_t size)
+{
+	if (size > payload_size - *position) // NEVER READ PAST THE PAYLOAD, WHATEVER THE LENGTHS IN A CORRUPTED FILE SAY
+		return false;
+
+	memcpy(data, payload + *position, size);
+	*position += size;
+	return true;
+}
+
+void ParseCacheLoad(char* cache_path)
+{
+	long file_length = 0;
+	char* file_buffer = JsonLoadFile(cache_path, &file_length);
+	if (file_buffer == NULL) // NO CACHE YET: IT IS WRITTEN WHEN THE PROGRAM QUITS
+		return;
+
+	bool is_valid = false;
+	ParseCacheHeader header = { { 0 } };
+	if (file_length >= (long)sizeof header)
+	{
+		memcpy(&header, file_buffer, sizeof header);
+		is_valid = memcmp(header.magic, PARSE_CACHE_MAGIC, sizeof header.magic) == 0 && header.version == PARSE_CACHE_VERSION
+			&& header.payload_size == file_length - sizeof header
+			&& header.payload_hash == HashFnv1a(file_buffer + sizeof header, header.payload_size, HASH_FNV1A_SEED);
+	}
+
+	const char* payload = file_buffer + sizeof header;
+	uint32_t position = 0;
+	for (uint32_t i = 0; is_valid && i < header.entry_count; ++i)
+	{
+		ParseCacheEntry entry = { 0 };
+		uint16_t path_length = 0;
+		int32_t coins[3];
+
+		is_valid = ParseCacheRead(payload, header.payload_size, &position, &path_length, sizeof path_length)
+			&& path_length < sizeof entry.file_name
+			&& ParseCacheRead(payload, header.payload_size, &position, entry.file_name, path_length)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.file_size), sizeof entry.file_size)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.file_mtime), sizeof entry.file_mtime)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.content_hash), sizeof entry.content_hash)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.weight), sizeof entry.weight)
+			&& ParseCacheRead(payload, header.payload_size, &position, coins, sizeof coins)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.details_offset), sizeof entry.details_offset)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.index), sizeof entry.index)
+			&& ParseCacheRead(payload, header.payload_size, &position, &(entry.name), sizeof entry.name);
+
+		// THE VIEWS AND THE DETAILS OFFSET MUST LIE IN THE FILE THEY DESCRIBE
+		is_valid = is_valid && entry.file_size >= 0
+			&& entry.index.length <= entry.file_size && entry.index.offset <= entry.file_size - entry.index.length
+			&& entry.name.length <= entry.file_size && entry.name.offset <= entry.file_size - entry.name.length
+			&& entry.details_offset >= 0 && entry.details_offset <= entry.file_size
+			&& entry.weight >= 0.0f && entry.index.length <= header.payload_size - position && entry.name.length <= header.payload_size - position - entry.index.length;
+		if (!is_valid)
+			break;
+
+		entry.file_name[path_length] = '\0';
+		entry.money.gp = coins[0];
+		entry.money.sp = coins[1];
+		entry.money.cp = coins[2];
+		entry.strings = (char*)malloc(entry.index.length + entry.name.length + 1);
+		if (entry.strings == NULL)
+		{
+			printf("Failed to allocate memory for the parse cache!\nExiting program!\n");
+			exit(2);
+		}
+		ParseCacheRead(payload, header.payload_size, &position, entry.strings, entry.index.length + entry.name.length);
+
+		*ParseCacheAddEntry(entry.file_name) = entry;
+	}
+
+	if (is_valid && position != header.payload_size) // BYTES AFTER THE LAST ENTRY
+		is_valid = false;
+
+	if (is_valid)
+	{
+		printf("Parse cache %s: %u json files cached.\n", cache_path, parse_cache.entry_count);
+	}
+	else // A CORRUPTED CACHE IS NEVER PARTLY USED: EVERY FILE IS PARSED AGAIN AND A NEW CACHE IS WRITTEN
+	{
+		printf("Parse cache %s is corrupted or from another version, every json file is parsed again.\n", cache_path);
+		for (uint32_t i = 0; i < parse_cache.entry_count; ++i)
+			free(parse_cache.entries[i].strings);
+		parse_cache.entry_count = 0;
+		if (parse_cache.slot_count > 0)
+			memset(parse_cache.slots, 0, parse_cache.slot_count * sizeof(uint32_t));
+		parse_cache.is_dirty = true;
+	}
+
+	free(file_buffer);
+}
+
+void ParseCacheSave(char* cache_path)
+{
+	if (!parse_cache.is_dirty)
+		return;
+
+	char* payload = NULL;
+	uint32_t payload_size = 0;
+	uint32_t payload_capacity = 0;
+	for (uint32_t i = 0; i < parse_cache.entry_count; ++i)
+	{
+		ParseCacheEntry* entry = &(parse_cache.entries[i]);
+		uint16_t path_length = (uint16_t)strlen(entry->file_name);
+		int32_t coins[3] = { entry->money.gp, entry->money.sp, entry->money.cp };
+
+		BufferAppend(&payload, &payload_size, &payload_capacity, &path_length, sizeof path_length);
+		BufferAppend(&payload, &payload_size, &payload_capacity, entry->file_name, path_length);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->file_size), sizeof entry->file_size);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->file_mtime), sizeof entry->file_mtime);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->content_hash), sizeof entry->content_hash);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->weight), sizeof entry->weight);
+		BufferAppend(&payload, &payload_size, &payload_capacity, coins, sizeof coins);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->details_offset), sizeof entry->details_offset);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->index), sizeof entry->index);
+		BufferAppend(&payload, &payload_size, &payload_capacity, &(entry->name), sizeof entry->name);
+		BufferAppend(&payload, &payload_size, &payload_capacity, entry->strings, entry->index.length + entry->name.length);
+	}
+
+	ParseCacheHeader header = { { 0 } };
+	memcpy(header.magic, PARSE_CACHE_MAGIC, sizeof header.magic);
+	header.version = PARSE_CACHE_VERSION;
+	header.entry_count = parse_cache.entry_count;
+	header.payload_size = payload_size;
+	header.payload_hash = HashFnv1a(payload, payload_size, HASH_FNV1A_SEED);
+
+	// WRITE A TEMPORARY FILE FIRST: A PROGRAM THAT STOPS HALFWAY NEVER LEAVES A HALF WRITTEN CACHE BEHIND
+	char temp_path[FILE_PATH_BUFFER_MAX + 5];
+	snprintf(temp_path, sizeof temp_path, "%s.tmp", cache_path);
+	FILE* file = fopen(temp_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to write the parse cache to %s.\n", temp_path);
+		free(payload);
+		return;
+	}
+
+	bool is_written = fwrite(&header, sizeof header, 1, file) == 1 && (payload_size == 0 || fwrite(payload, payload_size, 1, file) == 1);
+	is_written = (fclose(file) == 0) && is_written;
+	free(payload);
+
+	remove(cache_path); // rename() DOESN'T REPLACE AN EXISTING FILE ON WINDOWS
+	if (!is_written || rename(temp_path, cache_path) != 0)
+	{
+		printf("Failed to write the parse cache to %s.\n", cache_path);
+		remove(temp_path);
+		return;
+	}
+
+	parse_cache.is_dirty = false;
+}
+
+bool PackBuild(char* pack_path, bool is_compressed)
+{
+	PackFileList file_list = { 0 };
+	if (!ItemFolderScan(PackBuildAddFile, &file_list))
+	{
+		printf("Failed to open the folder %s. No pack is written.\n", ITEM_FOLDER_NAME);
+		return false;
+	}
+
+	FILE* file = fopen(pack_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to create the pack %s.\n", pack_path);
+		free(file_list.file_names);
+		return false;
+	}
+
+	PackEntry* entries = (PackEntry*)calloc(file_list.count + 1, sizeof(PackEntry));
+	uint32_t* file_name_order = (uint32_t*)calloc(file_list.count + 1, sizeof(uint32_t));
+	if (entries == NULL || file_name_order == NULL)
+	{
+		printf("Failed to allocate memory for the pack table!\nExiting program!\n");
+		exit(2);
+	}
+
+	PackHeader header = { { 0 } };
+	bool is_written = fwrite(&header, sizeof header, 1, file) == 1; // PLACEHOLDER: THE HEADER IS WRITTEN AGAIN WHEN THE TABLE OFFSET IS KNOWN
+
+	char* string_pool = NULL;
+	uint32_t string_pool_size = 0;
+	uint32_t string_pool_capacity = 0;
+	char* compressed = NULL;
+	uint32_t compressed_capacity = 0;
+	uint32_t entry_count = 0;
+	uint64_t data_offset = sizeof header;
+	uint64_t json_bytes = 0;
+
+	for (uint32_t i = 0; is_written && i < file_list.count; ++i)
+	{
+		char* file_name = file_list.file_names[i];
+		char json_item_full_path[FILE_PATH_BUFFER_MAX + 1];
+		snprintf(json_item_full_path, sizeof json_item_full_path, "%s" PATH_SEPARATOR "%s", ITEM_FOLDER_NAME, file_name);
+
+		long file_length = 0;
+		char* source = JsonLoadFile(json_item_full_path, &file_length);
+		if (source == NULL)
+		{
+			printf("Failed to read %s, item is not packed!\n", json_item_full_path);
+			continue;
+		}
+
+		Item item = { 0 };   // ONLY USED TO COLLECT THE INDEX AND NAME FOR THE TABLE
+		item.weight = -1.0f;
+		item.source = source;
+		item.source_length = file_length;
+		JsonParseString(source, 0, file_length, &item, JSON_PARSE_EAGER | JSON_PARSE_QUIET);
+
+		if (item.index.length == 0 || item.index.length > UINT16_MAX || item.name.length > UINT16_MAX || (uint64_t)file_length > UINT32_MAX)
+		{
+			printf("%s has no index or is too large, item is not packed!\n", json_item_full_path);
+			free(source);
+			continue;
+		}
+
+		PackEntry* entry = &(entries[entry_count++]);
+		entry->data_offset = data_offset;
+		entry->length = (uint32_t)file_length;
+
+		const char* stored = source;
+		entry->stored_length = entry->length;
+		if (is_compressed && entry->length > 1)
+		{
+			if (compressed_capacity < entry->length)
+			{
+				char* new_compressed = (char*)realloc(compressed, entry->length);
+				if (new_compressed == NULL)
+				{
+					printf("Failed to allocate memory for the pack compression!\nExiting program!\n");
+					exit(2);
+				}
+				compressed = new_compressed;
+				compressed_capacity = entry->length;
+			}
+
+			uint32_t compressed_length = PackCompress(source, entry->length, compressed, entry->length - 1); // ONLY USED WHEN IT IS SMALLER
+			if (compressed_length > 0)
+			{
+				stored = compressed;
+				entry->stored_length = compressed_length;
+				entry->flags = PACK_ENTRY_COMPRESSED;
+			}
+		}
+
+		entry->index_offset = string_pool_size;
+		entry->index_length = (uint16_t)item.index.length;
+		BufferAppend(&string_pool, &string_pool_size, &string_pool_capacity, source + item.index.offset, item.index.length);
+		BufferAppend(&string_pool, &string_pool_size, &string_pool_capacity, "", 1);
+		entry->name_offset = string_pool_size;
+		entry->name_length = (uint16_t)item.name.length;
+		BufferAppend(&string_pool, &string_pool_size, &string_pool_capacity, source + item.name.offset, item.name.length);
+		BufferAppend(&string_pool, &string_pool_size, &string_pool_capacity, "", 1);
+		entry->file_name_offset = string_pool_size;
+		entry->file_name_length = (uint16_t)strlen(file_name);
+		BufferAppend(&string_pool, &string_pool_size, &string_pool_capacity, file_name, entry->file_name_length + 1);
+
+		is_written = fwrite(stored, 1, entry->stored_length, file) == entry->stored_length;
+		data_offset += entry->stored_length;
+		json_bytes += entry->length;
+		free(source);
+	}
+
+	// SORT THE TABLE BY INDEX AND THE ORDER BY FILE NAME: THE READER FINDS AN ITEM WITH A BINARY SEARCH
+	pack_sort_pool = string_pool;
+	qsort(entries, entry_count, sizeof(PackEntry), PackCompareIndex);
+	for (uint32_t i = 0; i < entry_count; ++i)
+		file_name_order[i] = i;
+	pack_sort_entries = entries;
+	qsort(file_name_order, entry_count, sizeof(uint32_t), PackCompareFileName);
+
+	memcpy(header.magic, PACK_MAGIC, sizeof header.magic);
+	header.version = PACK_VERSION;
+	header.entry_count = entry_count;
+	header.string_pool_size = string_pool_size;
+	header.table_offset = data_offset;
+	header.table_hash = HashFnv1a((const char*)entries, entry_count * sizeof(PackEntry), HASH_FNV1A_SEED);
+	header.table_hash = HashFnv1a((const char*)file_name_order, entry_count * sizeof(uint32_t), header.table_hash);
+	header.table_hash = HashFnv1a(string_pool, string_pool_size, header.table_hash);
+
+	is_written = is_written && fwrite(entries, sizeof(PackEntry), entry_count, file) == entry_count
+		&& fwrite(file_name_order, sizeof(uint32_t), entry_count, file) == entry_count
+		&& fwrite(string_pool, 1, string_pool_size, file) == string_pool_size
+		&& fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof header, 1, file) == 1;
+	is_written = (fclose(file) == 0) && is_written;
+
+	if (is_written)
+	{
+		printf("Pack %s: %u items, %llu bytes of json text stored in %llu bytes.\n", pack_path, entry_count, (unsigned long long)json_bytes, (unsigned long long)data_offset);
+	}
+	else
+	{
+		printf("Failed to write the pack %s.\n", pack_path);
+		remove(pack_path); // NEVER LEAVE A HALF WRITTEN PACK BEHIND
+	}
+
+	free(compressed);
+	free(string_pool);
+	free(file_name_order);
+	free(entries);
+	free(file_list.file_names);
+	return is_written;
+}
+
+void PackBuildAddFile(void* context, char* file_name)
+{
+	PackFileList* file_list = (PackFileList*)context;
+	if (strlen(file_name) >= sizeof(file_list->file_names[0]))
+	{
+		printf("File name %s is too long, item is not packed!\n", file_name);
+		return;
+	}
+
+	if (file_list->count == file_list->capacity) // GROW THE FILE NAME ARRAY
+	{
+		uint32_t new_capacity = (file_list->capacity == 0) ? 64 : file_list->capacity * 2;
+		char (*new_file_names)[100] = realloc(file_list->file_names, new_capacity * sizeof(file_list->file_names[0]));
+		if (new_file_names == NULL)
+		{
+			printf("Failed to allocate memory for the pack file list!\nExiting program!\n");
+			exit(2);
+		}
+		file_list->file_names = new_file_names;
+		file_list->capacity = new_capacity;
+	}
+
+	strcpy(file_list->file_names[file_list->count++], file_name);
+}
+
+int PackCompareIndex(const void* entry_a, const void* entry_b)
+{
+	return strcmp(pack_sort_pool + ((const PackEntry*)entry_a)->index_offset, pack_sort_pool + ((const PackEntry*)entry_b)->index_offset);
+}
+
+int PackCompareFileName(const void* number_a, const void* number_b)
+{
+	return strcmp(pack_sort_pool + pack_sort_entries[*(const uint32_t*)number_a].file_name_offset, pack_sort_pool + pack_sort_entries[*(const uint32_t*)number_b].file_name_offset);
+}
+
+bool PackOpen(ItemPack* pack, char* pack_path)
+{
+	int snprintf_ret = snprintf(pack->file_name, sizeof(pack->file_name), "%s", pack_path);
+	if (snprintf_ret < 0 || snprintf_ret >= sizeof(pack->file_name))
+	{
+		printf("Pack file name %s is too long. Items are read from the folder %s.\n", pack_path, ITEM_FOLDER_NAME);
+		return false;
+	}
+
+	FILE* file = StatsFileOpen(pack_path, "rb");
+	if (file == NULL)
+	{
+		printf("Failed to open the pack %s. Items are read from the folder %s.\n", pack_path, ITEM_FOLDER_NAME);
+		return false;
+	}
+
+	StatsFileSeek(file, 0, SEEK_END);
+	long file_length = StatsFileTell(file);
+	StatsFileSeek(file, 0, SEEK_SET);
+
+	PackHeader header = { { 0 } };
+	bool is_valid = file_length >= (long)sizeof header && StatsFileRead(&header, sizeof header, 1, file) == 1
+		&& memcmp(header.magic, PACK_MAGIC, sizeof header.magic) == 0 && header.version == PACK_VERSION
+		&& header.table_offset >= sizeof header && header.table_offset <= (uint64_t)file_length
+		&& (uint64_t)file_length - header.table_offset == (uint64_t)header.entry_count * (sizeof(PackEntry) + sizeof(uint32_t)) + header.string_pool_size;
+
+	// ONE READ FOR ALL TABLES: THE JSON FILES ARE ONLY READ WHEN AN ITEM NEEDS THEM
+	char* tables = NULL;
+	if (is_valid)
+	{
+		size_t tables_size = (size_t)(file_length - header.table_offset);
+		tables = (char*)malloc(tables_size + 1);
+		if (tables == NULL)
+		{
+			printf("Failed to allocate memory for the pack table!\nExiting program!\n");
+			exit(2);
+		}
+
+		is_valid = StatsFileSeek(file, (long)header.table_offset, SEEK_SET) == 0 && StatsFileRead(tables, 1, tables_size, file) == tables_size
+			&& HashFnv1a(tables, tables_size, HASH_FNV1A_SEED) == header.table_hash;
+	}
+
+	if (is_valid)
+	{
+		pack->header = header;
+		pack->entries = (PackEntry*)tables;
+		pack->file_name_order = (uint32_t*)(tables + header.entry_count * sizeof(PackEntry));
+		pack->string_pool = tables + header.entry_count * (sizeof(PackEntry) + sizeof(uint32_t));
+	}
+
+	for (uint32_t i = 0; is_valid && i < header.entry_count; ++i) // THE ENTRIES MUST LIE IN THE PACK, WHATEVER A CORRUPTED TABLE SAYS
+	{
+		PackEntry* entry = &(pack->entries[i]);
+		is_valid = entry->data_offset >= sizeof header && entry->data_offset <= header.table_offset && entry->stored_length <= header.table_offset - entry->data_offset
+			&& (entry->flags & ~PACK_ENTRY_COMPRESSED) == 0 && ((entry->flags & PACK_ENTRY_COMPRESSED) || entry->stored_length == entry->length)
+			&& PackCheckString(pack, entry->index_offset, entry->index_length) && PackCheckString(pack, entry->name_offset, entry->name_length)
+			&& PackCheckString(pack, entry->file_name_offset, entry->file_name_length) && pack->file_name_order[i] < header.entry_count;
+	}
+
+	if (!is_valid)
+	{
+		printf("Pack %s is corrupted or from another version. Items are read from the folder %s.\n", pack_path, ITEM_FOLDER_NAME);
+		free(tables);
+		StatsFileClose(file);
+		memset(pack, 0, sizeof(ItemPack));
+		return false;
+	}
+
+	pack->file = file;
+	pack->is_open = true;
+	printf("Item pack %s: %u items.\n", pack_path, header.entry_count);
+	return true;
+}
+
+void PackClose(ItemPack* pack)
+{
+	if (!pack->is_open)
+		return;
+
+	StatsFileClose(pack->file);
+	free(pack->entries);
+	memset(pack, 0, sizeof(ItemPack)); // THE MAPPING STAYS: ITEMS CAN STILL POINT INTO IT
+}
+
+bool PackCheckString(ItemPack* pack, uint32_t offset, uint16_t length)
+{
+	return offset < pack->header.string_pool_size && length < pack->header.string_pool_size - offset && pack->string_pool[offset + length] == '\0';
+}
+
+PackEntry* PackFind(ItemPack* pack, char* file_path)
+{
+	if (!pack->is_open)
+		return NULL;
+
+	// ONLY THE FILE NAME COUNTS: "Items_JSON/greatsword.json" AND "greatsword.json" ARE THE SAME ENTRY
+	char* file_name = file_path;
+	for (char* c = file_path; *c != '\0'; ++c)
+	{
+		if (*c == '/' || *c == '\\')
+			file_name = c + 1;
+	}
+
+	uint32_t low = 0;
+	uint32_t high = pack->header.entry_count;
+	while (low < high) // BINARY SEARCH IN THE FILE NAME ORDER
+	{
+		uint32_t middle = low + (high - low) / 2;
+		PackEntry* entry = &(pack->entries[pack->file_name_order[middle]]);
+		int compare = strcmp(file_name, pack->string_pool + entry->file_name_offset);
+		if (compare == 0)
+			return entry;
+		else if (compare < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	size_t file_name_length = strlen(file_name);
+	if (file_name_length > 5 && strcmp(file_name + file_name_length - 5, ".json") == 0)
+		file_name_length -= 5;
+	char index[file_name_length + 1];
+	memcpy(index, file_name, file_name_length);
+	index[file_name_length] = '\0';
+
+	low = 0;
+	high = pack->header.entry_count;
+	while (low < high) // NO FILE WITH THIS NAME: BINARY SEARCH IN THE ENTRY TABLE FOR AN ITEM WITH THIS INDEX
+	{
+		uint32_t middle = low + (high - low) / 2;
+		PackEntry* entry = &(pack->entries[middle]);
+		int compare = strcmp(index, pack->string_pool + entry->index_offset);
+		if (compare == 0)
+			return entry;
+		else if (compare < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return NULL;
+}
+
+bool PackLoadSource(ItemPack* pack, PackEntry* entry, Item* item)
+{
+	if (json_mmap_enabled && pack->mapping == NULL) // MAPPED ON FIRST USE: --mmap CAN COME AFTER --pack ON THE COMMAND LINE
+		pack->mapping = FileMappingOpen(pack->file_name);
+
+	const char* stored = NULL;
+	if (pack->mapping)
+	{
+		if ((uint64_t)pack->mapping->length < entry->data_offset + entry->stored_length) // THE PACK CHANGED SINCE IT WAS OPENED
+			return false;
+
+		stored = pack->mapping->data + entry->data_offset;
+		if ((entry->flags & PACK_ENTRY_COMPRESSED) == 0) // THE ITEM STRINGS POINT INTO THE MAPPED PACK, NO BYTES ARE COPIED
+		{
+			item->mapping = pack->mapping;
+			item->source = (char*)stored;
+			item->source_length = entry->length;
+			++(runtime_stats.pack_entries_read);
+			return true;
+		}
+	}
+
+	char* source = (char*)malloc(entry->length + 1);
+	if (source == NULL)
+	{
+		printf("Failed to allocate memory for the json file %s!\nExiting program!\n", pack->string_pool + entry->file_name_offset);
+		exit(2);
+	}
+
+	bool is_read = false;
+	if (entry->flags & PACK_ENTRY_COMPRESSED)
+	{
+		char* compressed = NULL;
+		if (stored == NULL) // NOT MAPPED: READ THE COMPRESSED BYTES FIRST
+		{
+			compressed = (char*)malloc(entry->stored_length + 1);
+			if (compressed == NULL)
+			{
+				printf("Failed to allocate memory for the json file %s!\nExiting program!\n", pack->string_pool + entry->file_name_offset);
+				exit(2);
+			}
+			is_read = StatsFileSeek(pack->file, (long)entry->data_offset, SEEK_SET) == 0 && StatsFileRead(compressed, 1, entry->stored_length, pack->file) == entry->stored_length;
+			stored = compressed;
+		}
+		else
+		{
+			is_read = true;
+		}
+
+		is_read = is_read && PackDecompress(stored, entry->stored_length, source, entry->length);
+		if (is_read)
+			runtime_stats.pack_bytes_decompressed += entry->length;
+		free(compressed);
+	}
+	else
+	{
+		is_read = StatsFileSeek(pack->file, (long)entry->data_offset, SEEK_SET) == 0 && StatsFileRead(source, 1, entry->length, pack->file) == entry->length;
+	}
+
+	if (!is_read)
+	{
+		free(source);
+		return false;
+	}
+
+	source[entry->length] = '\0';
+	item->mapping = NULL;
+	item->source = source;
+	item->source_length = entry->length;
+	StatsItemBytesAdd(item->source_length + 1);
+	++(runtime_stats.pack_entries_read);
+	return true;
+}
+
+uint32_t PackCompress(const char* input, uint32_t length, char* output, uint32_t capacity)
+{
+	// LZ77: A CONTROL BYTE BELOW 0x80 IS FOLLOWED BY CONTROL + 1 LITERAL BYTES. ELSE IT IS A COPY OF CONTROL - 0x80 + PACK_MIN_MATCH BYTES
+	// FROM THE 16 BIT LITTLE ENDIAN DISTANCE BACK THAT FOLLOWS IT. THE ITEM FILES REPEAT THEIR KEYS, INDEXES AND URLS A LOT
+	uint32_t last_positions[1 << PACK_HASH_BITS];
+	for (uint32_t i = 0; i < (1 << PACK_HASH_BITS); ++i)
+		last_positions[i] = UINT32_MAX;
+
+	uint32_t position = 0;
+	uint32_t literal_start = 0;
+	uint32_t output_length = 0;
+	while (position + PACK_MIN_MATCH <= length)
+	{
+		uint32_t sequence;
+		memcpy(&sequence, input + position, sizeof sequence);
+		uint32_t hash = (sequence * 2654435761u) >> (32 - PACK_HASH_BITS);
+		uint32_t candidate = last_positions[hash];
+		last_positions[hash] = position;
+
+		if (candidate == UINT32_MAX || position - candidate > PACK_MAX_DISTANCE || memcmp(input + candidate, input + position, PACK_MIN_MATCH) != 0)
+		{
+			++position;
+			continue;
+		}
+
+		uint32_t match_length = PACK_MIN_MATCH;
+		while (position + match_length < length && match_length < PACK_MAX_MATCH && input[candidate + match_length] == input[position + match_length])
+			++match_length;
+
+		if (!PackWriteLiterals(input + literal_start, position - literal_start, output, &output_length, capacity) || capacity - output_length < 3)
+			return 0;
+
+		uint32_t distance = position - candidate;
+		output[output_length++] = (char)(0x80 | (match_length - PACK_MIN_MATCH));
+		output[output_length++] = (char)(distance & 0xFF);
+		output[output_length++] = (char)(distance >> 8);
+
+		position += match_length;
+		literal_start = position;
+	}
+
+	if (!PackWriteLiterals(input + literal_start, length - literal_start, output, &output_length, capacity))
+		return 0;
+	return output_length;
+}
+
+bool PackWriteLiterals(const char* literals, uint32_t literal_count, char* output, uint32_t* output_length, uint32_t capacity)
+{
+	while (literal_count > 0)
+	{
+		uint32_t run = (literal_count < PACK_MAX_LITERALS) ? literal_count : PACK_MAX_LITERALS;
+		if (capacity - *output_length < run + 1) // DOESN'T FIT: THE ENTRY IS STORED UNCOMPRESSED
+			return false;
+
+		output[(*output_length)++] = (char)(run - 1);
+		memcpy(output + *output_length, literals, run);
+		*output_length += run;
+		literals += run;
+		literal_count -= run;
+	}
+	return true;
+}
+
+bool PackDecompress(const char* input, uint32_t stored_length, char* output, uint32_t length)
+{
+	uint32_t position = 0;
+	uint32_t output_length = 0;
+	while (position < stored_length)
+	{
+		uint8_t control = (uint8_t)input[position++];
+		if (control < 0x80) // LITERALS
+		{
+			uint32_t run = control + 1;
+			if (run > stored_length - position || run > length - output_length)
+				return false;
+
+			memcpy(output + output_length, input + position, run);
+			position += run;
+			output_length += run;
+		}
+		else                // COPY FROM EARLIER OUTPUT, THE COPY CAN OVERLAP ITSELF
+		{
+			if (stored_length - position < 2)
+				return false;
+
+			uint32_t match_length = (control & 0x7F) + PACK_MIN_MATCH;
+			uint32_t distance = (uint8_t)input[position] | ((uint32_t)(uint8_t)input[position + 1] << 8);
+			position += 2;
+			if (distance == 0 || distance > output_length || match_length > length - output_length)
+				return false;
+
+			for (uint32_t i = 0; i < match_length; ++i, ++output_length)
+				output[output_length] = output[output_length - distance];
+		}
+	}
+
+	return output_length == length;
+}
+
+uint8_t JsonClassifyKey(const char* key, uint32_t key_length)
+{
+	// THE LENGTH AND THE FIRST BYTE SELECT THE ONLY KNOWN KEY THAT CAN MATCH, ONE memcmp CONFIRMS IT
+	switch (key_length)
+	{
+	case 3:
+		if (key[0] == 'u' && memcmp(key, "url", 3) == 0)
+			return JSON_KEY_URL;
+		break;
+	case 4:
+		switch (key[0])
+		{
+		case 'c': return (memcmp(key, "cost", 4) == 0) ? JSON_KEY_COST : JSON_KEY_UNKNOWN;
+		case 'n': return (memcmp(key, "name", 4) == 0) ? JSON_KEY_NAME : JSON_KEY_UNKNOWN;
+		case 'u': return (memcmp(key, "unit", 4) == 0) ? JSON_KEY_UNIT : JSON_KEY_UNKNOWN;
+		}
+		break;
+	case 5:
+		if (key[0] == 'i' && memcmp(key, "index", 5) == 0)
+			return JSON_KEY_INDEX;
+		break;
+	case 6:
+		if (key[0] == 'w' && memcmp(key, "weight", 6) == 0)
+			return JSON_KEY_WEIGHT;
+		break;
+	case 8:
+		if (key[0] == 'q' && memcmp(key, "quantity", 8) == 0)
+			return JSON_KEY_QUANTITY;
+		break;
+	case 18:
+		if (key[0] == 'e' && memcmp(key, "equipment_category", 18) == 0)
+			return JSON_KEY_EQUIPMENT_CATEGORY;
+		break;
+	}
+
+	return JSON_KEY_UNKNOWN;
+}
+
+void JsonParseString(char* json_string, long json_start, long json_end, Item* item, uint8_t parse_flags)
+{
+	bool parse_details = (parse_flags & JSON_PARSE_DETAILS) != 0;
+	bool is_quiet = (parse_flags & JSON_PARSE_QUIET) != 0;
+	char* buffer_pointer = json_string + json_start; // POINTER TO TRAVERSE THE JSON STRING WITH
+	char* buffer_end = json_string + json_end;       // A MAPPED FILE ISN'T '\0' TERMINATED: THE LENGTH IS THE ONLY END MARKER
+
+	// NESTING STATE: levels[depth] IS THE OBJECT OR ARRAY THE PARSER IS IN, levels[1] IS THE MAIN OBJECT
+	JsonLevel levels[JSON_PARSE_MAX_DEPTH] = { 0 };
+	uint32_t depth = 0; // EVERY LEVEL IS COUNTED, ALSO PAST JSON_PARSE_MAX_DEPTH: THE PARSER IS BACK IN THE MAIN OBJECT AFTER ANY NESTING
+	if (json_start > 0) // THE DETAILS PASS STARTS AT A KEY OF THE MAIN OBJECT
+	{
+		depth = 1;
+		levels[1].key = JSON_KEY_UNKNOWN;
+		levels[1].is_array = false;
+	}
+	bool is_value_expected = false; // false: THE NEXT STRING IN AN OBJECT IS A KEY
+	uint8_t current_key = JSON_KEY_UNKNOWN;
+	StringView key = { 0 };
+
+	// COST OBJECT: THE AMOUNT AND THE UNIT CAN BE IN ANY ORDER, THE MONEY IS SET WHEN THE OBJECT CLOSES
+	int coin_amount = 0;
+	StringView money_unit = { 0 };
+	bool is_cost_parsed = false;
+
+	char* number_start = NULL; // NUMBER VALUES ARE PARSED IN PLACE WHEN THEY END
+
+	bool is_details_offset_found = false; // THE FIRST url OR equipment_category KEY MARKS WHERE THE DETAILS PARSE HAS TO START
+
+	while (buffer_pointer < buffer_end)
+	{
+		if (!parse_details && item->index.length != 0 && item->name.length != 0 && item->weight >= 0.0f && is_cost_parsed) // THE EAGER PASS STOPS AS SOON AS EVERY FIELD NEEDED BY ItemPush IS KNOWN
+			break;
+
+		char c = *buffer_pointer;
+
+		if (number_start != NULL && (c == ',' || c == '}' || c == ']')) // THE END OF A NUMBER VALUE
+		{
+			char* number_end = buffer_pointer;
+			while (number_end > number_start && isspace((unsigned char)*(number_end - 1)))
+				--number_end;
+
+			if (!parse_details && depth == 1 && current_key == JSON_KEY_WEIGHT)
+			{
+				double weight = 0.0;
+				if (NumberParseDecimal(number_start, number_end, &weight) != NULL && weight >= 0.0 && weight <= FLT_MAX)
+					item->weight = (float)weight;
+			}
+			else if (!parse_details && depth == 2 && levels[2].key == JSON_KEY_COST && current_key == JSON_KEY_QUANTITY)
+			{
+				int64_t amount = 0;
+				if (NumberParseInteger(number_start, number_end, &amount) != NULL && amount >= 0 && amount <= INT32_MAX)
+					coin_amount = (int)amount;
+				if (!is_quiet)
+					printf("Coin amount is found: %d.\n", coin_amount);
+			}
+
+			if (!is_quiet)
+				printf("Key: %.*s, Value: %.*s\n", (int)key.length, json_string + key.offset, (int)(number_end - number_start), number_start);
+			number_start = NULL;
+		}
+
+		switch (c)
+		{
+		case '"':
+		{
+			char* string_start = ++buffer_pointer;
+			while (buffer_pointer < buffer_end && *buffer_pointer != '"')
+			{
+				if (*buffer_pointer == '\\' && buffer_pointer + 1 < buffer_end) // AN ESCAPED QUOTE DOESN'T END THE STRING. THE VIEW KEEPS THE ESCAPE SEQUENCES AS THEY ARE
+					++buffer_pointer;
+				++buffer_pointer;
+			}
+			StringView string = { (uint32_t)(string_start - json_string), (uint32_t)(buffer_pointer - string_start) }; // THE STRING IS NOT COPIED: ONLY ITS POSITION IN THE JSON STRING IS KEPT
+
+			if (!is_value_expected) // KEY
+			{
+				key = string;
+				current_key = JsonClassifyKey(string_start, string.length);
+
+				if (!parse_details && !is_details_offset_found && depth == 1 && (current_key == JSON_KEY_URL || current_key == JSON_KEY_EQUIPMENT_CATEGORY))
+				{
+					item->details_offset = (string_start - 1) - json_string; // OFFSET OF THE OPENING QUOTE OF THE KEY
+					is_details_offset_found = true;
+				}
+			}
+			else if (depth == 1)   // VALUE OF THE MAIN OBJECT
+			{
+				if (!parse_details && current_key == JSON_KEY_INDEX && item->index.length == 0)
+					item->index = string;
+				else if (!parse_details && current_key == JSON_KEY_NAME && item->name.length == 0)
+					item->name = string;
+				else if (parse_details && current_key == JSON_KEY_URL)
+					item->url = string;
+			}
+			else if (depth == 2)   // VALUE OF AN OBJECT IN THE MAIN OBJECT
+			{
+				if (parse_details && levels[2].key == JSON_KEY_EQUIPMENT_CATEGORY && current_key == JSON_KEY_INDEX)
+					item->equipment_category = string;
+				else if (!parse_details && levels[2].key == JSON_KEY_COST && current_key == JSON_KEY_UNIT)
+					money_unit = string;
+			}
+
+			if (is_value_expected && !is_quiet)
+				printf("Key: %.*s, Value: %.*s\n", (int)key.length, json_string + key.offset, (int)string.length, string_start);
+			break;
+		}
+		case ':':               // KEY VALUE DELIMITER :
+			is_value_expected = true;
+			break;
+		case ',':               // KEY VALUE PAIR DELIMITER , : IN AN OBJECT A KEY FOLLOWS, IN AN ARRAY A VALUE FOLLOWS
+		{
+			bool is_array = depth < JSON_PARSE_MAX_DEPTH && levels[depth].is_array; // A LEVEL PAST JSON_PARSE_MAX_DEPTH ISN'T TRACKED: IT NEVER HOLDS AN ITEM FIELD
+			is_value_expected = is_array;
+			if (!is_array)
+				current_key = JSON_KEY_UNKNOWN;
+			break;
+		}
+		case '{':               // OBJECT OPENING {
+		case '[':               // ARRAY OPENING [
+		{
+			bool is_member = depth > 0 && depth < JSON_PARSE_MAX_DEPTH && !levels[depth].is_array; // THE VALUE OF A KEY, NOT AN ELEMENT OF AN ARRAY
+			if (c == '{' && is_member && !is_quiet)
+				printf("Object Key: %.*s\n", (int)key.length, json_string + key.offset);
+
+			if (depth < UINT32_MAX)
+				++depth;
+			if (depth < JSON_PARSE_MAX_DEPTH) // DEEPER LEVELS ARE ONLY COUNTED: THEY NEVER HOLD AN ITEM FIELD
+			{
+				levels[depth].key = is_member ? current_key : JSON_KEY_UNKNOWN;
+				levels[depth].is_array = (c == '[');
+			}
+			is_value_expected = (c == '[');
+			current_key = JSON_KEY_UNKNOWN;
+			break;
+		}
+		case '}':               // OBJECT CLOSING }
+		case ']':               // ARRAY CLOSING ]
+			if (depth == 2 && levels[2].key == JSON_KEY_COST && !parse_details) // THE COST OBJECT IS COMPLETE
+			{
+				if (money_unit.length == 2 && memcmp(json_string + money_unit.offset, "gp", 2) == 0)
+					item->money.gp = coin_amount;
+				else if (money_unit.length == 2 && memcmp(json_string + money_unit.offset, "sp", 2) == 0)
+					item->money.sp = coin_amount;
+				else if (money_unit.length == 2 && memcmp(json_string + money_unit.offset, "cp", 2) == 0)
+					item->money.cp = coin_amount;
+				if (!is_quiet)
+					printf("Money unit is found: %.*s.\n", (int)money_unit.length, json_string + money_unit.offset);
+				is_cost_parsed = true;
+			}
+
+			if (depth > 0)
+				--depth;
+			if (depth + 1 < JSON_PARSE_MAX_DEPTH) // THE CONTAINER IS THE VALUE OF THE KEY THAT OPENED IT: THE PARENT GOES ON AFTER IT
+			{
+				is_value_expected = levels[depth].is_array;
+				current_key = (depth > 0 && !levels[depth].is_array) ? levels[depth + 1].key : JSON_KEY_UNKNOWN;
+			}
+			break;
+		default:
+			if (is_value_expected && number_start == NULL && (isdigit(c) || c == '-'))
+				number_start = buffer_pointer; // NUMBER VALUE: NOTHING IS COPIED, IT IS PARSED FROM THE JSON TEXT WHEN IT ENDS
+			break; // WHITESPACE, true, false AND null
+		}
+
+		++buffer_pointer;
+	}
+	// printf("End of json string reached. %d chars read.\n", char_count);
+
+	if (!parse_details && !is_details_offset_found) // NO DETAILS KEY SEEN YET: THE DETAILS CAN ONLY BE IN THE PART THAT ISN'T PARSED
+		item->details_offset = buffer_pointer - json_string;
+
+	if (!parse_details && buffer_pointer >= buffer_end && item->weight < 0.0f) // THE WHOLE FILE IS PARSED WITHOUT A WEIGHT KEY: THE ITEM WEIGHS NOTHING
+		item->weight = 0.0f;
+}
+
+ItemList* ItemListCreate(Item* new_item) 
+{
+	ItemList* items = new_item; // The head of the list
+	items->next = items;        // Point the head to itself
+	items->prev = items;
+
+	return items;
+}
+
+Item* ItemCreate(/*char* index*/)
+{
+	Item* item = (Item*)calloc(1, sizeof(Item));
+
+	if (item)
+	{
+		item->weight = -1.0f;
+
+		++(runtime_stats.items_created);
+		++(runtime_stats.items_live);
+		StatsItemBytesAdd(sizeof(Item));
+
+		// item->index = index;
+		return item;
+	}
+	else
+	{
+		printf("Failed to allocate memory for a new Item!\nExiting program!\n");
+		exit(2);
+	}
+}
+
+void InventoryAppendStack(Inventory* inventory, Item* item)
+{
+	if (inventory->items)
+	{
+		Item* head = inventory->items;
+		Item* temp = head->prev;   // The current last item of the list
+
+		item->prev = temp;         // Point the previous pointer of the newly pushed item to the previously last item.
+		item->next = head;         // Point the next pointer of the newly pushed item to the head.
+		temp->next = item;         // Point the previously last item to the newly pushed item.
+		head->prev = item;         // Point the previous pointer of the head to the newly pushed (last) item.
+	}
+	else // If the list is a NULL pointer, create a new list
+	{
+		inventory->items = ItemListCreate(item);
+	}
+
+	ItemHandleAssign(inventory, item);
+	++(inventory->stack_count);
+	InventoryIndexInsert(inventory, item);
+}
+
+void ItemPush(Inventory* inventory, Item* new_item, uint32_t amount, bool is_quiet) // Push copies of an item: a new index is added at the end of the list, an index that is already in the list gets a bigger quantity
+{
+	uint64_t start_ns = StatsTimeNs();
+	char trace_detail[TRACE_DETAIL_LENGTH];
+	TRACE_BEGIN("ItemPush", ItemCopyString(new_item, new_item->index, trace_detail, sizeof trace_detail));
+	if (!is_quiet)
+		printf("Pushing item: %.*s, amount: %u\n", ITEM_STRING_ARGS(new_item, index), amount);
+
+	if (inventory == NULL)
+	{
+		printf("inventory is NULL pointer!\n");
+		TRACE_END("ItemPush");
+		return;
+	}
+
+	// THE COPIES JOIN AN EXISTING STACK AT ITS PRICE AND WEIGHT, ALSO AFTER A V REPRICE: A POP REFUNDS EXACTLY WHAT THE PUSH CHARGED
+	Item* stack = InventoryFindItem(inventory, new_item->source + new_item->index.offset, new_item->index.length);
+	if (stack)
+	{
+		new_item->money = stack->money;
+		new_item->weight = stack->weight;
+	}
+
+	// CHECK HOW MANY COPIES FIT IN THE CARRYING CAPACITY AND THE MONEY THAT IS LEFT BEFORE ADDING => THE OTHER COPIES GET A WARNING AND ARE NOT ADDED
+	bool is_weight_limited = false;
+	uint32_t fit_amount = ItemFitAmount(inventory->max_weight, &(inventory->money), new_item, amount, &is_weight_limited);
+	int64_t item_cost_cp = convert_to_cp(&(new_item->money));
+	if (fit_amount < amount)
+	{
+		if (is_weight_limited)
+		{
+			printf("%u copies of item index %.*s can't be added to the inventory because they exceed the carrying capacity left. They are not included!\n", amount - fit_amount, ITEM_STRING_ARGS(new_item, index));
+			runtime_stats.push_rejects_weight += amount - fit_amount;
+		}
+		else
+		{
+			printf("Not enough money left to include %u copies of %.*s. They are not included!\n", amount - fit_amount, ITEM_STRING_ARGS(new_item, index));
+			runtime_stats.push_rejects_money += amount - fit_amount;
+		}
+	}
+
+	if (fit_amount == 0)
+	{
+		ItemFree(&new_item);
+		TRACE_END("ItemPush");
+		return;
+	}
+
+	inventory->max_weight -= new_item->weight * fit_amount;
+	if (!is_quiet)
+		printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
+
+	Money cost = convert_from_cp(item_cost_cp * (int64_t)fit_amount);
+	Money remaining;
+	subtract_money(&(inventory->money), &cost, &remaining); // CAN'T FAIL ANYMORE, THE MONEY CHECK IS DONE ABOVE
+	if (!is_quiet)
+	{
+		printf("Sufficient funds.\n");
+		printf("Remaining: %d gp, %d sp, %d cp\n", remaining.gp, remaining.sp, remaining.cp);
+	}
+	inventory->money = remaining;
+
+	if (stack) // THE INDEX IS ALREADY IN THE LIST: ONLY INCREASE ITS QUANTITY
+	{
+		stack->quantity += fit_amount;
+	}
+	else
+	{
+		new_item->quantity = fit_amount;
+		InventoryAppendStack(inventory, new_item);
+	}
+
+	inventory->item_count += fit_amount;
+	++(inventory->version);
+	InventoryLogChange(inventory, CHANGE_PUSH, new_item, fit_amount); // THE WEIGHT AND THE PRICE THAT WERE PAID: THOSE OF THE STACK WHEN IT WAS ALREADY THERE
+	if (stack) // THE NEW NODE ISN'T NEEDED
+		ItemFree(&new_item);
+
+	runtime_stats.items_pushed += fit_amount;
+	StatsRecordLatency(&(runtime_stats.push_latency), start_ns);
+	TRACE_END("ItemPush");
+}
+
+uint32_t ItemFitAmount(float max_weight, const Money* money, Item* item, uint32_t amount, bool* is_weight_limited)
+{
+	// WEIGHT CHECK
+	uint32_t weight_fit_amount = amount;
+	if (item->weight > 0.0f)
+	{
+		float weight_fit = max_weight / item->weight;
+		weight_fit_amount = (weight_fit <= 0.0f) ? 0 : (weight_fit >= (float)amount) ? amount : (uint32_t)weight_fit;
+
+		// THE DIVISION CAN BE OFF BY ONE COPY DUE TO FLOAT ROUNDING: USE THE SAME CHECK AS FOR A SINGLE COPY
+		while (weight_fit_amount < amount && (max_weight - item->weight * (weight_fit_amount + 1)) >= 0.0f)
+			++weight_fit_amount;
+		while (weight_fit_amount > 0 && (max_weight - item->weight * weight_fit_amount) < 0.0f)
+			--weight_fit_amount;
+	}
+	// MONEY CHECK
+	uint32_t money_fit_amount = amount;
+	int64_t item_cost_cp = convert_to_cp(&(item->money));
+	if (item_cost_cp > 0)
+	{
+		int64_t money_fit = convert_to_cp(money) / item_cost_cp;
+		money_fit_amount = (money_fit >= amount) ? amount : (uint32_t)money_fit;
+	}
+
+	*is_weight_limited = (weight_fit_amount <= money_fit_amount);
+	return (weight_fit_amount < money_fit_amount) ? weight_fit_amount : money_fit_amount;
+}
+
+void ItemPop(Inventory* inventory, char* index, uint32_t amount) // Pop copies of the chosen item, the item is removed from the list when its last copy is popped
+{
+	uint64_t start_ns = StatsTimeNs();
+	TRACE_BEGIN("ItemPop", index);
+
+	if (inventory == NULL)
+	{
+		printf("inventory is NULL pointer!\n");
+		TRACE_END("ItemPop");
+		return;
+	}
+
+	uint32_t item_count = InventoryGetItemCount(inventory);
+	if(item_count == 0)
+	{
+		printf("items list is empty! (NULL pointer)\n");
+		++(runtime_stats.pop_rejects_empty);
+		TRACE_END("ItemPop");
+		return;
+	}
+
+	Item* stack = InventoryFindItem(inventory, index, (uint32_t)strlen(index)); // CHECK IF THE LIST CONTAINS THE GIVEN INDEX TO POP
+	if (stack == NULL)
+	{
+		// NOTIFY THE PLAYER IF THE INDEX IS NOT FOUND
+		printf("Index: %s is not found in the list!\n\r", index);
+		++(runtime_stats.pop_rejects_not_found);
+		TRACE_END("ItemPop");
+		return;
+	}
+
+	ItemPopStack(inventory, stack, amount, false);
+	StatsRecordLatency(&(runtime_stats.pop_latency), start_ns);
+	TRACE_END("ItemPop");
+}
+
+uint32_t ItemPopHandle(Inventory* inventory, ItemHandle handle, uint32_t amount, bool is_quiet)
+{
+	uint64_t start_ns = StatsTimeNs();
+	Item* stack = ItemHandleGet(inventory, handle);
+	if (stack == NULL) // THE STACK WAS REMOVED SINCE THE HANDLE WAS TAKEN: NOTHING TO POP
+	{
+		++(runtime_stats.pop_rejects_not_found);
+		return 0;
+	}
+
+	uint32_t popped = ItemPopStack(inventory, stack, amount, is_quiet);
+	StatsRecordLatency(&(runtime_stats.pop_latency), start_ns);
+	return popped;
+}
+
+uint32_t ItemPopStack(Inventory* inventory, Item* stack, uint32_t amount, bool is_quiet)
+{
+	if (amount > stack->quantity)
+		amount = stack->quantity;
+
+	// INCREASE THE CARRYING CAPACITY WITH THE WEIGHT OF THE POPPED COPIES
+	inventory->max_weight += stack->weight * amount;
+	// INCREASE IVENTORY MONEY
+	Money refund = convert_from_cp(convert_to_cp(&(stack->money)) * (int64_t)amount);
+	inventory->money = convert_from_cp(convert_to_cp(&(inventory->money)) + convert_to_cp(&refund));
+	if (!is_quiet)
+	{
+		printf("Popping item: %.*s, amount: %u\n", ITEM_STRING_ARGS(stack, index), amount);
+		printf("Inventory carrying capacity left: %.2f\n", inventory->max_weight);
+		printf("Adding money back\n");
+	}
+
+	stack->quantity -= amount;
+	inventory->item_count -= amount;          // DECREASE THE ITEM COUNT WHEN A 'TO POPPED' INDEX IS FOUND
+	++(inventory->version);
+	InventoryLogChange(inventory, CHANGE_POP, stack, amount);
+
+	if (stack->quantity == 0) // THE LAST COPY IS POPPED: THE STACK BECOMES A TOMBSTONE. ITS LINKS STAY VALID, SO A WALK OVER THE LIST CAN KEEP GOING FROM IT
+	{
+		stack->is_removed = true;
+		--(inventory->stack_count);
+		++(inventory->removed_count);
+		++(runtime_stats.stacks_removed);
+	}
+
+	runtime_stats.items_popped += amount;
+	return amount;
+}
+
+void ItemFree(Item** item)
+{
+	if (*item)
+	{
+		++(runtime_stats.items_freed);
+		--(runtime_stats.items_live);
+		runtime_stats.item_bytes_live -= sizeof(Item) + (((*item)->mapping || (*item)->source == NULL) ? 0 : (*item)->source_length + 1);
+
+		if ((*item)->mapping == NULL) // A MAPPED FILE IS SHARED BY EVERY ITEM PARSED FROM IT AND STAYS MAPPED
+			free((*item)->source);
+		free(*item);
+		*item = NULL;
+	}
+}
+
+void ItemLoadDetails(Item* item, bool is_quiet)
+{
+	if (item->is_details_loaded)  // ALREADY DECODED BEFORE: THE VIEWS ARE SET
+		return;
+
+	if (item->is_source_cached)   // THE ITEM COMES FROM THE PARSE CACHE: LOAD THE JSON TEXT NOW AND POINT THE INDEX AND NAME VIEWS INTO IT
+	{
+		char* cached_source = item->source;
+		long cached_length = item->source_length;
+		if (!ItemLoadSource(item, item->file_name))
+		{
+			printf("Failed to open file %s. Item details aren't available.\n", item->file_name);
+			return;
+		}
+		free(cached_source);
+		runtime_stats.item_bytes_live -= cached_length + 1;
+		item->is_source_cached = false;
+
+		float weight = item->weight; // THE PUSHED VALUES STAY, ALSO WHEN THE FILE CHANGED SINCE: THE INVENTORY WEIGHT AND MONEY WERE CHANGED WITH THEM
+		Money money = item->money;
+		item->index.length = 0;
+		item->name.length = 0;
+		JsonParseString(item->source, 0, item->source_length, item, JSON_PARSE_EAGER | JSON_PARSE_QUIET);
+		item->weight = weight;
+		item->money = money;
+	}
+
+	if (item->source) // ONLY PARSE THE PART OF THE JSON TEXT THAT THE EAGER PASS DIDN'T NEED
+		JsonParseString(item->source, item->details_offset, item->source_length, item, JSON_PARSE_DETAILS | ((is_quiet) ? JSON_PARSE_QUIET : 0));
+
+	item->is_details_loaded = true;
+}
+
+char* ItemCopyString(Item* item, StringView string, char* buffer, size_t buffer_size)
+{
+	snprintf(buffer, buffer_size, "%.*s", (int)string.length, item->source + string.offset);
+	return buffer;
+}
+
+bool ItemIndexEquals(Item* item, const char* index, uint32_t index_length)
+{
+	return item->index.length == index_length && memcmp(item->source + item->index.offset, index, index_length) == 0;
+}
+
+void ItemPrintBasicInfo(Item* item)
+{
+	if (item)
+	{
+		char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+		NumberFormatWeight(item->weight, weight_text, sizeof weight_text);
+		printf("Index: %.*s\nName: %.*s\nQuantity: %u\nweight: %s\nMoney: %dgp, %dsp, %dcp.\n", ITEM_STRING_ARGS(item, index), ITEM_STRING_ARGS(item, name), item->quantity, weight_text, item->money.gp, item->money.sp, item->money.cp);
+	}
+	else
+		printf("List is empty.\n");
+}
+
+void ItemPrintAdvancedInfo(Item* item)
+{
+	if (item)
+	{
+		ItemLoadDetails(item, false);
+		printf("Item url: %.*s\nEquipment category: %.*s\n", ITEM_STRING_ARGS(item, url), ITEM_STRING_ARGS(item, equipment_category));
+	}
+	else
+		printf("List is empty.\n");
+}
+
+void ItemPrintList(InventorySnapshot* snapshot)
+{
+	if (snapshot->stack_count > 0)
+	{
+		for (uint32_t i = 0; i < snapshot->stack_count; ++i)
+		{
+			SnapshotRow* row = &(snapshot->rows[i]);
+			char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+			NumberFormatWeight(row->weight, weight_text, sizeof weight_text);
+			printf("Index: %.*s\nName: %.*s\nQuantity: %u\nweight: %s\nMoney: %dgp, %dsp, %dcp.\n\n", (int)row->index_length, snapshot->string_pool + row->index_offset,
+				(int)row->name_length, snapshot->string_pool + row->name_offset, row->quantity, weight_text, row->money.gp, row->money.sp, row->money.cp);
+		}
+	}
+	else
+	{
+		printf("List is empty.\n");
+	}
+}
+
+void ItemPrintJsonPathList(Inventory* inventory)
+{
+	printf("Printing json file paths:\n");
+	ItemRequestList* list = &(inventory->item_requests);
+	uint32_t path_amount = 0;
+	while (path_amount < list->count && path_amount < ITEM_REQUEST_PRINT_MAX)
+	{
+		printf("%s x%u\n", list->paths + list->requests[path_amount].path_offset, list->requests[path_amount].amount);
+		++path_amount;
+	}
+	if (path_amount < list->count)
+		printf("... and %u more json files\n", list->count - path_amount);
+	printf("\n");
+}
+
+Item* InventoryFindItem(Inventory* inventory, const char* index, uint32_t index_length)
+{
+	if (inventory->index_slot_count == 0)
+		return NULL;
+
+	uint32_t slot = (uint32_t)HashFnv1a(index, index_length, HASH_FNV1A_SEED) & (inventory->index_slot_count - 1);
+	while (inventory->index_slots[slot] != 0)
+	{
+		Item* item = inventory->slots[inventory->index_slots[slot] - 1].item;
+		if (!item->is_removed && ItemIndexEquals(item, index, index_length)) // A TOMBSTONE WITH THE SAME INDEX ISN'T PART OF THE INVENTORY ANYMORE
+			return item;
+		slot = (slot + 1) & (inventory->index_slot_count - 1);
+	}
+	return NULL;
+}
+
+void InventoryIndexInsert(Inventory* inventory, Item* item)
+{
+	uint32_t node_count = inventory->stack_count + inventory->removed_count;
+	if (node_count * 2 > inventory->index_slot_count) // GROW: THE REFILL FROM THE LIST ALREADY HOLDS THE NEW STACK
+	{
+		InventoryIndexRebuild(inventory, (inventory->index_slot_count == 0) ? 256 : inventory->index_slot_count * 2);
+		return;
+	}
+
+	uint32_t slot = (uint32_t)HashFnv1a(item->source + item->index.offset, item->index.length, HASH_FNV1A_SEED) & (inventory->index_slot_count - 1);
+	while (inventory->index_slots[slot] != 0)
+		slot = (slot + 1) & (inventory->index_slot_count - 1);
+	inventory->index_slots[slot] = item->handle.slot + 1;
+}
+
+void InventoryIndexRebuild(Inventory* inventory, uint32_t slot_count)
+{
+	uint32_t* new_slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+	if (new_slots == NULL)
+	{
+		printf("Failed to allocate memory for the item index table!\nExiting program!\n");
+		exit(2);
+	}
+
+	uint32_t node_count = inventory->stack_count + inventory->removed_count;
+	Item* item = inventory->items;
+	for (uint32_t i = 0; i < node_count; ++i, item = item->next)
+	{
+		uint32_t slot = (uint32_t)HashFnv1a(item->source + item->index.offset, item->index.length, HASH_FNV1A_SEED) & (slot_count - 1);
+		while (new_slots[slot] != 0)
+			slot = (slot + 1) & (slot_count - 1);
+		new_slots[slot] = item->handle.slot + 1;
+	}
+
+	free(inventory->index_slots);
+	inventory->index_slots = new_slots;
+	inventory->index_slot_count = slot_count;
+}
+
+Item* InventoryStep(Inventory* inventory, ItemHandle from, bool is_forward)
+{
+	if (inventory->stack_count == 0)
+		return NULL;
+
+	// A TOMBSTONE IS STILL LINKED: THE STEP STARTS FROM IT. A FREED STACK STARTS AT THE FIRST OR THE LAST NODE OF THE LIST
+	Item* item = NULL;
+	if (from.generation != 0 && from.slot < inventory->slot_count && inventory->slots[from.slot].generation == from.generation)
+		item = inventory->slots[from.slot].item;
+	if (item == NULL)
+		item = (is_forward) ? inventory->items->prev : inventory->items->next;
+
+	do
+		item = (is_forward) ? item->next : item->prev;
+	while (item->is_removed); // stack_count > 0: A STACK THAT ISN'T REMOVED IS FOUND
+	return item;
+}
+
+void InventoryCompact(Inventory* inventory, bool is_forced)
+{
+	if (inventory->removed_count == 0 || (!is_forced && inventory->removed_count < ITEM_COMPACT_MIN_TOMBSTONES && inventory->removed_count <= inventory->stack_count))
+		return;
+
+	TRACE_BEGIN("InventoryCompact", NULL);
+	// ONE WALK UNLINKS AND FREES EVERY TOMBSTONE, HOW MANY POPS REMOVED THEM DOESN'T MATTER
+	uint32_t node_count = inventory->stack_count + inventory->removed_count;
+	Item* item = inventory->items;
+	for (uint32_t i = 0; i < node_count; ++i)
+	{
+		Item* next = item->next;
+		if (item->is_removed)
+		{
+			item->prev->next = next;
+			next->prev = item->prev;
+			if (inventory->items == item)
+				inventory->items = next;
+
+			// THE GENERATION CHANGES: EVERY HANDLE OF THE STACK IS STALE BEFORE THE SLOT OR THE MEMORY IS USED AGAIN
+			ItemSlot* slot = &(inventory->slots[item->handle.slot]);
+			slot->item = NULL;
+			slot->generation = (slot->generation == UINT32_MAX) ? 1 : slot->generation + 1;
+			slot->next_free = (inventory->free_slot_count > 0) ? inventory->free_slot : UINT32_MAX;
+			inventory->free_slot = item->handle.slot;
+			++(inventory->free_slot_count);
+
+			ItemFree(&item);
+		}
+		item = next;
+	}
+	if (inventory->stack_count == 0)
+		inventory->items = NULL;
+
+	++(runtime_stats.compactions);
+	runtime_stats.tombstones_freed += inventory->removed_count;
+	inventory->removed_count = 0;
+	InventoryIndexRebuild(inventory, inventory->index_slot_count); // THE ENTRIES OF THE FREED TOMBSTONES GO: ONE MORE WALK, LIKE THE COMPACTION ITSELF
+	TRACE_END("InventoryCompact");
+}
+
+void UserItemDrop(Inventory* inventory, char* pattern)
+{
+	InventoryLock(inventory);
+	TRACE_BEGIN("Drop", pattern);
+	uint64_t start_ns = StatsTimeNs();
+
+	// ONE WALK: A POPPED STACK BECOMES A TOMBSTONE THAT STAYS LINKED, SO THE WALK GOES ON FROM IT. NO SEARCH BY INDEX, NO UNLINK AND NO FREE PER STACK
+	uint32_t node_count = inventory->stack_count + inventory->removed_count;
+	uint32_t stacks_dropped = 0;
+	uint64_t copies_dropped = 0;
+	Item* item = inventory->items;
+	for (uint32_t i = 0; i < node_count; ++i, item = item->next)
+	{
+		char index[100];
+		if (!item->is_removed && GlobMatch(pattern, ItemCopyString(item, item->index, index, sizeof index)))
+		{
+			copies_dropped += ItemPopStack(inventory, item, item->quantity, true);
+			++stacks_dropped;
+		}
+	}
+
+	if (stacks_dropped > 0)
+		InventoryPublish(inventory, true);
+	uint64_t drop_ns = StatsTimeNs() - start_ns;
+
+	if (stacks_dropped == 0)
+		printf("No item index matches %s.\n", pattern);
+	else
+		printf("Dropped %llu copies of %u item stacks (%llu us). Carrying capacity left: %.2f, money: %dgp %dsp %dcp\n", (unsigned long long)copies_dropped, stacks_dropped,
+			(unsigned long long)(drop_ns / 1000), inventory->max_weight, inventory->money.gp, inventory->money.sp, inventory->money.cp);
+
+	TRACE_END("Drop");
+	InventoryUnlock(inventory);
+}
+
+ItemHandle ItemHandleAssign(Inventory* inventory, Item* item)
+{
+	uint32_t slot_number;
+	if (inventory->free_slot_count > 0) // THE SLOT OF A FREED STACK, ITS GENERATION WAS INCREASED WHEN IT WAS FREED
+	{
+		slot_number = inventory->free_slot;
+		inventory->free_slot = inventory->slots[slot_number].next_free;
+		--(inventory->free_slot_count);
+	}
+	else
+	{
+		if (inventory->slot_count == inventory->slot_capacity)
+		{
+			uint32_t new_capacity = (inventory->slot_capacity == 0) ? 64 : inventory->slot_capacity * 2;
+			ItemSlot* new_slots = (ItemSlot*)realloc(inventory->slots, new_capacity * sizeof(ItemSlot));
+			if (new_slots == NULL)
+			{
+				printf("Failed to allocate memory for the item handles!\nExiting program!\n");
+				exit(2);
+			}
+			inventory->slots = new_slots;
+			inventory->slot_capacity = new_capacity;
+		}
+		slot_number = inventory->slot_count++;
+		inventory->slots[slot_number].generation = 1;
+	}
+
+	inventory->slots[slot_number].item = item;
+	item->handle.slot = slot_number;
+	item->handle.generation = inventory->slots[slot_number].generation;
+	return item->handle;
+}
+
+Item* ItemHandleGet(Inventory* inventory, ItemHandle handle)
+{
+	if (handle.generation == 0)
+		return NULL;
+
+	if (handle.slot >= inventory->slot_count || inventory->slots[handle.slot].generation != handle.generation || inventory->slots[handle.slot].item->is_removed)
+	{
+		++(runtime_stats.stale_handles);
+		return NULL;
+	}
+	return inventory->slots[handle.slot].item;
+}
+
+uint32_t InventoryGetItemCount(Inventory* inventory)
+{
+	if (inventory)
+		return inventory->item_count;
+	else
+		printf("Inventory is NULL pointer!\n");
+	return 0;
+}
+
+bool IsInventoryEmpty(Inventory* inventory)
+{
+	return (inventory->item_count == 0) ? true : false;
+}
+
+#ifdef _WIN32 // Windows system
+void InventoryLockInit(Inventory* inventory)
+{
+	InitializeCriticalSection(&(inventory->lock));
+}
+
+void InventoryLock(Inventory* inventory)
+{
+	EnterCriticalSection(&(inventory->lock));
+}
+
+void InventoryUnlock(Inventory* inventory)
+{
+	LeaveCriticalSection(&(inventory->lock));
+}
+#else // Linux system
+void InventoryLockInit(Inventory* inventory)
+{
+	pthread_mutex_init(&(inventory->lock), NULL);
+}
+
+void InventoryLock(Inventory* inventory)
+{
+	pthread_mutex_lock(&(inventory->lock));
+}
+
+void InventoryUnlock(Inventory* inventory)
+{
+	pthread_mutex_unlock(&(inventory->lock));
+}
+#endif
+
+void InventoryForkCreate(InventoryFork* fork, Inventory* base)
+{
+	memset(fork, 0, sizeof(InventoryFork));
+	fork->base = base;
+	fork->base_version = base->version;
+	fork->max_weight = base->max_weight;
+	fork->money = base->money;
+	fork->base_item_count = base->item_count;
+	fork->base_stack_count = base->stack_count;
+}
+
+uint32_t InventoryForkPush(InventoryFork* fork, Item* new_item, uint32_t amount)
+{
+	// LIKE ItemPush: THE COPIES JOIN A STACK OF THE BASE AT ITS PRICE AND WEIGHT, THE COMMIT CHARGES THE SAME
+	ForkEntry* entry = InventoryForkFindEntry(fork, new_item->source + new_item->index.offset, new_item->index.length, false);
+	if (entry && entry->base_quantity > 0)
+	{
+		new_item->money = entry->money;
+		new_item->weight = entry->weight;
+	}
+
+	bool is_weight_limited = false;
+	uint32_t fit_amount = ItemFitAmount(fork->max_weight, &(fork->money), new_item, amount, &is_weight_limited);
+	if (fit_amount > 0 && entry == NULL)
+		entry = InventoryForkFindEntry(fork, new_item->source + new_item->index.offset, new_item->index.length, true);
+	if (fit_amount == 0 || entry == NULL)
+	{
+		ItemFree(&new_item);
+		return 0;
+	}
+
+	fork->max_weight -= new_item->weight * fit_amount;
+	Money cost = convert_from_cp(convert_to_cp(&(new_item->money)) * (int64_t)fit_amount);
+	subtract_money(&(fork->money), &cost, &(fork->money));
+	entry->quantity_delta += fit_amount;
+
+	if (entry->item == NULL) // THE FIRST PUSH OF THE INDEX: KEEP THE NODE FOR THE COMMIT, THE FILE IS ONLY PARSED ONCE PER PLAN
+	{
+		entry->item = new_item;
+		if (entry->base_quantity == 0)
+		{
+			entry->weight = new_item->weight;
+			entry->money = new_item->money;
+		}
+	}
+	else
+	{
+		ItemFree(&new_item);
+	}
+	return fit_amount;
+}
+
+uint32_t InventoryForkPop(InventoryFork* fork, const char* index, uint32_t amount)
+{
+	ForkEntry* entry = InventoryForkFindEntry(fork, index, (uint32_t)strlen(index), false);
+	if (entry == NULL)
+		return 0;
+
+	int64_t quantity = entry->base_quantity + entry->quantity_delta;
+	if (amount > quantity)
+		amount = (uint32_t)quantity;
+
+	// THE SAME CHANGES AS ItemPop: THE WEIGHT AND THE COST OF THE COPIES COME BACK
+	fork->max_weight += entry->weight * amount;
+	Money refund = convert_from_cp(convert_to_cp(&(entry->money)) * (int64_t)amount);
+	add_money(&(fork->money), &refund, &(fork->money));
+	entry->quantity_delta -= amount;
+	return amount;
+}
+
+ForkEntry* InventoryForkFindEntry(InventoryFork* fork, const char* index, uint32_t index_length, bool is_added)
+{
+	for (uint32_t i = 0; i < fork->entry_count; ++i)
+	{
+		if (strlen(fork->entries[i].index) == index_length && memcmp(fork->entries[i].index, index, index_length) == 0)
+			return &(fork->entries[i]);
+	}
+
+	// NOT CHANGED YET: THE BASE TELLS HOW MANY COPIES THERE ARE
+	Item* stack = InventoryFindItem(fork->base, index, index_length);
+	if (stack == NULL && !is_added)
+		return NULL;
+
+	if (fork->entry_count == fork->entry_capacity) // GROW THE ENTRY ARRAY
+	{
+		uint32_t new_capacity = (fork->entry_capacity == 0) ? 8 : fork->entry_capacity * 2;
+		ForkEntry* new_entries = (ForkEntry*)realloc(fork->entries, new_capacity * sizeof(ForkEntry));
+		if (new_entries == NULL)
+		{
+			printf("Failed to allocate memory for a what-if plan!\nExiting program!\n");
+			exit(2);
+		}
+		fork->entries = new_entries;
+		fork->entry_capacity = new_capacity;
+	}
+
+	ForkEntry* entry = &(fork->entries[fork->entry_count]);
+	memset(entry, 0, sizeof(ForkEntry));
+	entry->index = (char*)malloc(index_length + 1);
+	if (entry->index == NULL)
+	{
+		printf("Failed to allocate memory for a what-if plan!\nExiting program!\n");
+		exit(2);
+	}
+	memcpy(entry->index, index, index_length);
+	entry->index[index_length] = '\0';
+	if (stack)
+	{
+		entry->weight = stack->weight; // A POP REFUNDS WHAT THE STACK COST, ALSO WHEN THE FILE CHANGED SINCE
+		entry->money = stack->money;
+		entry->base_quantity = stack->quantity;
+	}
+	++(fork->entry_count);
+	return entry;
+}
+
+uint32_t InventoryForkItemCount(InventoryFork* fork, uint32_t* stack_count)
+{
+	int64_t item_count = fork->base_item_count;
+	int64_t stacks = fork->base_stack_count;
+	for (uint32_t i = 0; i < fork->entry_count; ++i)
+	{
+		ForkEntry* entry = &(fork->entries[i]);
+		item_count += entry->quantity_delta;
+		int64_t quantity = entry->base_quantity + entry->quantity_delta;
+		stacks += (entry->base_quantity == 0 && quantity > 0) - (entry->base_quantity > 0 && quantity == 0);
+	}
+	*stack_count = (uint32_t)stacks;
+	return (uint32_t)item_count;
+}
+
+void InventoryForkCommit(InventoryFork* fork)
+{
+	if (fork->base->version != fork->base_version)
+		printf("The inventory changed since the plan was made: the weight and money are checked again.\n");
+
+	for (uint32_t i = 0; i < fork->entry_count; ++i) // POPS FIRST: THEY FREE THE WEIGHT AND MONEY THAT THE PUSHES OF THE PLAN COUNTED ON
+	{
+		ForkEntry* entry = &(fork->entries[i]);
+		if (entry->quantity_delta < 0)
+			ItemPop(fork->base, entry->index, (uint32_t)(-entry->quantity_delta));
+	}
+	for (uint32_t i = 0; i < fork->entry_count; ++i)
+	{
+		ForkEntry* entry = &(fork->entries[i]);
+		if (entry->quantity_delta > 0)
+		{
+			ItemPush(fork->base, entry->item, (uint32_t)entry->quantity_delta, false);
+			entry->item = NULL; // THE BASE OWNS IT NOW
+		}
+	}
+
+	InventoryForkDiscard(fork);
+}
+
+void InventoryForkDiscard(InventoryFork* fork)
+{
+	for (uint32_t i = 0; i < fork->entry_count; ++i)
+	{
+		ItemFree(&(fork->entries[i].item));
+		free(fork->entries[i].index);
+	}
+	free(fork->entries);
+	fork->entries = NULL;
+	fork->entry_count = 0;
+	fork->entry_capacity = 0;
+}
+
+void InventorySnapshotInit(Inventory* inventory)
+{
+	atomic_init(&(inventory->reclaimer.epoch), 1);
+	for (int reader = 0; reader < SNAPSHOT_MAX_READERS; ++reader)
+	{
+		atomic_init(&(inventory->reclaimer.reader_epochs[reader]), 0);
+		atomic_init(&(inventory->reclaimer.is_reader_used[reader]), false);
+	}
+	atomic_init(&(inventory->snapshot), InventorySnapshotBuild(inventory));
+	inventory->published_ns = StatsTimeNs();
+}
+
+void InventoryPublish(Inventory* inventory, bool is_forced)
+{
+	InventorySnapshot* old_snapshot = atomic_load(&(inventory->snapshot));
+	if (old_snapshot->version == inventory->version && old_snapshot->files_loaded == inventory->files_loaded && old_snapshot->files_to_load == inventory->files_to_load)
+		return; // NOTHING CHANGED SINCE THE LAST PUBLISH
+
+	uint64_t now_ns = StatsTimeNs();
+	if (!is_forced && now_ns - inventory->published_ns < SNAPSHOT_PUBLISH_INTERVAL_NS)
+		return;
+
+	TRACE_BEGIN("InventoryPublish", NULL);
+	InventorySnapshot* new_snapshot = InventorySnapshotBuild(inventory);
+	atomic_store(&(inventory->snapshot), new_snapshot);
+	inventory->published_ns = now_ns;
+	if (shared_segment.is_writer) // THE OTHER PROCESSES SEE THE SAME VERSIONS AS THE READERS OF THIS PROCESS
+		SharedSegmentWrite(&shared_segment, new_snapshot);
+
+	// RETIRE THE OLD SNAPSHOT IN THE CURRENT EPOCH AND START A NEW ONE: A READER THAT ANNOUNCES THE NEW EPOCH LOADS THE NEW SNAPSHOT
+	SnapshotReclaimer* reclaimer = &(inventory->reclaimer);
+	if (reclaimer->retired_count == reclaimer->retired_capacity)
+	{
+		uint32_t new_capacity = (reclaimer->retired_capacity == 0) ? 16 : reclaimer->retired_capacity * 2;
+		RetiredSnapshot* new_retired = (RetiredSnapshot*)realloc(reclaimer->retired, new_capacity * sizeof(RetiredSnapshot));
+		if (new_retired == NULL)
+		{
+			printf("Failed to allocate memory for the retired snapshots!\nExiting program!\n");
+			exit(2);
+		}
+		reclaimer->retired = new_retired;
+		reclaimer->retired_capacity = new_capacity;
+	}
+	reclaimer->retired[reclaimer->retired_count].snapshot = old_snapshot;
+	reclaimer->retired[reclaimer->retired_count].epoch = atomic_fetch_add(&(reclaimer->epoch), 1);
+	++(reclaimer->retired_count);
+
+	InventoryReclaim(inventory);
+	TRACE_END("InventoryPublish");
+}
+
+InventorySnapshot* InventorySnapshotBuild(Inventory* inventory)
+{
+	// ONE ALLOCATION: THE HEADER, THE ROWS AND THE INDEX AND NAME OF EVERY ROW
+	size_t string_pool_size = 0;
+	uint32_t node_count = inventory->stack_count + inventory->removed_count; // THE TOMBSTONES THAT WAIT FOR A COMPACTION ARE SKIPPED
+	Item* temp = inventory->items;
+	for (uint32_t i = 0; i < node_count; ++i, temp = temp->next)
+	{
+		if (!temp->is_removed)
+			string_pool_size += temp->index.length + temp->name.length;
+	}
+
+	size_t snapshot_size = sizeof(InventorySnapshot) + inventory->stack_count * sizeof(SnapshotRow) + string_pool_size;
+	InventorySnapshot* snapshot = (InventorySnapshot*)malloc(snapshot_size);
+	if (snapshot == NULL)
+	{
+		printf("Failed to allocate memory for an inventory snapshot!\nExiting program!\n");
+		exit(2);
+	}
+
+	snapshot->version = inventory->version;
+	snapshot->size = snapshot_size;
+	snapshot->max_weight = inventory->max_weight;
+	snapshot->money = inventory->money;
+	snapshot->item_count = inventory->item_count;
+	snapshot->stack_count = inventory->stack_count;
+	snapshot->files_loaded = inventory->files_loaded;
+	snapshot->files_to_load = inventory->files_to_load;
+	snapshot->string_pool = (char*)(snapshot->rows + inventory->stack_count);
+
+	uint32_t pool_length = 0;
+	uint32_t row_count = 0;
+	temp = inventory->items;
+	for (uint32_t i = 0; i < node_count; ++i, temp = temp->next)
+	{
+		if (temp->is_removed)
+			continue;
+
+		SnapshotRow* row = &(snapshot->rows[row_count++]);
+		row->index_offset = pool_length;
+		row->index_length = (uint16_t)temp->index.length;
+		memcpy(snapshot->string_pool + pool_length, temp->source + temp->index.offset, row->index_length);
+		pool_length += row->index_length;
+		row->name_offset = pool_length;
+		row->name_length = (uint16_t)temp->name.length;
+		memcpy(snapshot->string_pool + pool_length, temp->source + temp->name.offset, row->name_length);
+		pool_length += row->name_length;
+		row->weight = temp->weight;
+		row->money = temp->money;
+		row->quantity = temp->quantity;
+	}
+
+	++(runtime_stats.snapshots_published);
+	runtime_stats.snapshot_bytes_live += snapshot_size;
+	return snapshot;
+}
+
+int InventoryReaderRegister(Inventory* inventory)
+{
+	for (int reader = 0; reader < SNAPSHOT_MAX_READERS; ++reader)
+	{
+		bool is_used = false;
+		if (atomic_compare_exchange_strong(&(inventory->reclaimer.is_reader_used[reader]), &is_used, true))
+			return reader;
+	}
+
+	printf("All %d snapshot reader slots are in use!\n", SNAPSHOT_MAX_READERS);
+	return -1;
+}
+
+void InventoryReaderUnregister(Inventory* inventory, int reader)
+{
+	atomic_store(&(inventory->reclaimer.reader_epochs[reader]), 0);
+	atomic_store(&(inventory->reclaimer.is_reader_used[reader]), false);
+}
+
+InventorySnapshot* InventorySnapshotAcquire(Inventory* inventory, int reader)
+{
+	// ANNOUNCE THE EPOCH BEFORE LOADING THE SNAPSHOT (BOTH SEQUENTIALLY CONSISTENT): THE WRITER EITHER SEES THE EPOCH AND KEEPS THE SNAPSHOT, OR REPLACED IT BEFORE THE LOAD
+	atomic_store(&(inventory->reclaimer.reader_epochs[reader]), atomic_load(&(inventory->reclaimer.epoch)));
+	return atomic_load(&(inventory->snapshot));
+}
+
+void InventorySnapshotRelease(Inventory* inventory, int reader)
+{
+	atomic_store(&(inventory->reclaimer.reader_epochs[reader]), 0);
+}
+
+void InventoryReclaim(Inventory* inventory)
+{
+	SnapshotReclaimer* reclaimer = &(inventory->reclaimer);
+
+	uint64_t oldest_reader_epoch = UINT64_MAX;
+	for (int reader = 0; reader < SNAPSHOT_MAX_READERS; ++reader)
+	{
+		uint64_t reader_epoch = atomic_load(&(reclaimer->reader_epochs[reader]));
+		if (reader_epoch != 0 && reader_epoch < oldest_reader_epoch)
+			oldest_reader_epoch = reader_epoch;
+	}
+
+	// A SNAPSHOT RETIRED IN EPOCH E CAN ONLY BE SEEN BY A READER THAT ANNOUNCED E OR EARLIER
+	uint32_t kept_count = 0;
+	for (uint32_t i = 0; i < reclaimer->retired_count; ++i)
+	{
+		RetiredSnapshot* retired = &(reclaimer->retired[i]);
+		if (retired->epoch < oldest_reader_epoch)
+		{
+			runtime_stats.snapshot_bytes_live -= retired->snapshot->size;
+			++(runtime_stats.snapshots_reclaimed);
+			free(retired->snapshot);
+		}
+		else
+		{
+			reclaimer->retired[kept_count++] = *retired;
+		}
+	}
+	reclaimer->retired_count = kept_count;
+}
+
+bool SnapshotStress(uint32_t reader_count, uint32_t stack_count)
+{
+	Inventory inventory = { 0 };
+	InventoryLockInit(&inventory);
+	InventorySnapshotInit(&inventory);
+	inventory.max_weight = SNAPSHOT_STRESS_MAX_WEIGHT;
+	inventory.money = convert_from_cp(SNAPSHOT_STRESS_MONEY_CP);
+
+	InventoryLock(&inventory);
+	for (uint32_t number = 0; number < stack_count; ++number)
+		ItemPush(&inventory, SnapshotStressItemCreate(number), 2, true);
+	InventoryPublish(&inventory, true);
+	size_t snapshot_size = atomic_load(&(inventory.snapshot))->size;
+	InventoryUnlock(&inventory);
+
+	printf("Snapshot stress: %u item stacks, %zu bytes per snapshot. Every publish copies all rows: a write costs O(stacks), a read costs nothing but the rows it reads.\n", stack_count, snapshot_size);
+	printf("readers      reads/s   reads/s per reader      rows/s  publishes  us per publish  torn\n");
+
+	SnapshotStressReader readers[SNAPSHOT_MAX_READERS];
+	uint64_t torn_reads = 0;
+	uint32_t random_state = 1;
+	for (uint32_t run_readers = 1; ; run_readers = (run_readers * 2 < reader_count) ? run_readers * 2 : reader_count) // 1, 2, 4 ... AND LAST reader_count
+	{
+		atomic_bool is_stopped;
+		atomic_init(&is_stopped, false);
+		uint32_t started_count = 0;
+		for (uint32_t i = 0; i < run_readers; ++i)
+		{
+			SnapshotStressReader* reader = &(readers[i]);
+			memset(reader, 0, sizeof(SnapshotStressReader));
+			reader->inventory = &inventory;
+			reader->is_stopped = &is_stopped;
+			reader->reader = InventoryReaderRegister(&inventory);
+#ifdef _WIN32 // Windows system
+			reader->thread = CreateThread(NULL, 0, SnapshotStressReaderMain, reader, 0, NULL);
+			bool is_started = (reader->thread != NULL);
+#else // Linux system
+			bool is_started = (pthread_create(&(reader->thread), NULL, SnapshotStressReaderMain, reader) == 0);
+#endif
+			if (!is_started)
+			{
+				InventoryReaderUnregister(&inventory, reader->reader);
+				break;
+			}
+			++started_count;
+		}
+		if (started_count < run_readers)
+			printf("Only %u of %u reader threads could be started.\n", started_count, run_readers);
+
+		// THE WRITER: ONE COPY OF A RANDOM STACK IS POPPED OR PUSHED BACK, THEN PUBLISHED LIKE AFTER A COMMAND
+		uint64_t publish_count = 0;
+		uint64_t publish_ns = 0;
+		uint64_t start_ns = StatsTimeNs();
+		uint64_t end_ns = start_ns + SNAPSHOT_STRESS_RUN_NS;
+		while (StatsTimeNs() < end_ns)
+		{
+			random_state = random_state * 1664525 + 1013904223;
+			InventoryLock(&inventory);
+			uint32_t number = (random_state >> 8) % inventory.slot_count; // ONLY THE PUSHED STACKS. A COPY IS ONLY POPPED FROM A STACK OF 2 OR MORE: NONE IS REMOVED
+			Item* stack = inventory.slots[number].item;
+			if (stack->quantity > 1)
+				ItemPopStack(&inventory, stack, 1, true);
+			else
+				ItemPush(&inventory, SnapshotStressItemCreate(number), 1, true);
+
+			uint64_t publish_start_ns = StatsTimeNs();
+			InventoryPublish(&inventory, true);
+			publish_ns += StatsTimeNs() - publish_start_ns;
+			++publish_count;
+			InventoryUnlock(&inventory);
+		}
+		atomic_store(&is_stopped, true);
+
+		uint64_t reads = 0;
+		uint64_t rows_read = 0;
+		for (uint32_t i = 0; i < started_count; ++i)
+		{
+#ifdef _WIN32 // Windows system
+			WaitForSingleObject(readers[i].thread, INFINITE);
+			CloseHandle(readers[i].thread);
+#else // Linux system
+			pthread_join(readers[i].thread, NULL);
+#endif
+			InventoryReaderUnregister(&inventory, readers[i].reader);
+			reads += readers[i].reads;
+			rows_read += readers[i].rows_read;
+			torn_reads += readers[i].torn_reads;
+		}
+		double seconds = (double)(StatsTimeNs() - start_ns) / 1e9;
+		printf("%7u %12.0f %20.0f %11.0f %10llu %15.2f %5llu\n", started_count, reads / seconds, (started_count > 0) ? reads / seconds / started_count : 0.0, rows_read / seconds,
+			(unsigned long long)publish_count, (publish_count > 0) ? publish_ns / 1000.0 / publish_count : 0.0, (unsigned long long)torn_reads);
+
+		if (run_readers == reader_count)
+			break;
+	}
+
+	InventoryLock(&inventory);
+	InventoryReclaim(&inventory);
+	InventoryUnlock(&inventory);
+	if (torn_reads > 0)
+		printf("%llu snapshots didn't add up: a reader saw a snapshot that was changed after it was published!\n", (unsigned long long)torn_reads);
+	return torn_reads == 0;
+}
+
+Item* SnapshotStressItemCreate(uint32_t number)
+{
+	Item* item = ItemCreate();
+
+	char strings[64];
+	int index_length = snprintf(strings, sizeof strings, "stress-%u", number);
+	int name_length = snprintf(strings + index_length, sizeof strings - index_length, "Stress item %u", number);
+	item->source = (char*)malloc(index_length + name_length + 1);
+	if (item->source == NULL)
+	{
+		printf("Failed to allocate memory for a new Item!\nExiting program!\n");
+		exit(2);
+	}
+	memcpy(item->source, strings, index_length + name_length + 1);
+	item->source_length = index_length + name_length;
+	StatsItemBytesAdd(item->source_length + 1);
+
+	item->index.offset = 0;
+	item->index.length = index_length;
+	item->name.offset = index_length;
+	item->name.length = name_length;
+	item->weight = (float)(1 + number % 5);
+	item->money = convert_from_cp(1 + (number % 1000) * 7);
+	snprintf(item->file_name, sizeof(item->file_name), "stress-%u.json", number);
+	return item;
+}
+
+double SnapshotStressWeight(uint32_t stack_count)
+{
+	// 2 COPIES OF 1, 2, 3, 4, 5 LB FOR EVERY 5 STACKS, THEN 2 COPIES OF 1 ... remainder LB
+	uint32_t remainder = stack_count % 5;
+	return 30.0 * (stack_count / 5) + (double)remainder * (remainder + 1);
+}
+
+void SnapshotStressRead(SnapshotStressReader* reader)
+{
+	while (!atomic_load(reader->is_stopped))
+	{
+		InventorySnapshot* snapshot = InventorySnapshotAcquire(reader->inventory, reader->reader);
+
+		// EVERY PUSH AND POP MOVES WEIGHT AND MONEY BETWEEN THE TOTALS AND THE ROWS: A SNAPSHOT THAT CHANGED AFTER ITS PUBLISH DOESN'T ADD UP
+		double weight = snapshot->max_weight;
+		int64_t money_cp = convert_to_cp(&(snapshot->money));
+		uint64_t item_count = 0;
+		for (uint32_t i = 0; i < snapshot->stack_count; ++i)
+		{
+			SnapshotRow* row = &(snapshot->rows[i]);
+			weight += (double)row->weight * row->quantity;
+			money_cp += convert_to_cp(&(row->money)) * (int64_t)row->quantity;
+			item_count += row->quantity;
+		}
+		if (weight != SNAPSHOT_STRESS_MAX_WEIGHT || money_cp != SNAPSHOT_STRESS_MONEY_CP || item_count != snapshot->item_count)
+			++(reader->torn_reads);
+
+		++(reader->reads);
+		reader->rows_read += snapshot->stack_count;
+		InventorySnapshotRelease(reader->inventory, reader->reader);
+	}
+}
+
+#ifdef _WIN32 // Windows system
+DWORD WINAPI SnapshotStressReaderMain(LPVOID reader)
+{
+	SnapshotStressRead((SnapshotStressReader*)reader);
+	return 0;
+}
+#else // Linux system
+void* SnapshotStressReaderMain(void* reader)
+{
+	SnapshotStressRead((SnapshotStressReader*)reader);
+	return NULL;
+}
+#endif
+
+void ItemLoaderRun(ItemLoader* loader)
+{
+	Inventory* inventory = loader->inventory;
+
+	TRACE_BEGIN("Load items", NULL);
+	for (uint32_t i = 0; i < loader->file_count; ++i)
+	{
+		InventoryLock(inventory); // ONE FILE AT A TIME: A COMMAND NEVER WAITS LONGER THAN THE PARSE AND PUSH OF ONE FILE
+		if (loader->is_stop_requested)
+		{
+			InventoryUnlock(inventory);
+			break;
+		}
+
+		ItemRequest* request = &(inventory->item_requests.requests[i]);
+		Item* new_item = JsonParse(inventory->item_requests.paths + request->path_offset, (loader->is_quiet) ? JSON_PARSE_QUIET : JSON_PARSE_EAGER);
+		if (!loader->is_quiet)
+			printf("\nNew Item created from JSON file. Index: %.*s, Name: %.*s\n\n", ITEM_STRING_ARGS(new_item, index), ITEM_STRING_ARGS(new_item, name));
+		ItemPush(inventory, new_item, request->amount, loader->is_quiet); // ONE PARSE PER JSON FILE, ALL COPIES SHARE THE SAME NODE
+		if (!loader->is_quiet)
+			printf("\n");
+
+		++(inventory->files_loaded);
+		InventoryPublish(inventory, false); // A BIG LOADOUT DOESN'T COPY THE WHOLE LIST AFTER EVERY FILE
+		InventoryUnlock(inventory);
+	}
+	TRACE_END("Load items");
+
+	InventoryLock(inventory);
+	InventoryPublish(inventory, true);
+	if (loader->is_started && !loader->is_stop_requested)
+		printf("All %u json files are loaded.\n", inventory->files_loaded);
+	InventoryUnlock(inventory);
+}
+
+#ifdef _WIN32 // Windows system
+DWORD WINAPI ItemLoaderThreadMain(LPVOID loader)
+{
+	ItemLoaderRun((ItemLoader*)loader);
+	return 0;
+}
+
+void ItemLoaderStart(ItemLoader* loader)
+{
+	loader->is_started = true; // SET BEFORE THE THREAD RUNS: ItemLoaderRun READS IT
+	loader->thread = CreateThread(NULL, 0, ItemLoaderThreadMain, loader, 0, NULL);
+	if (loader->thread == NULL) // NO THREAD: LOAD THE ITEMS BEFORE THE MENU AS WITHOUT --progressive
+	{
+		loader->is_started = false;
+		ItemLoaderRun(loader);
+	}
+}
+
+void ItemLoaderStop(ItemLoader* loader)
+{
+	if (!loader->is_started)
+		return;
+
+	InventoryLock(loader->inventory);
+	loader->is_stop_requested = true;
+	InventoryUnlock(loader->inventory);
+
+	WaitForSingleObject(loader->thread, INFINITE);
+	CloseHandle(loader->thread);
+	loader->is_started = false;
+}
+#else // Linux system
+void* ItemLoaderThreadMain(void* loader)
+{
+	ItemLoaderRun((ItemLoader*)loader);
+	return NULL;
+}
+
+void ItemLoaderStart(ItemLoader* loader)
+{
+	loader->is_started = true; // SET BEFORE THE THREAD RUNS: ItemLoaderRun READS IT
+	if (pthread_create(&(loader->thread), NULL, ItemLoaderThreadMain, loader) != 0) // NO THREAD: LOAD THE ITEMS BEFORE THE MENU AS WITHOUT --progressive
+	{
+		loader->is_started = false;
+		ItemLoaderRun(loader);
+	}
+}
+
+void ItemLoaderStop(ItemLoader* loader)
+{
+	if (!loader->is_started)
+		return;
+
+	InventoryLock(loader->inventory);
+	loader->is_stop_requested = true;
+	InventoryUnlock(loader->inventory);
+
+	pthread_join(loader->thread, NULL);
+	loader->is_started = false;
+}
+#endif
+
+void ItemLoaderPrintProgress(InventorySnapshot* snapshot)
+{
+	if (snapshot->files_loaded < snapshot->files_to_load)
+		printf("Still loading: %u of %u json files loaded.\n", snapshot->files_loaded, snapshot->files_to_load);
+}
+
+void UserItemAdd(Inventory* inventory, char* file_path)
+{
+	// COMBINE FOLDER NAME WITH FILENAME: "Items_JSON\\FILENAME"
+	size_t json_filename_len = strlen(file_path);
+	char json_item_folder_name[] = ITEM_FOLDER_NAME;
+	unsigned int json_item_full_path_len = (sizeof(json_item_folder_name) + json_filename_len + 1); // sizeof includes '\0' char, +1 for the backslash '\'
+	char json_item_full_path[json_item_full_path_len];
+
+	int snprintf_ret = snprintf(json_item_full_path, json_item_full_path_len, "%s" PATH_SEPARATOR "%s", json_item_folder_name, file_path);
+
+	if (snprintf_ret < 0 && snprintf_ret >= json_item_full_path_len)
+	{
+		printf("Failed to copy full json item path name!\nExiting program!\n");
+		exit(1);
+	}
+
+	InventoryLock(inventory); // BEFORE THE ACCESS CHECK: IT COUNTS IN THE RUNTIME STATISTICS, LIKE THE FILE CALLS OF THE LOADER THREAD
+	if (PackFind(&item_pack, json_item_full_path) == NULL && StatsFileAccess(json_item_full_path, 4) == -1) // NOT IN THE PACK AND NOT IN THE ITEM FOLDER: JsonParse WOULD EXIT THE PROGRAM
+	{
+		printf("%s does not exist! No item added.\n", file_path);
+		InventoryUnlock(inventory);
+		return;
+	}
+
+	Item* new_item = NULL;
+	new_item = JsonParse(json_item_full_path, JSON_PARSE_EAGER);
+
+	printf("\nNew Item created from JSON file. Index: %.*s, Name: %.*s\n\n", ITEM_STRING_ARGS(new_item, index), ITEM_STRING_ARGS(new_item, name));
+	ItemPush(inventory, new_item, 1, false); 
+	printf("\n");
+	InventoryPublish(inventory, true);
+	InventoryUnlock(inventory);
+}
+
+void UserItemSearchAdd(Inventory* inventory, SearchIndex* search_index, char* query)
+{
+	SearchResult results[SEARCH_MAX_SUGGESTIONS];
+	uint8_t result_count = SearchIndexSuggest(search_index, query, results, SEARCH_MAX_SUGGESTIONS);
+
+	if (result_count == 0)
+	{
+		printf("No item found that looks like: %s\n", query);
+		return;
+	}
+
+	size_t query_length = strlen(query);
+	if (query_length > 5 && strcmp(query + query_length - 5, ".json") == 0)
+		query_length -= 5;
+
+	SearchEntry* chosen_entry = NULL;
+	if (results[0].distance == 0 && results[0].key_length == query_length)
+	{
+		chosen_entry = &(search_index->entries[results[0].entry]); // THE QUERY IS THE FULL INDEX, NAME OR FILE NAME OF ONE ITEM: NO NEED TO ASK
+	}
+	else
+	{
+		printf("Suggestions:\n");
+		for (uint8_t i = 0; i < result_count; ++i)
+			printf("%d) %s (%s)\n", i + 1, search_index->entries[results[i].entry].name, search_index->entries[results[i].entry].file_name);
+		printf("Press the number of the item to add or 0 to cancel.\n");
+
+		char user_input = '\0';
+		while (chosen_entry == NULL)
+		{
+			if ((user_input = (char)TerminalReadKey(&terminal)) == '\0')
+				return;
+
+			if (user_input == '0')
+			{
+				printf("No item added.\n");
+				return;
+			}
+			else if (user_input >= '1' && user_input < '1' + result_count)
+				chosen_entry = &(search_index->entries[results[user_input - '1'].entry]);
+			else
+				printf("Non valid number entered, please enter a number from 0 to %d.\n", result_count);
+		}
+	}
+
+	UserItemAdd(inventory, chosen_entry->file_name); // THE FILE IS KNOWN TO EXIST IN THE ITEM FOLDER, NO GUESSING NEEDED
+}
+
+bool PlanNextToken(const char** cursor, char* token, size_t token_size)
+{
+	const char* c = *cursor;
+	while (*c == ' ' || *c == '\t')
+		++c;
+	if (*c == '\0')
+		return false;
+
+	size_t token_length = 0;
+	for (; *c != '\0' && *c != ' ' && *c != '\t'; ++c)
+	{
+		if (token_length < token_size - 1)
+			token[token_length++] = *c;
+	}
+	token[token_length] = '\0';
+	*cursor = c;
+	return true;
+}
+
+void UserItemPlan(Inventory* inventory, char* plan_text)
+{
+	InventoryFork fork;
+	InventoryLock(inventory);
+	InventoryForkCreate(&fork, inventory);
+
+	const char* cursor = plan_text;
+	char token_buffer[FILE_PATH_BUFFER_MAX + 1];
+	bool is_plan_valid = true;
+	while (PlanNextToken(&cursor, token_buffer, sizeof token_buffer))
+	{
+		char* token = token_buffer;
+		uint32_t amount = 1;
+		const char* amount_cursor = cursor; // AN AMOUNT CAN FOLLOW THE TOKEN, ELSE THE NEXT TOKEN IS THE NEXT ITEM
+		char amount_token[16];
+		if (PlanNextToken(&amount_cursor, amount_token, sizeof amount_token) && ItemAmountParse(amount_token, &amount))
+			cursor = amount_cursor;
+
+		if (*token == '-') // SELL COPIES: BY INDEX, A JSON FILE NAME IS ACCEPTED TOO
+		{
+			++token;
+			size_t index_length = strlen(token);
+			if (index_length > 5 && strcmp(token + index_length - 5, ".json") == 0)
+				token[index_length - 5] = '\0';
+
+			uint32_t popped = InventoryForkPop(&fork, token, amount);
+			if (popped == 0)
+			{
+				printf("Plan: %s isn't in the inventory.\n", token);
+				is_plan_valid = false;
+			}
+			else
+				printf("Plan: sell %u x %s%s\n", popped, token, (popped < amount) ? " (all copies)" : "");
+			continue;
+		}
+
+		char json_item_full_path[FILE_PATH_BUFFER_MAX + 1];
+		size_t json_filename_len = strlen(token);
+		int snprintf_ret = snprintf(json_item_full_path, sizeof json_item_full_path, "%s" PATH_SEPARATOR "%s", ITEM_FOLDER_NAME, token);
+		if (json_filename_len < 6 || strcmp(token + json_filename_len - 5, ".json") != 0 || snprintf_ret < 0 || snprintf_ret >= sizeof json_item_full_path
+			|| (PackFind(&item_pack, json_item_full_path) == NULL && StatsFileAccess(json_item_full_path, 4) == -1)) // JsonParse WOULD EXIT THE PROGRAM
+		{
+			printf("Plan: %s isn't a json file of an item.\n", token);
+			is_plan_valid = false;
+			continue;
+		}
+
+		uint32_t pushed = InventoryForkPush(&fork, JsonParse(json_item_full_path, JSON_PARSE_QUIET), amount);
+		printf("Plan: buy %u x %s", pushed, token);
+		if (pushed < amount)
+		{
+			printf(" (%u copies don't fit in the carrying capacity or the money)", amount - pushed);
+			is_plan_valid = false;
+		}
+		printf("\n");
+	}
+
+	uint32_t stack_count = 0;
+	uint32_t item_count = InventoryForkItemCount(&fork, &stack_count);
+	printf("After the plan: carrying capacity left %.2f (now %.2f), money %dgp %dsp %dcp (now %dgp %dsp %dcp), %u items (%u different, now %u)\n",
+		fork.max_weight, inventory->max_weight, fork.money.gp, fork.money.sp, fork.money.cp, inventory->money.gp, inventory->money.sp, inventory->money.cp,
+		item_count, stack_count, inventory->item_count);
+	InventoryUnlock(inventory); // THE LOADER CAN GO ON WHILE THE USER DECIDES
+
+	if (fork.entry_count == 0)
+	{
+		InventoryForkDiscard(&fork);
+		return;
+	}
+
+	printf((is_plan_valid) ? "Everything fits. Apply the plan ? ( N / Y )\n" : "Not everything fits. Apply the part that fits ? ( N / Y )\n");
+	char user_input = '\0';
+	while (true)
+	{
+		user_input = (char)TerminalReadKey(&terminal);
+		if (user_input == 'y' || user_input == 'Y')
+		{
+			InventoryLock(inventory);
+			InventoryForkCommit(&fork);
+			InventoryPublish(inventory, true);
+			InventoryUnlock(inventory);
+			printf("Plan applied.\n");
+			return;
+		}
+		else if (user_input == 'n' || user_input == 'N' || user_input == '\0')
+		{
+			InventoryForkDiscard(&fork);
+			printf("Plan discarded, the inventory didn't change.\n");
+			return;
+		}
+		printf("Non valid command entered, please enter yes (Y) or no (N).\n");
+	}
+}
+
+void SearchIndexBuild(SearchIndex* search_index)
+{
+	search_index->root = SearchNodeCreate('\0');
+
+	if (item_pack.is_open) // THE PACK TABLE HOLDS THE INDEX AND NAME OF EVERY ITEM: NOT A SINGLE FILE IS OPENED
+	{
+		for (uint32_t i = 0; i < item_pack.header.entry_count; ++i)
+		{
+			PackEntry* entry = &(item_pack.entries[i]);
+			SearchIndexAddEntry(search_index, item_pack.string_pool + entry->file_name_offset, item_pack.string_pool + entry->index_offset, entry->index_length,
+				item_pack.string_pool + entry->name_offset, entry->name_length);
+		}
+
+		printf("Item search index: %d items found in the pack %s.\n\n", search_index->entry_count, item_pack.file_name);
+		return;
+	}
+
+	if (!ItemFolderScan(SearchIndexAddFile, search_index))
+	{
+		printf("Failed to open the folder %s. Item search is not available.\n", ITEM_FOLDER_NAME);
+		return;
+	}
+
+	printf("Item search index: %d items found in the folder %s.\n\n", search_index->entry_count, ITEM_FOLDER_NAME);
+}
+
+void SearchIndexAddFile(void* context, char* file_name)
+{
+	SearchIndex* search_index = (SearchIndex*)context;
+
+	char json_item_full_path[FILE_PATH_BUFFER_MAX + 1];
+	snprintf(json_item_full_path, sizeof json_item_full_path, "%s" PATH_SEPARATOR "%s", ITEM_FOLDER_NAME, file_name);
+
+	Item item = { 0 };   // ONLY USED TO COLLECT THE INDEX AND NAME, NEVER PUSHED
+	item.weight = -1.0f;
+
+	int64_t file_size = -1;
+	int64_t file_mtime = 0;
+	bool has_file_status = ParseCacheFileStatus(json_item_full_path, &file_size, &file_mtime);
+	ParseCacheEntry* cache_entry = ParseCacheFind(json_item_full_path);
+
+	char* file_buffer = NULL; // ON THE HEAP WITH THE SIZE OF THE FILE, LIKE JsonParse: AN ITEM FILE OF ANY LENGTH IS INDEXED
+	if (cache_entry && has_file_status && cache_entry->file_size == file_size && cache_entry->file_mtime == file_mtime) // UNCHANGED SINCE IT WAS CACHED: TAKE THE INDEX AND NAME FROM THE CACHE
+	{
+		item.source = cache_entry->strings;
+		item.index.length = cache_entry->index.length;
+		item.name.offset = cache_entry->index.length;
+		item.name.length = cache_entry->name.length;
+		++(runtime_stats.parse_cache_hits);
+	}
+	else
+	{
+		long file_length = 0;
+		file_buffer = JsonLoadFile(json_item_full_path, &file_length);
+		if (file_buffer == NULL)
+		{
+			printf("Failed to read %s, item is not added to the search index!\n", json_item_full_path);
+			return;
+		}
+
+		item.source = file_buffer;
+		item.source_length = file_length;
+
+		uint64_t content_hash = HashFnv1a(file_buffer, file_length, HASH_FNV1A_SEED);
+		if (cache_entry && cache_entry->file_size == file_length && cache_entry->content_hash == content_hash) // ONLY THE MTIME CHANGED
+		{
+			item.index = cache_entry->index;
+			item.name = cache_entry->name;
+			cache_entry->file_mtime = file_mtime;
+			parse_cache.is_dirty = true;
+			++(runtime_stats.parse_cache_content_hits);
+		}
+		else
+		{
+			JsonParseString(file_buffer, 0, file_length, &item, JSON_PARSE_EAGER | JSON_PARSE_QUIET);
+
+			++(runtime_stats.parse_cache_misses);
+			if (has_file_status) // THE ITEMS OF THE COMMAND LINE ARE IN THIS FOLDER TOO: THEIR JsonParse IS A CACHE HIT NOW
+				ParseCacheStore(json_item_full_path, file_mtime, content_hash, &item);
+		}
+	}
+
+	SearchIndexAddEntry(search_index, file_name, item.source + item.index.offset, item.index.length, item.source + item.name.offset, item.name.length);
+	free(file_buffer);
+}
+
+void SearchIndexAddEntry(SearchIndex* search_index, char* file_name, const char* index, uint32_t index_length, const char* name, uint32_t name_length)
+{
+	if (strlen(file_name) >= sizeof(search_index->entries[0].file_name))
+	{
+		printf("File name %s is too long, item is not added to the search index!\n", file_name);
+		return;
+	}
+
+	if (search_index->entry_count == search_index->entry_capacity) // GROW THE ENTRY ARRAY
+	{
+		int32_t new_capacity = (search_index->entry_capacity == 0) ? 64 : search_index->entry_capacity * 2;
+		SearchEntry* new_entries = (SearchEntry*)realloc(search_index->entries, new_capacity * sizeof(SearchEntry));
+		if (new_entries == NULL)
+		{
+			printf("Failed to allocate memory for the item search index!\nExiting program!\n");
+			exit(2);
+		}
+		search_index->entries = new_entries;
+		search_index->entry_capacity = new_capacity;
+	}
+
+	int32_t entry = search_index->entry_count++;
+	SearchEntry* search_entry = &(search_index->entries[entry]);
+	strcpy(search_entry->file_name, file_name);
+	snprintf(search_entry->index, sizeof(search_entry->index), "%.*s", (int)index_length, index);
+	snprintf(search_entry->name, sizeof(search_entry->name), "%.*s", (int)name_length, name);
+
+	char file_stem[50];
+	snprintf(file_stem, sizeof file_stem, "%.*s", (int)(strlen(file_name) - 5), file_name); // FILE NAME WITHOUT ".json"
+
+	SearchIndexInsert(search_index, file_stem, entry);
+	if (index_length != 0)
+		SearchIndexInsert(search_index, search_entry->index, entry);
+	if (name_length != 0)
+		SearchIndexInsert(search_index, search_entry->name, entry);
+}
+
+void SearchIndexInsert(SearchIndex* search_index, char* key, int32_t entry)
+{
+	SearchNode* node = search_index->root;
+
+	for (char* key_pointer = key; *key_pointer != '\0'; ++key_pointer)
+	{
+		char c = (char)tolower((unsigned char)*key_pointer);
+
+		SearchNode* child = node->child;
+		while (child && child->c != c)
+			child = child->sibling;
+
+		if (child == NULL) // NO KEY WITH THIS PREFIX YET: ADD A NEW NODE IN FRONT OF THE CHILD LIST
+		{
+			child = SearchNodeCreate(c);
+			child->sibling = node->child;
+			node->child = child;
+		}
+
+		node = child;
+	}
+
+	if (node->entry == -1) // THE FIRST FILE WITH THIS KEY KEEPS IT, THE OTHER FILE IS STILL FOUND WITH ITS OWN INDEX OR FILE NAME
+		node->entry = entry;
+}
+
+SearchNode* SearchNodeCreate(char c)
+{
+	SearchNode* node = (SearchNode*)calloc(1, sizeof(SearchNode));
+	if (node == NULL)
+	{
+		printf("Failed to allocate memory for the item search index!\nExiting program!\n");
+		exit(2);
+	}
+
+	node->c = c;
+	node->entry = -1;
+	return node;
+}
+
+uint8_t SearchIndexSuggest(SearchIndex* search_index, char* query, SearchResult* results, uint8_t max_results)
+{
+	uint8_t result_count = 0;
+	if (search_index->root == NULL)
+		return 0;
+
+	// LOWER CASE COPY OF THE QUERY WITHOUT ".json" SO "Greatsword.json", "greatsword" AND "GreatSword" ALL MATCH
+	char key[50];
+	int query_length = snprintf(key, sizeof key, "%s", query);
+	if (query_length >= (int)sizeof key)
+		query_length = sizeof key - 1;
+	if (query_length > 5 && strcmp(key + query_length - 5, ".json") == 0)
+		query_length -= 5;
+	key[query_length] = '\0';
+	for (int i = 0; i < query_length; ++i)
+		key[i] = (char)tolower((unsigned char)key[i]);
+
+	// SHORT QUERIES ONLY GET PREFIX MATCHES, OTHERWISE EVERY ITEM WOULD BE A SUGGESTION
+	uint8_t max_distance = (query_length < 3) ? 0 : (query_length < 6) ? 1 : SEARCH_MAX_DISTANCE;
+
+	int first_row[query_length + 1]; // EDIT DISTANCE BETWEEN THE EMPTY PREFIX AND EVERY PREFIX OF THE QUERY
+	for (int i = 0; i <= query_length; ++i)
+		first_row[i] = i;
+
+	SearchIndexWalk(search_index->root, key, query_length, first_row, max_distance, 0, results, &result_count, max_results);
+
+	return result_count;
+}
+
+void SearchIndexWalk(SearchNode* node, char* query, int query_length, int* previous_row, uint8_t max_distance, uint8_t depth, SearchResult* results, uint8_t* result_count, uint8_t max_results)
+{
+	for (SearchNode* child = node->child; child; child = child->sibling)
+	{
+		// NEXT ROW OF THE LEVENSHTEIN TABLE: EDIT DISTANCE BETWEEN THE KEY PREFIX ENDING IN child AND EVERY PREFIX OF THE QUERY
+		int row[query_length + 1];
+		row[0] = previous_row[0] + 1;
+		int row_min = row[0];
+		for (int i = 1; i <= query_length; ++i)
+		{
+			int distance = previous_row[i - 1] + ((query[i - 1] == child->c) ? 0 : 1); // SUBSTITUTION (OR MATCH)
+			if (previous_row[i] + 1 < distance)                                         // EXTRA CHAR IN THE KEY
+				distance = previous_row[i] + 1;
+			if (row[i - 1] + 1 < distance)                                              // EXTRA CHAR IN THE QUERY
+				distance = row[i - 1] + 1;
+			row[i] = distance;
+			if (distance < row_min)
+				row_min = distance;
+		}
+
+		if (row_min > max_distance) // EVERY KEY BELOW THIS NODE HAS TOO MANY TYPOS
+			continue;
+
+		if (row[query_length] <= max_distance) // THE WHOLE QUERY MATCHES THIS PREFIX: EVERY KEY BELOW IS A COMPLETION
+			SearchIndexCollect(child, (uint8_t)row[query_length], depth + 1, results, result_count, max_results);
+
+		SearchIndexWalk(child, query, query_length, row, max_distance, depth + 1, results, result_count, max_results); // A DEEPER PREFIX CAN STILL MATCH WITH LESS TYPOS
+	}
+}
+
+void SearchIndexCollect(SearchNode* node, uint8_t distance, uint8_t depth, SearchResult* results, uint8_t* result_count, uint8_t max_results)
+{
+	// PRUNE: THE RESULTS ARE FULL AND EVERY KEY BELOW THIS NODE WOULD RANK LOWER THAN THE LAST RESULT
+	if (*result_count == max_results)
+	{
+		SearchResult* last_result = &(results[max_results - 1]);
+		if (distance > last_result->distance || (distance == last_result->distance && depth >= last_result->key_length))
+			return;
+	}
+
+	if (node->entry != -1)
+		SearchResultInsert(node->entry, distance, depth, results, result_count, max_results);
+
+	for (SearchNode* child = node->child; child; child = child->sibling)
+		SearchIndexCollect(child, distance, depth + 1, results, result_count, max_results);
+}
+
+void SearchResultInsert(int32_t entry, uint8_t distance, uint8_t key_length, SearchResult* results, uint8_t* result_count, uint8_t max_results)
+{
+	// THE SAME ITEM CAN BE FOUND THROUGH ITS INDEX, NAME AND FILE NAME: ONLY KEEP ITS BEST RANK
+	for (uint8_t i = 0; i < *result_count; ++i)
+	{
+		if (results[i].entry == entry)
+		{
+			if (distance > results[i].distance || (distance == results[i].distance && key_length >= results[i].key_length))
+				return;
+
+			for (uint8_t j = i; j + 1 < *result_count; ++j) // REMOVE THE WORSE RANK, THE BETTER ONE IS INSERTED BELOW
+				results[j] = results[j + 1];
+			--(*result_count);
+			break;
+		}
+	}
+
+	uint8_t position = *result_count;
+	while (position > 0 && (distance < results[position - 1].distance || (distance == results[position - 1].distance && key_length < results[position - 1].key_length)))
+		--position;
+
+	if (position == max_results) // RANKS LOWER THAN EVERY RESULT IN A FULL LIST
+		return;
+
+	uint8_t last = (*result_count < max_results) ? *result_count : max_results - 1;
+	for (uint8_t i = last; i > position; --i)
+		results[i] = results[i - 1];
+	results[position].entry = entry;
+	results[position].distance = distance;
+	results[position].key_length = key_length;
+
+	if (*result_count < max_results)
+		++(*result_count);
+}
+
+bool QueryCompile(char* query_text, QueryPlan* plan)
+{
+	memset(plan, 0, sizeof(QueryPlan));
+	plan->order_field = QUERY_FIELD_NONE;
+
+	const char* cursor = query_text;
+	char token[QUERY_TOKEN_LENGTH];
+	bool has_token = QueryNextToken(&cursor, token, sizeof token);
+
+	// CONDITIONS: field operator value [and field operator value]...
+	if (has_token && strcmp(token, "order") != 0 && strcmp(token, "limit") != 0)
+	{
+		while (true)
+		{
+			if (plan->condition_count == QUERY_MAX_CONDITIONS)
+			{
+				printf("Query error: more than %d conditions.\n", QUERY_MAX_CONDITIONS);
+				return false;
+			}
+
+			QueryCondition* condition = &(plan->conditions[plan->condition_count++]);
+			condition->field = QueryParseField(token);
+			if (condition->field == QUERY_FIELD_NONE)
+			{
+				printf("Query error: unknown field '%s', use weight, cost, quantity or category.\n", token);
+				return false;
+			}
+
+			if (!QueryNextToken(&cursor, token, sizeof token) || (condition->op = QueryParseOperator(token)) == QUERY_OP_NONE)
+			{
+				printf("Query error: expected =, !=, <, <=, > or >= after the field.\n");
+				return false;
+			}
+
+			if (!QueryNextToken(&cursor, token, sizeof token))
+			{
+				printf("Query error: expected a value after the operator.\n");
+				return false;
+			}
+			if (!QueryParseValue(condition, token))
+				return false;
+
+			has_token = QueryNextToken(&cursor, token, sizeof token);
+			if (!has_token || strcmp(token, "and") != 0)
+				break;
+
+			if (!QueryNextToken(&cursor, token, sizeof token))
+			{
+				printf("Query error: expected a condition after 'and'.\n");
+				return false;
+			}
+		}
+	}
+
+	// ORDER BY field [asc | desc]
+	if (has_token && strcmp(token, "order") == 0)
+	{
+		if (!QueryNextToken(&cursor, token, sizeof token) || strcmp(token, "by") != 0
+			|| !QueryNextToken(&cursor, token, sizeof token) || (plan->order_field = QueryParseField(token)) == QUERY_FIELD_NONE)
+		{
+			printf("Query error: expected 'order by' and weight, cost, quantity or category.\n");
+			return false;
+		}
+
+		has_token = QueryNextToken(&cursor, token, sizeof token);
+		if (has_token && (strcmp(token, "asc") == 0 || strcmp(token, "desc") == 0))
+		{
+			plan->is_descending = (strcmp(token, "desc") == 0);
+			has_token = QueryNextToken(&cursor, token, sizeof token);
+		}
+	}
+
+	// LIMIT count
+	if (has_token && strcmp(token, "limit") == 0)
+	{
+		if (!QueryNextToken(&cursor, token, sizeof token) || !ItemAmountParse(token, &(plan->limit)))
+		{
+			printf("Query error: expected a positive number after 'limit'.\n");
+			return false;
+		}
+		has_token = QueryNextToken(&cursor, token, sizeof token);
+	}
+
+	if (has_token)
+	{
+		printf("Query error: unexpected '%s'.\n", token);
+		return false;
+	}
+
+	for (uint8_t i = 0; i < plan->condition_count; ++i)
+	{
+		if (plan->conditions[i].field == QUERY_FIELD_CATEGORY)
+			plan->needs_categories = true;
+	}
+	if (plan->order_field == QUERY_FIELD_CATEGORY)
+		plan->needs_categories = true;
+
+	return true;
+}
+
+bool QueryNextToken(const char** cursor, char* token, size_t token_size)
+{
+	const char* c = *cursor;
+	while (isspace((unsigned char)*c))
+		++c;
+	if (*c == '\0')
+		return false;
+
+	// AN OPERATOR IS A RUN OF =!<> CHARACTERS, A WORD IS EVERYTHING UNTIL WHITESPACE OR AN OPERATOR: "weight<5" IS THREE TOKENS
+	bool is_operator = (strchr("=!<>", *c) != NULL);
+	size_t length = 0;
+	while (*c != '\0' && !isspace((unsigned char)*c) && (strchr("=!<>", *c) != NULL) == is_operator)
+	{
+		if (length < token_size - 1)
+			token[length++] = (char)tolower((unsigned char)*c);
+		++c;
+	}
+	token[length] = '\0';
+
+	*cursor = c;
+	return true;
+}
+
+uint8_t QueryParseField(char* token)
+{
+	if (strcmp(token, "weight") == 0)
+		return QUERY_FIELD_WEIGHT;
+	else if (strcmp(token, "cost") == 0)
+		return QUERY_FIELD_COST;
+	else if (strcmp(token, "quantity") == 0)
+		return QUERY_FIELD_QUANTITY;
+	else if (strcmp(token, "category") == 0)
+		return QUERY_FIELD_CATEGORY;
+	return QUERY_FIELD_NONE;
+}
+
+uint8_t QueryParseOperator(char* token)
+{
+	if (strcmp(token, "=") == 0 || strcmp(token, "==") == 0)
+		return QUERY_OP_EQUAL;
+	else if (strcmp(token, "!=") == 0 || strcmp(token, "<>") == 0)
+		return QUERY_OP_NOT_EQUAL;
+	else if (strcmp(token, "<") == 0)
+		return QUERY_OP_LESS;
+	else if (strcmp(token, "<=") == 0)
+		return QUERY_OP_LESS_EQUAL;
+	else if (strcmp(token, ">") == 0)
+		return QUERY_OP_GREATER;
+	else if (strcmp(token, ">=") == 0)
+		return QUERY_OP_GREATER_EQUAL;
+	return QUERY_OP_NONE;
+}
+
+bool QueryParseValue(QueryCondition* condition, char* token)
+{
+	switch (condition->field)
+	{
+	case QUERY_FIELD_WEIGHT:
+	{
+		double weight = 0.0;
+		const char* number_end = NumberParseDecimal(token, NULL, &weight);
+		condition->weight = (float)weight;
+		if (number_end == NULL || *number_end != '\0')
+		{
+			printf("Query error: '%s' isn't a weight. Example: weight<5.5\n", token);
+			return false;
+		}
+		return true;
+	}
+	case QUERY_FIELD_COST: // IN COPPER, LIKE THE COST COLUMN. WITHOUT A UNIT THE VALUE IS IN GP
+	{
+		int64_t amount = 0;
+		const char* number_end = NumberParseInteger(token, NULL, &amount);
+		int64_t unit_cp = 10000;
+		if (number_end == NULL)
+			amount = -1;
+		else if (strcmp(number_end, "sp") == 0)
+			unit_cp = 100;
+		else if (strcmp(number_end, "cp") == 0)
+			unit_cp = 1;
+		else if (strcmp(number_end, "gp") != 0 && *number_end != '\0')
+			amount = -1;
+
+		if (amount < 0 || amount > INT64_MAX / unit_cp)
+		{
+			printf("Query error: '%s' isn't a cost. Example: cost>=5gp\n", token);
+			return false;
+		}
+		condition->number = amount * unit_cp;
+		return true;
+	}
+	case QUERY_FIELD_QUANTITY:
+	{
+		int64_t amount = 0;
+		const char* number_end = NumberParseInteger(token, NULL, &amount);
+		if (number_end == NULL || *number_end != '\0' || amount < 0)
+		{
+			printf("Query error: '%s' isn't a quantity. Example: quantity>1\n", token);
+			return false;
+		}
+		condition->number = amount;
+		return true;
+	}
+	case QUERY_FIELD_CATEGORY:
+		if (condition->op != QUERY_OP_EQUAL && condition->op != QUERY_OP_NOT_EQUAL)
+		{
+			printf("Query error: a category can only be compared with = or !=.\n");
+			return false;
+		}
+		snprintf(condition->category, sizeof(condition->category), "%s", token); // THE CATEGORY NUMBER IS ONLY KNOWN WHEN THE QUERY RUNS
+		return true;
+	}
+	return false;
+}
+
+void QueryColumnsBuild(QueryColumns* columns, Inventory* inventory, bool with_categories)
+{
+	// ONE ROW PER ITEM IN THE LIST: THE LIST IS ONLY WALKED WHEN THE INVENTORY CHANGED SINCE THE LAST QUERY
+	if (columns->is_valid && columns->inventory_version == inventory->version && (columns->has_categories || !with_categories))
+		return;
+
+	uint32_t row_count = inventory->stack_count;
+	if (row_count > columns->row_capacity) // GROW EVERY COLUMN
+	{
+		uint32_t new_capacity = (columns->row_capacity == 0) ? 256 : columns->row_capacity;
+		while (new_capacity < row_count)
+			new_capacity *= 2;
+
+		columns->items = (Item**)realloc(columns->items, new_capacity * sizeof(Item*));
+		columns->weights = (float*)realloc(columns->weights, new_capacity * sizeof(float));
+		columns->costs = (int64_t*)realloc(columns->costs, new_capacity * sizeof(int64_t));
+		columns->quantities = (uint32_t*)realloc(columns->quantities, new_capacity * sizeof(uint32_t));
+		columns->categories = (uint16_t*)realloc(columns->categories, new_capacity * sizeof(uint16_t));
+		if (columns->items == NULL || columns->weights == NULL || columns->costs == NULL || columns->quantities == NULL || columns->categories == NULL)
+		{
+			printf("Failed to allocate memory for the query columns!\nExiting program!\n");
+			exit(2);
+		}
+		columns->row_capacity = new_capacity;
+	}
+
+	Item* item = inventory->items;
+	for (uint32_t row = 0; row < row_count; ++row, item = item->next)
+	{
+		while (item->is_removed) // TOMBSTONES THAT WAIT FOR A COMPACTION AREN'T ROWS
+			item = item->next;
+
+		columns->items[row] = item;
+		columns->weights[row] = item->weight;
+		columns->costs[row] = convert_to_cp(&(item->money));
+		columns->quantities[row] = item->quantity;
+		columns->categories[row] = 0;
+
+		if (with_categories) // THE CATEGORY IS A DETAIL: ONLY DECODED WHEN A QUERY USES IT
+		{
+			ItemLoadDetails(item, true);
+			columns->categories[row] = QueryCategoryNumber(columns, item->source + item->equipment_category.offset, item->equipment_category.length, true);
+		}
+	}
+
+	columns->row_count = row_count;
+	columns->inventory_version = inventory->version;
+	columns->has_categories = with_categories;
+	columns->is_valid = true;
+}
+
+uint16_t QueryCategoryNumber(QueryColumns* columns, const char* category, uint32_t category_length, bool is_added)
+{
+	if (is_added && columns->category_count == columns->category_capacity && columns->category_capacity < UINT16_MAX) // GROW THE CATEGORY NAMES, NUMBER 0 IS "NO CATEGORY"
+	{
+		uint16_t new_capacity = (columns->category_capacity == 0) ? 16 : (columns->category_capacity >= UINT16_MAX / 2) ? UINT16_MAX : columns->category_capacity * 2;
+		char (*new_names)[50] = realloc(columns->category_names, new_capacity * sizeof(columns->category_names[0]));
+		if (new_names == NULL)
+		{
+			printf("Failed to allocate memory for the query columns!\nExiting program!\n");
+			exit(2);
+		}
+		columns->category_names = new_names;
+		columns->category_capacity = new_capacity;
+		if (columns->category_count == 0)
+			columns->category_names[columns->category_count++][0] = '\0';
+	}
+
+	if (category_length == 0 || category_length >= sizeof(columns->category_names[0]))
+		return 0;
+
+	for (uint16_t i = 1; i < columns->category_count; ++i) // FEW DIFFERENT CATEGORIES: A LINEAR SEARCH IS FAST ENOUGH
+	{
+		if (strncmp(columns->category_names[i], category, category_length) == 0 && columns->category_names[i][category_length] == '\0')
+			return i;
+	}
+
+	if (!is_added || columns->category_count == columns->category_capacity)
+		return 0;
+
+	uint16_t number = columns->category_count++;
+	memcpy(columns->category_names[number], category, category_length);
+	columns->category_names[number][category_length] = '\0';
+	return number;
+}
+
+uint32_t QueryExecute(QueryPlan* plan, QueryColumns* columns, uint32_t* result_rows)
+{
+	uint16_t category_numbers[QUERY_MAX_CONDITIONS];
+	QueryBindCategories(plan, columns, category_numbers);
+
+	bool is_top_k = plan->limit > 0 && plan->limit <= QUERY_TOP_K_MAX && plan->order_field != QUERY_FIELD_NONE; // KEEP ONLY THE BEST ROWS, SORTED WHILE SCANNING
+	uint32_t result_count = 0;
+
+	uint8_t matches[QUERY_BLOCK_ROWS];
+	for (uint32_t block_start = 0; block_start < columns->row_count; block_start += QUERY_BLOCK_ROWS)
+	{
+		uint32_t block_rows = columns->row_count - block_start;
+		if (block_rows > QUERY_BLOCK_ROWS)
+			block_rows = QUERY_BLOCK_ROWS;
+
+		QueryFilterBlock(plan, columns, category_numbers, block_start, block_rows, matches);
+
+		for (uint32_t i = 0; i < block_rows; ++i)
+		{
+			if (!matches[i])
+				continue;
+
+			uint32_t row = block_start + i;
+			if (is_top_k) // INSERTION INTO THE SORTED RESULTS: A ROW THAT ISN'T BETTER THAN THE LAST ONE IS DROPPED RIGHT AWAY
+			{
+				if (result_count == plan->limit && QueryCompareRows(plan, columns, row, result_rows[result_count - 1]) >= 0)
+					continue;
+
+				uint32_t position = (result_count < plan->limit) ? result_count++ : result_count - 1;
+				while (position > 0 && QueryCompareRows(plan, columns, row, result_rows[position - 1]) < 0)
+				{
+					result_rows[position] = result_rows[position - 1];
+					--position;
+				}
+				result_rows[position] = row;
+			}
+			else
+			{
+				result_rows[result_count++] = row;
+				if (plan->order_field == QUERY_FIELD_NONE && result_count == plan->limit) // NO ORDER: THE FIRST ROWS THAT MATCH ARE THE RESULT
+					return result_count;
+			}
+		}
+	}
+
+	if (!is_top_k && plan->order_field != QUERY_FIELD_NONE)
+	{
+		query_sort_plan = plan;
+		query_sort_columns = columns;
+		qsort(result_rows, result_count, sizeof(uint32_t), QuerySortCompare);
+		if (plan->limit > 0 && result_count > plan->limit)
+			result_count = plan->limit;
+	}
+
+	return result_count;
+}
+
+void QueryBindCategories(QueryPlan* plan, QueryColumns* columns, uint16_t* category_numbers)
+{
+	// BIND THE CATEGORY NAMES TO THEIR NUMBER: THE SCAN ONLY COMPARES 16 BIT NUMBERS
+	for (uint8_t i = 0; i < QUERY_MAX_CONDITIONS; ++i)
+	{
+		category_numbers[i] = 0;
+		if (i < plan->condition_count && plan->conditions[i].field == QUERY_FIELD_CATEGORY)
+			category_numbers[i] = QueryCategoryNumber(columns, plan->conditions[i].category, (uint32_t)strlen(plan->conditions[i].category), false);
+	}
+}
+
+void QueryFilterBlock(QueryPlan* plan, QueryColumns* columns, const uint16_t* category_numbers, uint32_t block_start, uint32_t block_rows, uint8_t* matches)
+{
+	// EVERY CONDITION IS ONE TIGHT LOOP OVER ONE COLUMN OF THE BLOCK, SIMPLE ENOUGH FOR THE COMPILER TO USE SIMD COMPARES
+	memset(matches, 1, block_rows);
+	for (uint8_t i = 0; i < plan->condition_count; ++i)
+	{
+		QueryCondition* condition = &(plan->conditions[i]);
+		switch (condition->field)
+		{
+		case QUERY_FIELD_WEIGHT:
+			QueryFilterFloat(columns->weights + block_start, block_rows, condition->op, condition->weight, matches);
+			break;
+		case QUERY_FIELD_COST:
+			QueryFilterInt64(columns->costs + block_start, block_rows, condition->op, condition->number, matches);
+			break;
+		case QUERY_FIELD_QUANTITY:
+			QueryFilterUint32(columns->quantities + block_start, block_rows, condition->op, (uint32_t)condition->number, matches);
+			break;
+		case QUERY_FIELD_CATEGORY:
+			if (category_numbers[i] == 0 && condition->op == QUERY_OP_EQUAL) // NO ITEM HAS THIS CATEGORY
+				memset(matches, 0, block_rows);
+			else
+				QueryFilterUint16(columns->categories + block_start, block_rows, condition->op, category_numbers[i], matches);
+			break;
+		}
+	}
+}
+
+void QueryFilterFloat(const float* restrict column, uint32_t row_count, uint8_t op, float value, uint8_t* restrict matches)
+{
+	QUERY_FILTER_LOOPS(column, row_count, op, value, matches);
+}
+
+void QueryFilterInt64(const int64_t* restrict column, uint32_t row_count, uint8_t op, int64_t value, uint8_t* restrict matches)
+{
+	QUERY_FILTER_LOOPS(column, row_count, op, value, matches);
+}
+
+void QueryFilterUint32(const uint32_t* restrict column, uint32_t row_count, uint8_t op, uint32_t value, uint8_t* restrict matches)
+{
+	QUERY_FILTER_LOOPS(column, row_count, op, value, matches);
+}
+
+void QueryFilterUint16(const uint16_t* restrict column, uint32_t row_count, uint8_t op, uint16_t value, uint8_t* restrict matches)
+{
+	QUERY_FILTER_LOOPS(column, row_count, op, value, matches);
+}
+
+int QueryCompareRows(QueryPlan* plan, QueryColumns* columns, uint32_t row_a, uint32_t row_b)
+{
+	int compare = 0;
+	switch (plan->order_field)
+	{
+	case QUERY_FIELD_WEIGHT:
+		compare = (columns->weights[row_a] > columns->weights[row_b]) - (columns->weights[row_a] < columns->weights[row_b]);
+		break;
+	case QUERY_FIELD_COST:
+		compare = (columns->costs[row_a] > columns->costs[row_b]) - (columns->costs[row_a] < columns->costs[row_b]);
+		break;
+	case QUERY_FIELD_QUANTITY:
+		compare = (columns->quantities[row_a] > columns->quantities[row_b]) - (columns->quantities[row_a] < columns->quantities[row_b]);
+		break;
+	case QUERY_FIELD_CATEGORY:
+		compare = strcmp(columns->category_names[columns->categories[row_a]], columns->category_names[columns->categories[row_b]]);
+		break;
+	}
+
+	if (plan->is_descending)
+		compare = -compare;
+	if (compare == 0) // EQUAL KEYS KEEP THE ORDER OF THE LIST
+		compare = (row_a > row_b) - (row_a < row_b);
+	return compare;
+}
+
+int QuerySortCompare(const void* row_a, const void* row_b)
+{
+	return QueryCompareRows(query_sort_plan, query_sort_columns, *(const uint32_t*)row_a, *(const uint32_t*)row_b);
+}
+
+void UserItemQuery(Inventory* inventory, QueryColumns* columns, char* query_text)
+{
+	QueryPlan plan;
+	if (!QueryCompile(query_text, &plan))
+		return;
+
+	InventoryLock(inventory);
+	TRACE_BEGIN("Query", query_text);
+	uint64_t start_ns = StatsTimeNs();
+
+	QueryColumnsBuild(columns, inventory, plan.needs_categories);
+
+	uint32_t* result_rows = (uint32_t*)malloc((columns->row_count + 1) * sizeof(uint32_t));
+	if (result_rows == NULL)
+	{
+		printf("Failed to allocate memory for the query results!\nExiting program!\n");
+		exit(2);
+	}
+	uint32_t result_count = QueryExecute(&plan, columns, result_rows);
+	uint64_t query_ns = StatsTimeNs() - start_ns;
+
+	for (uint32_t i = 0; i < result_count; ++i)
+	{
+		uint32_t row = result_rows[i];
+		Item* item = columns->items[row];
+		char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+		NumberFormatWeight(columns->weights[row], weight_text, sizeof weight_text);
+		printf("%.*s (%.*s) x%u, weight: %s, cost: %dgp %dsp %dcp", ITEM_STRING_ARGS(item, name), ITEM_STRING_ARGS(item, index), columns->quantities[row],
+			weight_text, item->money.gp, item->money.sp, item->money.cp);
+		if (columns->has_categories)
+			printf(", category: %s", columns->category_names[columns->categories[row]]);
+		printf("\n");
+	}
+	printf("%u of %u items match (%llu us).\n", result_count, columns->row_count, (unsigned long long)(query_ns / 1000));
+
+	free(result_rows);
+	TRACE_END("Query");
+	InventoryUnlock(inventory);
+}
+
+bool ValuationCompile(char* valuation_text, ValuationPlan* plan)
+{
+	memset(plan, 0, sizeof(ValuationPlan));
+
+	const char* cursor = valuation_text;
+	char token[QUERY_TOKEN_LENGTH];
+	if (QueryNextToken(&cursor, token, sizeof token)) // NOTHING ENTERED: THE TOTAL OF THE WHOLE INVENTORY
+	{
+		if (strcmp(token, "markup") == 0)
+		{
+			double percent = 0.0;
+			const char* number_end = QueryNextToken(&cursor, token, sizeof token) ? NumberParseDecimal(token, NULL, &percent) : NULL;
+			if (number_end != NULL && *number_end == '%')
+				++number_end;
+			if (number_end == NULL || *number_end != '\0' || percent < VALUATION_PERCENT_MIN || percent > VALUATION_PERCENT_MAX)
+			{
+				printf("Valuation error: expected a percent from %d to %d after 'markup'. Example: markup 12.5\n", VALUATION_PERCENT_MIN, VALUATION_PERCENT_MAX);
+				return false;
+			}
+			plan->is_repricing = true;
+			plan->basis_points = (int32_t)(percent * 100.0 + ((percent < 0.0) ? -0.5 : 0.5));
+		}
+		else if (strcmp(token, "total") != 0)
+		{
+			printf("Valuation error: expected 'total' or 'markup', not '%s'.\n", token);
+			return false;
+		}
+	}
+
+	// THE REST ARE THE CONDITIONS OF A QUERY: THE SAME FIELDS AND OPERATORS AS THE F COMMAND
+	if (!QueryCompile((char*)cursor, &(plan->query)))
+		return false;
+	if (plan->query.order_field != QUERY_FIELD_NONE || plan->query.limit != 0)
+	{
+		printf("Valuation error: 'order by' and 'limit' don't apply, every matching item is valued.\n");
+		return false;
+	}
+	return true;
+}
+
+int64_t ValuationTotal(const int64_t* restrict costs, const uint32_t* restrict quantities, const uint8_t* restrict matches, uint32_t row_count)
+{
+#ifdef VALUATION_SSE2
+	// SSE2 HAS NO 64 BIT MULTIPLY: cost * quantity = low32(cost) * quantity + (high32(cost) * quantity << 32), TWO ROWS AT A TIME
+	__m128i sum = _mm_setzero_si128();
+	uint32_t row = 0;
+	for (; row + 2 <= row_count; row += 2)
+	{
+		__m128i cost = _mm_loadu_si128((const __m128i*)(costs + row));
+		__m128i quantity = _mm_set_epi64x(quantities[row + 1], quantities[row]);
+		__m128i mask = _mm_set_epi64x(-(int64_t)matches[row + 1], -(int64_t)matches[row]);
+		__m128i low = _mm_mul_epu32(cost, quantity);
+		__m128i high = _mm_mul_epu32(_mm_srli_epi64(cost, 32), quantity);
+		__m128i value = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+		sum = _mm_add_epi64(sum, _mm_and_si128(value, mask));
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i*)lanes, sum);
+	return (int64_t)(lanes[0] + lanes[1]) + ValuationTotalScalar(costs + row, quantities + row, matches + row, row_count - row);
+#else
+	return ValuationTotalScalar(costs, quantities, matches, row_count);
+#endif
+}
+
+int64_t ValuationTotalScalar(const int64_t* restrict costs, const uint32_t* restrict quantities, const uint8_t* restrict matches, uint32_t row_count)
+{
+	// UNSIGNED MATH WRAPS LIKE THE SSE2 LANES: BOTH KERNELS GIVE THE SAME SUM
+	uint64_t sum = 0;
+	for (uint32_t row = 0; row < row_count; ++row)
+		sum += ((uint64_t)costs[row] * quantities[row]) & (0 - (uint64_t)matches[row]);
+	return (int64_t)sum;
+}
+
+void ValuationScale(int64_t* restrict costs, const uint8_t* restrict matches, uint32_t row_count, int32_t basis_points)
+{
+	uint32_t row = 0;
+#ifdef VALUATION_SSE2
+	// PRICES BELOW 2^32 cp: cost * factor < 2^53 IS AN EXACT DOUBLE, THE DIVISION IS OFF BY LESS THAN THE 1/10000 STEPS OF THE QUOTIENT
+	// AND ADDING 2^52 ROUNDS IT HALF TO EVEN. THE INTEGER <=> DOUBLE CONVERSIONS ARE THE SAME 2^52 TRICK (SSE2 HAS NO 64 BIT CONVERSION)
+	const __m128i magic_bits = _mm_set1_epi64x(0x4330000000000000LL);
+	const __m128d magic = _mm_set1_pd(4503599627370496.0); // 2^52
+	const __m128d factor = _mm_set1_pd(10000.0 + basis_points);
+	const __m128d divisor = _mm_set1_pd(10000.0);
+	for (; row + 2 <= row_count; row += 2)
+	{
+		if ((uint64_t)costs[row] > UINT32_MAX || (uint64_t)costs[row + 1] > UINT32_MAX) // A NEGATIVE OR HUGE PRICE: EXACT INTEGER MATH
+		{
+			if (matches[row])
+				costs[row] = ValuationScaleCost(costs[row], basis_points);
+			if (matches[row + 1])
+				costs[row + 1] = ValuationScaleCost(costs[row + 1], basis_points);
+			continue;
+		}
+
+		__m128i cost = _mm_loadu_si128((const __m128i*)(costs + row));
+		__m128d value = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(cost, magic_bits)), magic);
+		value = _mm_add_pd(_mm_div_pd(_mm_mul_pd(value, factor), divisor), magic);
+		__m128i scaled = _mm_sub_epi64(_mm_castpd_si128(value), magic_bits);
+
+		__m128i mask = _mm_set_epi64x(-(int64_t)matches[row + 1], -(int64_t)matches[row]);
+		cost = _mm_or_si128(_mm_and_si128(mask, scaled), _mm_andnot_si128(mask, cost));
+		_mm_storeu_si128((__m128i*)(costs + row), cost);
+	}
+#endif
+	for (; row < row_count; ++row)
+	{
+		if (matches[row])
+			costs[row] = ValuationScaleCost(costs[row], basis_points);
+	}
+}
+
+int64_t ValuationScaleCost(int64_t cost, int32_t basis_points)
+{
+	if (cost <= 0)
+		return cost;
+
+	// cost = whole * 10000 + part: NEITHER PRODUCT OVERFLOWS BEFORE THE MONEY_MAX_CP CHECK
+	int64_t factor = 10000 + basis_points;
+	int64_t whole = cost / 10000;
+	int64_t part = cost % 10000;
+	if (factor > 0 && whole > MONEY_MAX_CP / factor)
+		return MONEY_MAX_CP;
+
+	int64_t scaled = whole * factor + (part * factor) / 10000;
+	int64_t remainder = (part * factor) % 10000;
+	if (remainder > 5000 || (remainder == 5000 && (scaled & 1)))
+		++scaled;
+	return (scaled > MONEY_MAX_CP) ? MONEY_MAX_CP : scaled;
+}
+
+void ValuationPrintMoney(int64_t total_cp)
+{
+	printf("%lldgp %lldsp %lldcp", (long long)(total_cp / 10000), (long long)(total_cp / 100 % 100), (long long)(total_cp % 100));
+}
+
+void UserItemValuation(Inventory* inventory, QueryColumns* columns, char* valuation_text)
+{
+	ValuationPlan plan;
+	if (!ValuationCompile(valuation_text, &plan))
+		return;
+
+	InventoryLock(inventory);
+	TRACE_BEGIN("Valuation", valuation_text);
+	uint64_t start_ns = StatsTimeNs();
+
+	QueryColumnsBuild(columns, inventory, plan.query.needs_categories);
+	uint16_t category_numbers[QUERY_MAX_CONDITIONS];
+	QueryBindCategories(&(plan.query), columns, category_numbers);
+
+	// THE COST COLUMN IS THE PACKED COPPER ARRAY: THE KERNELS RUN OVER ONE BLOCK OF MATCH FLAGS AT A TIME, LIKE A QUERY
+	uint8_t matches[QUERY_BLOCK_ROWS];
+	uint64_t version_before = inventory->version;
+	uint32_t match_count = 0;
+	uint64_t item_count = 0;
+	int64_t value_before = 0;
+	int64_t value_after = 0;
+	for (uint32_t block_start = 0; block_start < columns->row_count; block_start += QUERY_BLOCK_ROWS)
+	{
+		uint32_t block_rows = columns->row_count - block_start;
+		if (block_rows > QUERY_BLOCK_ROWS)
+			block_rows = QUERY_BLOCK_ROWS;
+
+		QueryFilterBlock(&(plan.query), columns, category_numbers, block_start, block_rows, matches);
+		for (uint32_t row = 0; row < block_rows; ++row)
+		{
+			match_count += matches[row];
+			item_count += (matches[row]) ? columns->quantities[block_start + row] : 0;
+		}
+
+		value_before += ValuationTotal(columns->costs + block_start, columns->quantities + block_start, matches, block_rows);
+		if (plan.is_repricing)
+		{
+			ValuationScale(columns->costs + block_start, matches, block_rows, plan.basis_points);
+			value_after += ValuationTotal(columns->costs + block_start, columns->quantities + block_start, matches, block_rows);
+
+			// THE ITEMS KEEP THEIR PRICE AS MONEY: ONLY THE CHANGED ROWS ARE WRITTEN BACK. ONE NEW VERSION FOR ALL OF THEM
+			for (uint32_t row = 0; row < block_rows; ++row)
+			{
+				if (matches[row])
+				{
+					inventory->version = version_before + 1;
+					columns->items[block_start + row]->money = convert_from_cp(columns->costs[block_start + row]);
+					InventoryLogChange(inventory, CHANGE_PRICE, columns->items[block_start + row], 0);
+				}
+			}
+		}
+	}
+
+	if (inventory->version != version_before)
+	{
+		columns->inventory_version = inventory->version; // THE COLUMNS WERE CHANGED IN PLACE: NO REBUILD FOR THE NEXT QUERY
+		InventoryPublish(inventory, true);
+	}
+	uint64_t valuation_ns = StatsTimeNs() - start_ns;
+
+	int32_t basis_points = (plan.basis_points < 0) ? -plan.basis_points : plan.basis_points;
+	if (plan.is_repricing)
+	{
+		printf("Repriced %u of %u item stacks by %c%d.%02d%%, value of their %llu items: ", match_count, columns->row_count, (plan.basis_points < 0) ? '-' : '+',
+			basis_points / 100, basis_points % 100, (unsigned long long)item_count);
+		ValuationPrintMoney(value_before);
+		printf(" => ");
+		ValuationPrintMoney(value_after);
+	}
+	else
+	{
+		printf("Value of %u of %u item stacks (%llu items): ", match_count, columns->row_count, (unsigned long long)item_count);
+		ValuationPrintMoney(value_before);
+	}
+	printf(" (%llu us).\n", (unsigned long long)(valuation_ns / 1000));
+
+	TRACE_END("Valuation");
+	InventoryUnlock(inventory);
+}
+
+bool InventoryExport(Inventory* inventory, int reader, char* file_path)
+{
+	TRACE_BEGIN("InventoryExport", file_path);
+	uint64_t start_ns = StatsTimeNs();
+	uint8_t format = ExportFormatFromFileName(file_path);
+
+	ExportWriter writer; // THE BUFFER ISN'T CLEARED: ONLY THE BYTES BEFORE length ARE WRITTEN
+	writer.bytes_written = 0;
+	writer.length = 0;
+	writer.is_failed = false;
+	writer.file = StatsFileOpen(file_path, "wb"); // BINARY MODE: THE LINE ENDS ARE WRITTEN AS THEY ARE, ALSO ON WINDOWS
+	if (writer.file == NULL)
+	{
+		printf("Failed to open export file %s! Nothing is exported.\n", file_path);
+		TRACE_END("InventoryExport");
+		return false;
+	}
+
+	// THE LOADER CAN KEEP PUSHING: THE EXPORT IS ONE CONSISTENT STATE AND THE LOCK ISN'T HELD WHILE WRITING
+	InventorySnapshot* snapshot = InventorySnapshotAcquire(inventory, reader);
+	if (format == EXPORT_FORMAT_CSV)
+		ExportWrite(&writer, "index,name,quantity,weight,cost_gp,cost_sp,cost_cp\r\n", sizeof "index,name,quantity,weight,cost_gp,cost_sp,cost_cp\r\n" - 1);
+	for (uint32_t i = 0; i < snapshot->stack_count && !writer.is_failed; ++i)
+		ExportWriteRow(&writer, format, snapshot, &(snapshot->rows[i]));
+	uint32_t item_count = snapshot->item_count;
+	uint32_t stack_count = snapshot->stack_count;
+	InventorySnapshotRelease(inventory, reader);
+
+	ExportFlush(&writer);
+	bool is_closed = (StatsFileClose(writer.file) == 0);
+	TRACE_END("InventoryExport");
+
+	if (writer.is_failed || !is_closed)
+	{
+		printf("Failed to write export file %s! The file is incomplete.\n", file_path);
+		return false;
+	}
+
+	printf("Exported %u items (%u different) to %s as %s: %llu bytes in %llu us.\n", item_count, stack_count, file_path, (format == EXPORT_FORMAT_CSV) ? "CSV" : "JSON Lines",
+		(unsigned long long)writer.bytes_written, (unsigned long long)((StatsTimeNs() - start_ns) / 1000));
+	return true;
+}
+
+uint8_t ExportFormatFromFileName(char* file_path)
+{
+	size_t length = strlen(file_path);
+	if (length >= 4 && file_path[length - 4] == '.' && tolower((unsigned char)file_path[length - 3]) == 'c' && tolower((unsigned char)file_path[length - 2]) == 's' && tolower((unsigned char)file_path[length - 1]) == 'v')
+		return EXPORT_FORMAT_CSV;
+	return EXPORT_FORMAT_JSON_LINES;
+}
+
+void ExportWrite(ExportWriter* writer, const void* data, uint32_t size)
+{
+	if ((uint64_t)writer->length + size > EXPORT_BUFFER_SIZE)
+	{
+		ExportFlush(writer);
+		if (size > EXPORT_BUFFER_SIZE) // BIGGER THAN THE WHOLE BUFFER: WRITTEN RIGHT AWAY
+		{
+			if (!writer->is_failed && StatsFileWrite(data, 1, size, writer->file) != size)
+				writer->is_failed = true;
+			writer->bytes_written += size;
+			return;
+		}
+	}
+
+	memcpy(writer->buffer + writer->length, data, size);
+	writer->length += size;
+}
+
+void ExportFlush(ExportWriter* writer)
+{
+	if (writer->length > 0 && !writer->is_failed && StatsFileWrite(writer->buffer, 1, writer->length, writer->file) != writer->length)
+		writer->is_failed = true;
+	writer->bytes_written += writer->length;
+	writer->length = 0;
+}
+
+void ExportWriteUnsigned(ExportWriter* writer, uint64_t value)
+{
+	char digits[20]; // UINT64_MAX HAS 20 DIGITS
+	uint32_t digit_count = 0;
+	do
+	{
+		digits[sizeof digits - 1 - digit_count++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+
+	ExportWrite(writer, digits + sizeof digits - digit_count, digit_count);
+}
+
+void ExportWriteSigned(ExportWriter* writer, int64_t value)
+{
+	if (value < 0)
+	{
+		ExportWrite(writer, "-", 1);
+		ExportWriteUnsigned(writer, 0 - (uint64_t)value);
+	}
+	else
+		ExportWriteUnsigned(writer, (uint64_t)value);
+}
+
+void ExportWriteJsonString(ExportWriter* writer, const char* text, uint32_t length)
+{
+	static const char hex_digits[] = "0123456789abcdef";
+
+	ExportWrite(writer, "\"", 1);
+	uint32_t run_start = 0; // THE BYTES THAT NEED NO ESCAPE ARE WRITTEN IN ONE PIECE
+	for (uint32_t i = 0; i < length; ++i)
+	{
+		unsigned char c = (unsigned char)text[i];
+		if (c == '\\' && i + 1 < length && text[i + 1] != '\0' && strchr("\"\\/bfnrt", text[i + 1]) != NULL) // A VALID ESCAPE SEQUENCE OF THE JSON TEXT: COPIED AS IT IS
+		{
+			++i;
+		}
+		else if (c == '\\' && i + 5 < length && text[i + 1] == 'u' && ExportHexValue(text + i + 2) >= 0)
+		{
+			i += 5;
+		}
+		else if (c == '"' || c == '\\' || c < 0x20)
+		{
+			ExportWrite(writer, text + run_start, i - run_start);
+			char escape[6] = { '\\', (char)c, '0', '0', '0', '0' };
+			if (c < 0x20)
+			{
+				escape[1] = 'u';
+				escape[4] = hex_digits[c >> 4];
+				escape[5] = hex_digits[c & 0x0F];
+			}
+			ExportWrite(writer, escape, (c < 0x20) ? 6 : 2);
+			run_start = i + 1;
+		}
+	}
+	ExportWrite(writer, text + run_start, length - run_start);
+	ExportWrite(writer, "\"", 1);
+}
+
+void ExportWriteCsvField(ExportWriter* writer, const char* text, uint32_t length)
+{
+	bool is_quoted = false; // AN ESCAPE SEQUENCE CAN BECOME A QUOTE OR A NEW LINE
+	for (uint32_t i = 0; i < length && !is_quoted; ++i)
+		is_quoted = (text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r' || text[i] == '\\');
+	if (!is_quoted)
+	{
+		ExportWrite(writer, text, length);
+		return;
+	}
+
+	ExportWrite(writer, "\"", 1);
+	uint32_t run_start = 0;
+	for (uint32_t i = 0; i < length; ++i)
+	{
+		if (text[i] == '"') // A QUOTE IN A QUOTED FIELD IS DOUBLED
+		{
+			ExportWrite(writer, text + run_start, i + 1 - run_start);
+			ExportWrite(writer, "\"", 1);
+			run_start = i + 1;
+		}
+		else if (text[i] == '\\' && i + 1 < length)
+		{
+			ExportWrite(writer, text + run_start, i - run_start);
+			char decoded[4];
+			uint32_t decoded_length = 1;
+			uint32_t escape_length = 2;
+			switch (text[i + 1])
+			{
+			case '"':  decoded[0] = '"'; decoded[1] = '"'; decoded_length = 2; break;
+			case '\\': decoded[0] = '\\'; break;
+			case '/':  decoded[0] = '/'; break;
+			case 'b':  decoded[0] = '\b'; break;
+			case 'f':  decoded[0] = '\f'; break;
+			case 'n':  decoded[0] = '\n'; break;
+			case 'r':  decoded[0] = '\r'; break;
+			case 't':  decoded[0] = '\t'; break;
+			case 'u':
+			{
+				int32_t code_point = (i + 5 < length) ? ExportHexValue(text + i + 2) : -1;
+				if (code_point < 0) // NOT AN ESCAPE SEQUENCE: THE BACKSLASH STAYS
+				{
+					decoded[0] = '\\';
+					escape_length = 1;
+					break;
+				}
+				escape_length = 6;
+				if (code_point >= 0xD800 && code_point <= 0xDBFF) // HIGH SURROGATE: TOGETHER WITH THE LOW SURROGATE THAT FOLLOWS IT ONE CODE POINT ABOVE 0xFFFF
+				{
+					int32_t low_surrogate = (i + 11 < length && text[i + 6] == '\\' && text[i + 7] == 'u') ? ExportHexValue(text + i + 8) : -1;
+					if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF)
+					{
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+						escape_length = 12;
+					}
+					else
+						code_point = 0xFFFD;
+				}
+				else if (code_point >= 0xDC00 && code_point <= 0xDFFF) // A LOW SURROGATE ON ITS OWN ISN'T A CHARACTER
+					code_point = 0xFFFD;
+
+				// UTF-8
+				if (code_point < 0x80)
+					decoded[0] = (char)code_point;
+				else if (code_point < 0x800)
+				{
+					decoded[0] = (char)(0xC0 | (code_point >> 6));
+					decoded[1] = (char)(0x80 | (code_point & 0x3F));
+					decoded_length = 2;
+				}
+				else if (code_point < 0x10000)
+				{
+					decoded[0] = (char)(0xE0 | (code_point >> 12));
+					decoded[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+					decoded[2] = (char)(0x80 | (code_point & 0x3F));
+					decoded_length = 3;
+				}
+				else
+				{
+					decoded[0] = (char)(0xF0 | (code_point >> 18));
+					decoded[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+					decoded[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+					decoded[3] = (char)(0x80 | (code_point & 0x3F));
+					decoded_length = 4;
+				}
+				break;
+			}
+			default: // NOT AN ESCAPE SEQUENCE: THE BACKSLASH STAYS
+				decoded[0] = '\\';
+				escape_length = 1;
+				break;
+			}
+			ExportWrite(writer, decoded, decoded_length);
+			i += escape_length - 1;
+			run_start = i + 1;
+		}
+	}
+	ExportWrite(writer, text + run_start, length - run_start);
+	ExportWrite(writer, "\"", 1);
+}
+
+void ExportWriteRow(ExportWriter* writer, uint8_t format, InventorySnapshot* snapshot, SnapshotRow* row)
+{
+	char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+	uint32_t weight_length = (uint32_t)NumberFormatWeight(row->weight, weight_text, sizeof weight_text);
+	const char* index = snapshot->string_pool + row->index_offset;
+	const char* name = snapshot->string_pool + row->name_offset;
+
+	if (format == EXPORT_FORMAT_CSV)
+	{
+		ExportWriteCsvField(writer, index, row->index_length);
+		ExportWrite(writer, ",", 1);
+		ExportWriteCsvField(writer, name, row->name_length);
+		ExportWrite(writer, ",", 1);
+		ExportWriteUnsigned(writer, row->quantity);
+		ExportWrite(writer, ",", 1);
+		ExportWrite(writer, weight_text, weight_length);
+		ExportWrite(writer, ",", 1);
+		ExportWriteSigned(writer, row->money.gp);
+		ExportWrite(writer, ",", 1);
+		ExportWriteSigned(writer, row->money.sp);
+		ExportWrite(writer, ",", 1);
+		ExportWriteSigned(writer, row->money.cp);
+		ExportWrite(writer, "\r\n", 2);
+	}
+	else
+	{
+		ExportWrite(writer, "{\"index\":", 9);
+		ExportWriteJsonString(writer, index, row->index_length);
+		ExportWrite(writer, ",\"name\":", 8);
+		ExportWriteJsonString(writer, name, row->name_length);
+		ExportWrite(writer, ",\"quantity\":", 12);
+		ExportWriteUnsigned(writer, row->quantity);
+		ExportWrite(writer, ",\"weight\":", 10);
+		ExportWrite(writer, weight_text, weight_length);
+		ExportWrite(writer, ",\"cost\":{\"gp\":", 14);
+		ExportWriteSigned(writer, row->money.gp);
+		ExportWrite(writer, ",\"sp\":", 6);
+		ExportWriteSigned(writer, row->money.sp);
+		ExportWrite(writer, ",\"cp\":", 6);
+		ExportWriteSigned(writer, row->money.cp);
+		ExportWrite(writer, "}}\n", 3);
+	}
+}
+
+int32_t ExportHexValue(const char* hex)
+{
+	int32_t value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		char c = hex[i];
+		int32_t digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+		if (digit < 0)
+			return -1;
+		value = value * 16 + digit;
+	}
+	return value;
+}
+
+void InventoryRestore(Inventory* inventory, char* save_path)
+{
+	inventory->changes.is_enabled = true;
+	if (StatsFileAccess(save_path, 0) != 0) // A NEW CAMP: ITS CHANGE LOG STARTS AT VERSION 0
+	{
+		uint64_t seed[2] = { StatsTimeNs(), (uint64_t)(uintptr_t)inventory };
+		inventory->changes.lineage = HashFnv1a((const char*)seed, sizeof seed, HASH_FNV1A_SEED);
+		printf("New camp: it is saved to %s when the program quits.\n", save_path);
+		return;
+	}
+
+	SaveState state = { 0 };
+	if (!SaveStateLoad(save_path, &state, &(inventory->changes)))
+	{
+		printf("The save file isn't overwritten.\nExiting program!\n");
+		exit(3);
+	}
+	inventory->changes.is_enabled = true;
+
+	// THE STACKS ARE MADE LIKE PARSE CACHE ITEMS: THE SOURCE ONLY HOLDS THE INDEX AND THE NAME, THE JSON FILE IS NOT OPENED UNTIL THE DETAILS ARE NEEDED
+	for (uint32_t row_number = 0; row_number < state.row_count; ++row_number)
+	{
+		SaveRow* row = &(state.rows[row_number]);
+		const char* strings = state.strings + row->index_offset;
+		Item* item = ItemCreate();
+
+		uint32_t strings_length = row->index_length + row->name_length;
+		item->source = (char*)malloc(strings_length + 1);
+		if (item->source == NULL)
+		{
+			printf("Failed to allocate memory for a new Item!\nExiting program!\n");
+			exit(2);
+		}
+		memcpy(item->source, strings, strings_length);
+		item->source[strings_length] = '\0';
+		item->source_length = strings_length;
+		item->is_source_cached = true;
+		StatsItemBytesAdd(strings_length + 1);
+
+		item->index.offset = 0;
+		item->index.length = row->index_length;
+		item->name.offset = row->index_length;
+		item->name.length = row->name_length;
+		snprintf(item->file_name, sizeof item->file_name, "%.*s", (int)row->file_name_length, strings + strings_length);
+		item->weight = row->weight;
+		item->money = convert_from_cp(row->cost);
+		item->quantity = row->quantity;
+
+		InventoryAppendStack(inventory, item);
+		inventory->item_count += row->quantity;
+	}
+
+	inventory->version = state.version;
+	inventory->money = convert_from_cp(state.money);
+	inventory->max_weight = state.max_weight;
+	printf("Camp restored from %s: %u items in %u stacks, version %llu.\n", save_path, inventory->item_count, inventory->stack_count, (unsigned long long)state.version);
+	SaveStateFree(&state);
+}
+
+bool InventorySave(Inventory* inventory, char* save_path)
+{
+	TRACE_BEGIN("InventorySave", save_path);
+	SaveState state = { 0 };
+	state.version = inventory->version;
+	state.max_weight = inventory->max_weight;
+	state.money = convert_to_cp(&(inventory->money));
+
+	uint32_t node_count = inventory->stack_count + inventory->removed_count;
+	Item* item = inventory->items;
+	for (uint32_t node = 0; node < node_count; ++node, item = item->next)
+	{
+		if (item->is_removed)
+			continue;
+
+		ChangeRecord record = { 0 }; // THE ROW OF A STACK IS MADE LIKE THE PUSH OF ALL ITS COPIES
+		record.index_length = (uint16_t)item->index.length;
+		record.name_length = (uint16_t)item->name.length;
+		record.file_name_length = (uint16_t)strlen(item->file_name);
+		record.weight = item->weight;
+		record.cp = convert_to_cp(&(item->money));
+		SaveRow* row = SaveStateAddRow(&state, &record, item->source + item->index.offset, item->source + item->name.offset, item->file_name);
+		row->quantity = item->quantity;
+	}
+
+	ChangeLog* log = &(inventory->changes);
+	uint32_t first_record = ChangeLogTrim(log);
+	bool is_saved = SaveStateWrite(save_path, &state, log, first_record);
+	if (is_saved)
+		printf("Camp saved to %s: version %llu, %u changes are kept for delta sync.\n", save_path, (unsigned long long)state.version, log->count - first_record);
+
+	SaveStateFree(&state);
+	TRACE_END("InventorySave");
+	return is_saved;
+}
+
+void InventoryLogChange(Inventory* inventory, uint8_t kind, Item* item, uint32_t amount)
+{
+	ChangeLog* log = &(inventory->changes);
+	if (!log->is_enabled)
+		return;
+
+	ChangeRecord record = { 0 };
+	record.version = inventory->version;
+	record.kind = kind;
+	record.amount = amount;
+	if (kind == CHANGE_MONEY) // THE NEW TOTALS, NOT THE DIFFERENCE
+	{
+		record.cp = convert_to_cp(&(inventory->money));
+		record.weight = inventory->max_weight;
+		ChangeLogAdd(log, &record, NULL, NULL, NULL);
+		return;
+	}
+
+	record.cp = convert_to_cp(&(item->money));
+	record.weight = item->weight;
+	record.index_length = (uint16_t)item->index.length;
+	if (kind == CHANGE_PUSH) // A PUSH CAN MAKE A NEW STACK ON THE OTHER MACHINE: IT NEEDS THE NAME AND THE FILE TOO
+	{
+		record.name_length = (uint16_t)item->name.length;
+		record.file_name_length = (uint16_t)strlen(item->file_name);
+	}
+	ChangeLogAdd(log, &record, item->source + item->index.offset, item->source + item->name.offset, item->file_name);
+}
+
+void ChangeLogAdd(ChangeLog* log, ChangeRecord* record, const char* index, const char* name, const char* file_name)
+{
+	if (log->count == log->capacity) // GROW THE RECORD ARRAY
+	{
+		uint32_t new_capacity = (log->capacity == 0) ? 64 : log->capacity * 2;
+		ChangeRecord* new_records = (ChangeRecord*)realloc(log->records, new_capacity * sizeof(ChangeRecord));
+		if (new_records == NULL)
+		{
+			printf("Failed to allocate memory for the change log!\nExiting program!\n");
+			exit(2);
+		}
+		log->records = new_records;
+		log->capacity = new_capacity;
+	}
+
+	// THE STRINGS OF A RECORD LIE ONE AFTER THE OTHER: ONE OFFSET FINDS ALL THREE
+	ChangeRecord* new_record = &(log->records[log->count]);
+	*new_record = *record;
+	new_record->index_offset = log->strings_length;
+	if (record->index_length > 0)
+		BufferAppend(&(log->strings), &(log->strings_length), &(log->strings_capacity), index, record->index_length);
+	if (record->name_length > 0)
+		BufferAppend(&(log->strings), &(log->strings_length), &(log->strings_capacity), name, record->name_length);
+	if (record->file_name_length > 0)
+		BufferAppend(&(log->strings), &(log->strings_length), &(log->strings_capacity), file_name, record->file_name_length);
+	++(log->count);
+}
+
+void ChangeLogAddCopy(ChangeLog* log, ChangeRecord* record, const char* strings)
+{
+	const char* index = (strings != NULL) ? strings + record->index_offset : "";
+	ChangeLogAdd(log, record, index, index + record->index_length, index + record->index_length + record->name_length);
+}
+
+uint32_t ChangeLogTrim(ChangeLog* log)
+{
+	if (log->count <= CHANGE_LOG_MAX_RECORDS)
+		return 0;
+
+	// A DELTA STARTS BETWEEN TWO VERSIONS: THE RECORDS OF ONE VERSION ARE KEPT OR DROPPED TOGETHER
+	uint32_t first_record = log->count - CHANGE_LOG_MAX_RECORDS;
+	while (first_record < log->count && log->records[first_record].version == log->records[first_record - 1].version)
+		++first_record;
+	return first_record;
+}
+
+void ChangeLogFree(ChangeLog* log)
+{
+	free(log->records);
+	free(log->strings);
+	log->records = NULL;
+	log->strings = NULL;
+	log->count = log->capacity = 0;
+	log->strings_length = log->strings_capacity = 0;
+}
+
+bool SaveStateLoad(char* save_path, SaveState* state, ChangeLog* log)
+{
+	SyncBuffer buffer = { 0 };
+	if (!SyncLoadFile(save_path, &buffer, SAVE_MAGIC, SAVE_VERSION))
+		return false;
+
+	log->lineage = SyncReadFixed64(&buffer);
+	state->version = SyncReadVarint(&buffer);
+	log->start_version = SyncReadVarint(&buffer);
+	state->max_weight = SyncReadFloat(&buffer);
+	state->money = SyncReadSigned(&buffer);
+
+	uint64_t row_count = SyncReadVarint(&buffer);
+	for (uint64_t row_number = 0; row_number < row_count && !buffer.is_failed; ++row_number)
+	{
+		ChangeRecord record = { 0 };
+		const char* index = SyncReadString(&buffer, &(record.index_length));
+		const char* name = SyncReadString(&buffer, &(record.name_length));
+		const char* file_name = SyncReadString(&buffer, &(record.file_name_length));
+		record.weight = SyncReadFloat(&buffer);
+		record.cp = SyncReadSigned(&buffer);
+		uint64_t quantity = SyncReadVarint(&buffer);
+		if (buffer.is_failed || quantity == 0 || quantity > UINT32_MAX || SaveStateFind(state, index, record.index_length) != NULL)
+		{
+			buffer.is_failed = true;
+			break;
+		}
+		SaveStateAddRow(state, &record, index, name, file_name)->quantity = (uint32_t)quantity;
+	}
+
+	uint64_t record_count = SyncReadVarint(&buffer);
+	uint64_t previous_version = log->start_version;
+	for (uint64_t record_number = 0; record_number < record_count && !buffer.is_failed; ++record_number)
+		SyncReadRecord(&buffer, log, &previous_version);
+
+	bool is_loaded = !buffer.is_failed && buffer.position == buffer.length;
+	if (!is_loaded)
+		printf("The save file %s is corrupted!\n", save_path);
+	free(buffer.data);
+	return is_loaded;
+}
+
+bool SaveStateWrite(char* save_path, SaveState* state, ChangeLog* log, uint32_t first_record)
+{
+	SyncBuffer buffer = { 0 };
+	uint8_t format_version = SAVE_VERSION;
+	SyncWriteBytes(&buffer, SAVE_MAGIC, 4);
+	SyncWriteBytes(&buffer, &format_version, 1);
+	SyncWriteFixed64(&buffer, log->lineage);
+	SyncWriteVarint(&buffer, state->version);
+
+	// THE DROPPED RECORDS MOVE THE START OF THE LOG: A DELTA FROM AN OLDER VERSION IS A STATE DIFF
+	uint64_t start_version = (first_record > 0) ? log->records[first_record - 1].version : log->start_version;
+	SyncWriteVarint(&buffer, start_version);
+	SyncWriteFloat(&buffer, state->max_weight);
+	SyncWriteSigned(&buffer, state->money);
+
+	uint32_t row_count = 0;
+	for (uint32_t row_number = 0; row_number < state->row_count; ++row_number)
+		row_count += (state->rows[row_number].quantity > 0);
+	SyncWriteVarint(&buffer, row_count);
+	for (uint32_t row_number = 0; row_number < state->row_count; ++row_number)
+	{
+		SaveRow* row = &(state->rows[row_number]);
+		if (row->quantity == 0)
+			continue;
+
+		const char* strings = state->strings + row->index_offset;
+		SyncWriteString(&buffer, strings, row->index_length);
+		SyncWriteString(&buffer, strings + row->index_length, row->name_length);
+		SyncWriteString(&buffer, strings + row->index_length + row->name_length, row->file_name_length);
+		SyncWriteFloat(&buffer, row->weight);
+		SyncWriteSigned(&buffer, row->cost);
+		SyncWriteVarint(&buffer, row->quantity);
+	}
+
+	SyncWriteVarint(&buffer, log->count - first_record);
+	uint64_t previous_version = start_version;
+	for (uint32_t record_number = first_record; record_number < log->count; ++record_number)
+		SyncWriteRecord(&buffer, &(log->records[record_number]), log->strings, &previous_version);
+
+	bool is_written = SyncWriteFile(save_path, &buffer);
+	free(buffer.data);
+	return is_written;
+}
+
+SaveRow* SaveStateAddRow(SaveState* state, ChangeRecord* record, const char* index, const char* name, const char* file_name)
+{
+	if (state->row_count * 2 >= state->slot_count) // GROW AND REFILL THE HASH TABLE
+	{
+		uint32_t new_slot_count = (state->slot_count == 0) ? 256 : state->slot_count * 2;
+		uint32_t* new_slots = (uint32_t*)calloc(new_slot_count, sizeof(uint32_t));
+		if (new_slots == NULL)
+		{
+			printf("Failed to allocate memory for the save file!\nExiting program!\n");
+			exit(2);
+		}
+
+		for (uint32_t number = 0; number < state->row_count; ++number)
+		{
+			SaveRow* row = &(state->rows[number]);
+			uint32_t slot = (uint32_t)HashFnv1a(state->strings + row->index_offset, row->index_length, HASH_FNV1A_SEED) & (new_slot_count - 1);
+			while (new_slots[slot] != 0)
+				slot = (slot + 1) & (new_slot_count - 1);
+			new_slots[slot] = number + 1;
+		}
+
+		free(state->slots);
+		state->slots = new_slots;
+		state->slot_count = new_slot_count;
+	}
+
+	if (state->row_count == state->row_capacity) // GROW THE ROW ARRAY
+	{
+		uint32_t new_capacity = (state->row_capacity == 0) ? 64 : state->row_capacity * 2;
+		SaveRow* new_rows = (SaveRow*)realloc(state->rows, new_capacity * sizeof(SaveRow));
+		if (new_rows == NULL)
+		{
+			printf("Failed to allocate memory for the save file!\nExiting program!\n");
+			exit(2);
+		}
+		state->rows = new_rows;
+		state->row_capacity = new_capacity;
+	}
+
+	SaveRow* row = &(state->rows[state->row_count]);
+	row->index_offset = state->strings_length;
+	row->index_length = record->index_length;
+	row->name_length = record->name_length;
+	row->file_name_length = record->file_name_length;
+	row->weight = record->weight;
+	row->cost = record->cp;
+	row->quantity = 0;
+	if (record->index_length > 0)
+		BufferAppend(&(state->strings), &(state->strings_length), &(state->strings_capacity), index, record->index_length);
+	if (record->name_length > 0)
+		BufferAppend(&(state->strings), &(state->strings_length), &(state->strings_capacity), name, record->name_length);
+	if (record->file_name_length > 0)
+		BufferAppend(&(state->strings), &(state->strings_length), &(state->strings_capacity), file_name, record->file_name_length);
+
+	uint32_t slot = (uint32_t)HashFnv1a(index, record->index_length, HASH_FNV1A_SEED) & (state->slot_count - 1);
+	while (state->slots[slot] != 0)
+		slot = (slot + 1) & (state->slot_count - 1);
+	state->slots[slot] = ++(state->row_count);
+	return row;
+}
+
+SaveRow* SaveStateFind(SaveState* state, const char* index, uint32_t index_length)
+{
+	if (state->slot_count == 0)
+		return NULL;
+
+	uint32_t slot = (uint32_t)HashFnv1a(index, index_length, HASH_FNV1A_SEED) & (state->slot_count - 1);
+	while (state->slots[slot] != 0)
+	{
+		SaveRow* row = &(state->rows[state->slots[slot] - 1]);
+		if (row->index_length == index_length && memcmp(state->strings + row->index_offset, index, index_length) == 0)
+			return row;
+		slot = (slot + 1) & (state->slot_count - 1);
+	}
+	return NULL;
+}
+
+bool SaveStateApply(SaveState* state, ChangeRecord* record, const char* strings)
+{
+	if (record->kind == CHANGE_MONEY)
+	{
+		state->money = record->cp;
+		state->max_weight = record->weight;
+		return true;
+	}
+
+	const char* index = strings + record->index_offset;
+	SaveRow* row = SaveStateFind(state, index, record->index_length);
+	switch (record->kind)
+	{
+	case CHANGE_PUSH:
+		if (row == NULL)
+			row = SaveStateAddRow(state, record, index, index + record->index_length, index + record->index_length + record->name_length);
+		else if (row->quantity == 0) // A POPPED STACK COMES BACK LIKE A NEW ONE: WITH THE WEIGHT AND THE PRICE OF THE PUSH
+		{
+			row->weight = record->weight;
+			row->cost = record->cp;
+		}
+		row->quantity += record->amount;
+		state->max_weight -= record->weight * record->amount;
+		state->money -= record->cp * (int64_t)record->amount;
+		return true;
+	case CHANGE_POP:
+		if (row == NULL || row->quantity < record->amount)
+			return false;
+		row->quantity -= record->amount;
+		state->max_weight += row->weight * record->amount;
+		state->money += row->cost * (int64_t)record->amount;
+		return true;
+	case CHANGE_PRICE:
+		if (row == NULL || row->quantity == 0)
+			return false;
+		row->cost = record->cp;
+		return true;
+	}
+	return false;
+}
+
+uint64_t SaveStateHash(SaveState* state)
+{
+	uint64_t rows_hash = 0;
+	for (uint32_t row_number = 0; row_number < state->row_count; ++row_number)
+	{
+		SaveRow* row = &(state->rows[row_number]);
+		if (row->quantity == 0)
+			continue;
+
+		uint32_t weight_bits;
+		memcpy(&weight_bits, &(row->weight), sizeof weight_bits);
+		uint64_t hash = HashFnv1a(state->strings + row->index_offset, row->index_length, HASH_FNV1A_SEED);
+		hash = (hash ^ row->quantity) * HASH_FNV1A_PRIME;
+		hash = (hash ^ (uint64_t)row->cost) * HASH_FNV1A_PRIME;
+		hash = (hash ^ weight_bits) * HASH_FNV1A_PRIME;
+		rows_hash += hash; // A SUM: THE ORDER OF THE ROWS DOESN'T CHANGE IT
+	}
+
+	uint32_t max_weight_bits;
+	memcpy(&max_weight_bits, &(state->max_weight), sizeof max_weight_bits);
+	rows_hash = (rows_hash ^ (uint64_t)state->money) * HASH_FNV1A_PRIME;
+	rows_hash = (rows_hash ^ max_weight_bits) * HASH_FNV1A_PRIME;
+	return rows_hash;
+}
+
+void SaveStateFree(SaveState* state)
+{
+	free(state->rows);
+	free(state->strings);
+	free(state->slots);
+	memset(state, 0, sizeof(SaveState));
+}
+
+bool DeltaEmit(char* old_path, char* new_path, char* delta_path)
+{
+	SaveState old_state = { 0 };
+	SaveState new_state = { 0 };
+	ChangeLog old_log = { 0 };
+	ChangeLog new_log = { 0 };
+	ChangeLog delta = { 0 };
+	if (!SaveStateLoad(old_path, &old_state, &old_log) || !SaveStateLoad(new_path, &new_state, &new_log))
+	{
+		SaveStateFree(&old_state);
+		ChangeLogFree(&old_log);
+		SaveStateFree(&new_state);
+		ChangeLogFree(&new_log);
+		return false;
+	}
+
+	uint64_t base_hash = SaveStateHash(&old_state);
+	uint64_t result_hash = SaveStateHash(&new_state);
+	ChangeRecord totals = { 0 }; // LAST RECORD OF EVERY DELTA: THE EXACT MONEY AND CARRYING CAPACITY, WHATEVER THE FLOAT ROUNDING OF THE PUSHES AND POPS
+	totals.version = new_state.version;
+	totals.kind = CHANGE_MONEY;
+	totals.cp = new_state.money;
+	totals.weight = new_state.max_weight;
+
+	// THE RECORDS OF THE NEW SAVE FILE SINCE THE OLD VERSION, WHEN ITS CHANGE LOG REACHES BACK THAT FAR. THEY ARE TRIED ON THE OLD STACKS FIRST:
+	// WHEN BOTH MACHINES CHANGED THE SAME VERSION OF THE CAMP, THE RECORDS DON'T GIVE THE NEW STACKS
+	bool is_from_log = (old_log.lineage == new_log.lineage && new_log.start_version <= old_state.version && old_state.version <= new_state.version);
+	for (uint32_t record_number = 0; record_number < new_log.count && is_from_log; ++record_number)
+	{
+		ChangeRecord record = new_log.records[record_number];
+		if (record.version <= old_state.version)
+			continue;
+		is_from_log = SaveStateApply(&old_state, &record, new_log.strings);
+		ChangeLogAddCopy(&delta, &record, new_log.strings);
+	}
+	if (is_from_log)
+	{
+		SaveStateApply(&old_state, &totals, NULL);
+		is_from_log = (SaveStateHash(&old_state) == result_hash);
+	}
+
+	if (!is_from_log) // A STATE DIFF: THE STACKS OF BOTH SAVE FILES ARE COMPARED
+	{
+		ChangeLogFree(&delta);
+		SaveStateFree(&old_state);
+		ChangeLogFree(&old_log);
+		if (!SaveStateLoad(old_path, &old_state, &old_log))
+		{
+			SaveStateFree(&old_state);
+			ChangeLogFree(&old_log);
+			SaveStateFree(&new_state);
+			ChangeLogFree(&new_log);
+			return false;
+		}
+		DeltaDiff(&old_state, &new_state, &delta);
+	}
+	ChangeLogAdd(&delta, &totals, NULL, NULL, NULL);
+
+	SyncBuffer buffer = { 0 };
+	uint8_t format_version = DELTA_VERSION;
+	SyncWriteBytes(&buffer, DELTA_MAGIC, 4);
+	SyncWriteBytes(&buffer, &format_version, 1);
+	SyncWriteFixed64(&buffer, new_log.lineage);
+	SyncWriteVarint(&buffer, old_state.version);
+	SyncWriteVarint(&buffer, new_state.version);
+	SyncWriteFixed64(&buffer, base_hash);
+	SyncWriteFixed64(&buffer, result_hash);
+	SyncWriteVarint(&buffer, delta.count);
+	uint64_t previous_version = old_state.version;
+	for (uint32_t record_number = 0; record_number < delta.count; ++record_number)
+		SyncWriteRecord(&buffer, &(delta.records[record_number]), delta.strings, &previous_version);
+
+	bool is_written = SyncWriteFile(delta_path, &buffer);
+	if (is_written)
+		printf("Delta from version %llu to %llu: %u changes (%s), %u bytes written to %s.\n", (unsigned long long)old_state.version, (unsigned long long)new_state.version,
+			delta.count, (is_from_log) ? "change log" : "state diff", buffer.length, delta_path);
+
+	free(buffer.data);
+	ChangeLogFree(&delta);
+	SaveStateFree(&old_state);
+	ChangeLogFree(&old_log);
+	SaveStateFree(&new_state);
+	ChangeLogFree(&new_log);
+	return is_written;
+}
+
+void DeltaDiff(SaveState* old_state, SaveState* new_state, ChangeLog* delta)
+{
+	for (uint32_t row_number = 0; row_number < new_state->row_count; ++row_number)
+	{
+		SaveRow* row = &(new_state->rows[row_number]);
+		if (row->quantity == 0)
+			continue;
+
+		const char* index = new_state->strings + row->index_offset;
+		SaveRow* old_row = SaveStateFind(old_state, index, row->index_length);
+		uint32_t old_quantity = (old_row != NULL) ? old_row->quantity : 0;
+
+		ChangeRecord record = { 0 };
+		record.version = new_state->version;
+		record.index_length = row->index_length;
+		if (old_quantity > 0 && old_row->weight != row->weight) // ANOTHER ITEM WITH THE SAME INDEX: THE OLD STACK GOES, THE NEW ONE IS PUSHED AS A WHOLE
+		{
+			record.kind = CHANGE_POP;
+			record.amount = old_quantity;
+			ChangeLogAdd(delta, &record, index, NULL, NULL);
+			old_quantity = 0;
+		}
+		if (old_quantity > 0 && old_row->cost != row->cost) // THE PRICE FIRST: A PUSH ON A STACK DOESN'T CHANGE ITS PRICE
+		{
+			record.kind = CHANGE_PRICE;
+			record.cp = row->cost;
+			ChangeLogAdd(delta, &record, index, NULL, NULL);
+		}
+		if (row->quantity > old_quantity)
+		{
+			record.kind = CHANGE_PUSH;
+			record.amount = row->quantity - old_quantity;
+			record.name_length = row->name_length;
+			record.file_name_length = row->file_name_length;
+			record.weight = row->weight;
+			record.cp = row->cost;
+			ChangeLogAdd(delta, &record, index, index + row->index_length, index + row->index_length + row->name_length);
+		}
+		else if (row->quantity < old_quantity)
+		{
+			record.kind = CHANGE_POP;
+			record.amount = old_quantity - row->quantity;
+			ChangeLogAdd(delta, &record, index, NULL, NULL);
+		}
+	}
+
+	for (uint32_t row_number = 0; row_number < old_state->row_count; ++row_number) // THE STACKS THAT ARE GONE
+	{
+		SaveRow* old_row = &(old_state->rows[row_number]);
+		const char* index = old_state->strings + old_row->index_offset;
+		SaveRow* row = SaveStateFind(new_state, index, old_row->index_length);
+		if (old_row->quantity == 0 || (row != NULL && row->quantity > 0))
+			continue;
+
+		ChangeRecord record = { 0 };
+		record.version = new_state->version;
+		record.kind = CHANGE_POP;
+		record.amount = old_row->quantity;
+		record.index_length = old_row->index_length;
+		ChangeLogAdd(delta, &record, index, NULL, NULL);
+	}
+}
+
+bool DeltaApply(char* base_path, char* delta_path, char* result_path)
+{
+	SaveState state = { 0 };
+	ChangeLog log = { 0 };
+	ChangeLog delta = { 0 };
+	SyncBuffer buffer = { 0 };
+	if (!SaveStateLoad(base_path, &state, &log) || !SyncLoadFile(delta_path, &buffer, DELTA_MAGIC, DELTA_VERSION))
+	{
+		SaveStateFree(&state);
+		ChangeLogFree(&log);
+		return false;
+	}
+
+	uint64_t lineage = SyncReadFixed64(&buffer);
+	uint64_t from_version = SyncReadVarint(&buffer);
+	uint64_t to_version = SyncReadVarint(&buffer);
+	uint64_t base_hash = SyncReadFixed64(&buffer);
+	uint64_t result_hash = SyncReadFixed64(&buffer);
+	uint64_t record_count = SyncReadVarint(&buffer);
+	uint64_t previous_version = from_version;
+	for (uint64_t record_number = 0; record_number < record_count && !buffer.is_failed; ++record_number)
+		SyncReadRecord(&buffer, &delta, &previous_version);
+
+	bool is_applied = false;
+	if (buffer.is_failed || buffer.position != buffer.length)
+		printf("The delta file %s is corrupted!\n", delta_path);
+	else if (SaveStateHash(&state) != base_hash) // THE DELTA ONLY KNOWS THE CHANGES, NOT THE STACKS THEY START FROM
+		printf("The delta is made for another version of the camp: %s is at version %llu, the delta starts at version %llu.\n", base_path, (unsigned long long)state.version, (unsigned long long)from_version);
+	else
+	{
+		bool is_valid = true;
+		for (uint32_t record_number = 0; record_number < delta.count && is_valid; ++record_number)
+			is_valid = SaveStateApply(&state, &(delta.records[record_number]), delta.strings);
+
+		if (!is_valid || SaveStateHash(&state) != result_hash)
+			printf("The delta doesn't give the camp it was made from. %s isn't written.\n", result_path);
+		else
+		{
+			// THE SAME CAMP: ITS CHANGE LOG GOES ON, SO THE RESULT CAN SEND DELTAS TOO. A DIFF FROM ANOTHER CAMP, OR FROM A MACHINE THAT
+			// IS AT AN OLDER VERSION, STARTS A NEW LOG AT THE NEW VERSION: THE VERSIONS OF A LOG ONLY GROW
+			if (log.lineage == lineage && state.version == from_version && from_version <= to_version)
+			{
+				for (uint32_t record_number = 0; record_number < delta.count; ++record_number)
+				{
+					ChangeRecord record = delta.records[record_number];
+					ChangeLogAddCopy(&log, &record, delta.strings);
+				}
+			}
+			else
+			{
+				ChangeLogFree(&log);
+				log.lineage = lineage;
+				log.start_version = to_version;
+			}
+			state.version = to_version;
+
+			is_applied = SaveStateWrite(result_path, &state, &log, ChangeLogTrim(&log));
+			if (is_applied)
+				printf("Applied %u changes: version %llu => %llu written to %s.\n", delta.count, (unsigned long long)from_version, (unsigned long long)to_version, result_path);
+		}
+	}
+
+	free(buffer.data);
+	ChangeLogFree(&delta);
+	SaveStateFree(&state);
+	ChangeLogFree(&log);
+	return is_applied;
+}
+
+void SyncWriteBytes(SyncBuffer* buffer, const void* data, uint32_t size)
+{
+	BufferAppend(&(buffer->data), &(buffer->length), &(buffer->capacity), data, size);
+}
+
+void SyncWriteVarint(SyncBuffer* buffer, uint64_t value)
+{
+	uint8_t bytes[10];
+	uint32_t byte_count = 0;
+	do
+	{
+		bytes[byte_count] = (uint8_t)(value & 0x7F);
+		value >>= 7;
+		if (value != 0)
+			bytes[byte_count] |= 0x80; // MORE BYTES FOLLOW
+		++byte_count;
+	} while (value != 0);
+	SyncWriteBytes(buffer, bytes, byte_count);
+}
+
+void SyncWriteSigned(SyncBuffer* buffer, int64_t value)
+{
+	SyncWriteVarint(buffer, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63)); // -1 => 1, 1 => 2: A SMALL REFUND TAKES ONE BYTE TOO
+}
+
+void SyncWriteFloat(SyncBuffer* buffer, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof bits);
+	uint8_t bytes[4] = { (uint8_t)bits, (uint8_t)(bits >> 8), (uint8_t)(bits >> 16), (uint8_t)(bits >> 24) };
+	SyncWriteBytes(buffer, bytes, sizeof bytes);
+}
+
+void SyncWriteFixed64(SyncBuffer* buffer, uint64_t value)
+{
+	uint8_t bytes[8];
+	for (int byte = 0; byte < 8; ++byte)
+		bytes[byte] = (uint8_t)(value >> (byte * 8));
+	SyncWriteBytes(buffer, bytes, sizeof bytes);
+}
+
+void SyncWriteString(SyncBuffer* buffer, const char* text, uint16_t length)
+{
+	SyncWriteVarint(buffer, length);
+	if (length > 0)
+		SyncWriteBytes(buffer, text, length);
+}
+
+void SyncWriteRecord(SyncBuffer* buffer, ChangeRecord* record, const char* strings, uint64_t* previous_version)
+{
+	SyncWriteBytes(buffer, &(record->kind), 1);
+	SyncWriteVarint(buffer, record->version - *previous_version); // THE VERSIONS ONLY GROW: ONE BYTE PER RECORD
+	*previous_version = record->version;
+
+	const char* index = (strings != NULL) ? strings + record->index_offset : "";
+	switch (record->kind)
+	{
+	case CHANGE_PUSH:
+		SyncWriteString(buffer, index, record->index_length);
+		SyncWriteString(buffer, index + record->index_length, record->name_length);
+		SyncWriteString(buffer, index + record->index_length + record->name_length, record->file_name_length);
+		SyncWriteFloat(buffer, record->weight);
+		SyncWriteSigned(buffer, record->cp);
+		SyncWriteVarint(buffer, record->amount);
+		break;
+	case CHANGE_POP:
+		SyncWriteString(buffer, index, record->index_length);
+		SyncWriteVarint(buffer, record->amount);
+		break;
+	case CHANGE_PRICE:
+		SyncWriteString(buffer, index, record->index_length);
+		SyncWriteSigned(buffer, record->cp);
+		break;
+	case CHANGE_MONEY:
+		SyncWriteSigned(buffer, record->cp);
+		SyncWriteFloat(buffer, record->weight);
+		break;
+	}
+}
+
+bool SyncWriteFile(char* file_path, SyncBuffer* buffer)
+{
+	SyncWriteFixed64(buffer, HashFnv1a(buffer->data, buffer->length, HASH_FNV1A_SEED));
+
+	// WRITE A TEMPORARY FILE FIRST: A PROGRAM THAT STOPS HALFWAY NEVER LEAVES A HALF WRITTEN CAMP BEHIND
+	char temp_path[FILE_PATH_BUFFER_MAX + 5];
+	snprintf(temp_path, sizeof temp_path, "%s.tmp", file_path);
+	FILE* file = StatsFileOpen(temp_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to write %s.\n", temp_path);
+		return false;
+	}
+
+	bool is_written = StatsFileWrite(buffer->data, buffer->length, 1, file) == 1;
+	is_written = (StatsFileClose(file) == 0) && is_written;
+
+	remove(file_path); // rename() DOESN'T REPLACE AN EXISTING FILE ON WINDOWS
+	if (!is_written || rename(temp_path, file_path) != 0)
+	{
+		printf("Failed to write %s.\n", file_path);
+		remove(temp_path);
+		return false;
+	}
+	return true;
+}
+
+bool SyncReadBytes(SyncBuffer* buffer, void* data, uint32_t size)
+{
+	if (buffer->is_failed || size > buffer->length - buffer->position) // NEVER READ PAST THE DATA, WHATEVER THE LENGTHS IN A CORRUPTED FILE SAY
+	{
+		buffer->is_failed = true;
+		memset(data, 0, size);
+		return false;
+	}
+
+	memcpy(data, buffer->data + buffer->position, size);
+	buffer->position += size;
+	return true;
+}
+
+uint64_t SyncReadVarint(SyncBuffer* buffer)
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		uint8_t byte;
+		if (!SyncReadBytes(buffer, &byte, 1))
+			return 0;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+	buffer->is_failed = true; // MORE THAN 10 BYTES: NOT A VARINT
+	return 0;
+}
+
+int64_t SyncReadSigned(SyncBuffer* buffer)
+{
+	uint64_t value = SyncReadVarint(buffer);
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+float SyncReadFloat(SyncBuffer* buffer)
+{
+	uint8_t bytes[4];
+	SyncReadBytes(buffer, bytes, sizeof bytes);
+	uint32_t bits = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+	float value;
+	memcpy(&value, &bits, sizeof value);
+	return value;
+}
+
+uint64_t SyncReadFixed64(SyncBuffer* buffer)
+{
+	uint8_t bytes[8];
+	SyncReadBytes(buffer, bytes, sizeof bytes);
+	uint64_t value = 0;
+	for (int byte = 0; byte < 8; ++byte)
+		value |= (uint64_t)bytes[byte] << (byte * 8);
+	return value;
+}
+
+const char* SyncReadString(SyncBuffer* buffer, uint16_t* length)
+{
+	uint64_t string_length = SyncReadVarint(buffer);
+	if (buffer->is_failed || string_length > UINT16_MAX || string_length > buffer->length - buffer->position)
+	{
+		buffer->is_failed = true;
+		*length = 0;
+		return "";
+	}
+
+	const char* text = buffer->data + buffer->position;
+	buffer->position += (uint32_t)string_length;
+	*length = (uint16_t)string_length;
+	return text;
+}
+
+void SyncReadRecord(SyncBuffer* buffer, ChangeLog* log, uint64_t* previous_version)
+{
+	ChangeRecord record = { 0 };
+	const char* index = "";
+	const char* name = "";
+	const char* file_name = "";
+	SyncReadBytes(buffer, &(record.kind), 1);
+	*previous_version += SyncReadVarint(buffer);
+	record.version = *previous_version;
+
+	uint64_t amount = 0;
+	switch (record.kind)
+	{
+	case CHANGE_PUSH:
+		index = SyncReadString(buffer, &(record.index_length));
+		name = SyncReadString(buffer, &(record.name_length));
+		file_name = SyncReadString(buffer, &(record.file_name_length));
+		record.weight = SyncReadFloat(buffer);
+		record.cp = SyncReadSigned(buffer);
+		amount = SyncReadVarint(buffer);
+		break;
+	case CHANGE_POP:
+		index = SyncReadString(buffer, &(record.index_length));
+		amount = SyncReadVarint(buffer);
+		break;
+	case CHANGE_PRICE:
+		index = SyncReadString(buffer, &(record.index_length));
+		record.cp = SyncReadSigned(buffer);
+		break;
+	case CHANGE_MONEY:
+		record.cp = SyncReadSigned(buffer);
+		record.weight = SyncReadFloat(buffer);
+		break;
+	default:
+		buffer->is_failed = true;
+		break;
+	}
+
+	if (amount > UINT32_MAX)
+		buffer->is_failed = true;
+	record.amount = (uint32_t)amount;
+	if (!buffer->is_failed)
+		ChangeLogAdd(log, &record, index, name, file_name);
+}
+
+bool SyncLoadFile(char* file_path, SyncBuffer* buffer, const char* magic, uint8_t format_version)
+{
+	long file_length = 0;
+	char* data = JsonLoadFile(file_path, &file_length);
+	if (data == NULL)
+	{
+		printf("Failed to open %s.\n", file_path);
+		return false;
+	}
+
+	buffer->data = data;
+	buffer->length = buffer->capacity = (uint32_t)file_length;
+	buffer->position = 0;
+	buffer->is_failed = false;
+	if (file_length < 4 + 1 + 8 || file_length > UINT32_MAX || memcmp(data, magic, 4) != 0)
+	{
+		printf("%s isn't a %s file.\n", file_path, (strcmp(magic, SAVE_MAGIC) == 0) ? "save" : "delta");
+		free(data);
+		memset(buffer, 0, sizeof(SyncBuffer));
+		return false;
+	}
+
+	// THE LAST 8 BYTES ARE THE HASH OF THE REST: A SHORT OR CHANGED FILE IS NEVER APPLIED
+	buffer->position = buffer->length - 8;
+	uint64_t stored_hash = SyncReadFixed64(buffer);
+	buffer->length -= 8;
+	buffer->position = 4;
+	uint8_t file_version = 0;
+	SyncReadBytes(buffer, &file_version, 1);
+	if (stored_hash != HashFnv1a(data, buffer->length, HASH_FNV1A_SEED) || file_version != format_version)
+	{
+		if (file_version != format_version)
+			printf("%s is written by another version of the program.\n", file_path);
+		else
+			printf("%s is corrupted!\n", file_path);
+		free(data);
+		memset(buffer, 0, sizeof(SyncBuffer));
+		return false;
+	}
+	return true;
+}
+
+void ClearScreen(void)
+{
+	// ANSI ERASE DISPLAY AND CURSOR HOME: NO SHELL AND NO CHILD PROCESS LIKE system("clear") STARTS
+	fputs("\x1b[2J\x1b[H", stdout);
+	fflush(stdout);
+	if (terminal.front)
+		memset(terminal.front, ' ', (size_t)terminal.rows * terminal.columns);
+	terminal.is_front_valid = true;
+}
+
+#ifdef _WIN32 // Windows system
+void TerminalInit(Terminal* terminal)
+{
+	terminal->output_handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD output_mode = 0;
+	bool has_ansi = GetConsoleMode(terminal->output_handle, &output_mode) && SetConsoleMode(terminal->output_handle, output_mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+	if (!has_ansi || !_isatty(_fileno(stdin)) || !_isatty(_fileno(stdout))) // REDIRECTED INPUT OR OUTPUT: KEYS AND LINES ARE READ AS BEFORE, NOTHING IS DRAWN
+		return;
+
+	terminal->is_raw = true; // _getch READS A KEY WITHOUT WAITING FOR ENTER AND WITHOUT ECHO: THE CONSOLE MODE DOESN'T HAVE TO CHANGE
+	TerminalResize(terminal);
+}
+
+void TerminalRestore(Terminal* terminal)
+{
+	if (terminal->is_raw)
+		fputs("\x1b[0m\n", stdout);
+}
+
+int TerminalReadKey(Terminal* terminal)
+{
+	if (!terminal->is_raw)
+	{
+		char key = '\0';
+		if (scanf(" %c", &key) != 1) // NOTE: THE LEADING SPACE BEFORE THE CHARACTER SPECIFIER IN THE FORMAT STRING REMOVES ISSUES WITH CHARACTERS LIKE TRAILING NEW LINES IN THE USER INPUT.
+			return '\0';
+		return key;
+	}
+
+	int key = 0;
+	do
+	{
+		key = _getch();
+		if (key == 0 || key == 0xE0) // ARROW KEYS: THE ITEM VIEWER MOVES WITH THEM
+		{
+			int arrow = _getch();
+			key = (arrow == 'M' || arrow == 'P') ? 'n' : (arrow == 'K' || arrow == 'H') ? 'p' : ' ';
+		}
+	}
+	while (isspace(key));
+
+	return key;
+}
+
+void TerminalReadLine(Terminal* terminal, char* buffer, int buffer_size)
+{
+	char format[24];
+	snprintf(format, sizeof format, " %%%d[^\n]", buffer_size - 1);
+	if (scanf(format, buffer) != 1) // THE CONSOLE STAYS IN LINE MODE FOR scanf: THE USER CAN EDIT THE LINE
+		*buffer = '\0';
+}
+
+void TerminalResize(Terminal* terminal)
+{
+	CONSOLE_SCREEN_BUFFER_INFO screen_info;
+	int rows = TERMINAL_DEFAULT_ROWS;
+	int columns = TERMINAL_DEFAULT_COLUMNS;
+	if (GetConsoleScreenBufferInfo(terminal->output_handle, &screen_info))
+	{
+		rows = screen_info.srWindow.Bottom - screen_info.srWindow.Top + 1;
+		columns = screen_info.srWindow.Right - screen_info.srWindow.Left + 1;
+	}
+	TerminalSetSize(terminal, rows, columns);
+}
+#else // Linux system
+void TerminalInit(Terminal* terminal)
+{
+	if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &(terminal->original_settings)) != 0) // REDIRECTED INPUT OR OUTPUT: KEYS AND LINES ARE READ AS BEFORE, NOTHING IS DRAWN
+		return;
+
+	// NO LINE BUFFERING AND NO ECHO. OUTPUT PROCESSING (\n => \r\n) AND CTRL+C STAY ON, SO THE printf OUTPUT OF THE OTHER COMMANDS IS UNCHANGED
+	struct termios raw_settings = terminal->original_settings;
+	raw_settings.c_lflag &= ~(ICANON | ECHO);
+	raw_settings.c_cc[VMIN] = 1;
+	raw_settings.c_cc[VTIME] = 0;
+	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw_settings) != 0)
+		return;
+
+	terminal->raw_settings = raw_settings;
+	terminal->is_raw = true;
+	atexit(TerminalRestoreOnExit);
+	signal(SIGINT, TerminalRestoreOnSignal);
+	signal(SIGTERM, TerminalRestoreOnSignal);
+	TerminalResize(terminal);
+}
+
+void TerminalRestore(Terminal* terminal)
+{
+	if (terminal->is_raw)
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &(terminal->original_settings));
+}
+
+void TerminalRestoreOnSignal(int signal_number)
+{
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &(terminal.original_settings)); // ASYNC SIGNAL SAFE: THE SHELL GETS ITS ECHO BACK
+	signal(signal_number, SIG_DFL);
+	raise(signal_number);
+}
+
+int TerminalReadKey(Terminal* terminal)
+{
+	int key = 0;
+	do
+	{
+		key = getchar();
+		if (key == EOF)
+			return '\0';
+
+		if (key == '\x1b' && terminal->is_raw) // ESCAPE SEQUENCE OF AN ARROW KEY: THE ITEM VIEWER MOVES WITH THEM
+		{
+			key = getchar();
+			if (key == '[')
+			{
+				int arrow = getchar();
+				key = (arrow == 'C' || arrow == 'B') ? 'n' : (arrow == 'D' || arrow == 'A') ? 'p' : ' ';
+			}
+		}
+	}
+	while (isspace(key)); // THE SAME AS scanf(" %c"): WHITESPACE AND NEW LINES ARE SKIPPED
+
+	return key;
+}
+
+void TerminalReadLine(Terminal* terminal, char* buffer, int buffer_size)
+{
+	if (terminal->is_raw) // LINE MODE AND ECHO WHILE THE LINE IS TYPED: THE USER CAN EDIT IT
+		tcsetattr(STDIN_FILENO, TCSANOW, &(terminal->original_settings));
+
+	char format[24];
+	snprintf(format, sizeof format, " %%%d[^\n]", buffer_size - 1);
+	if (scanf(format, buffer) != 1)
+		*buffer = '\0';
+
+	if (terminal->is_raw)
+		tcsetattr(STDIN_FILENO, TCSANOW, &(terminal->raw_settings));
+}
+
+void TerminalResize(Terminal* terminal)
+{
+	struct winsize window_size;
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window_size) == 0 && window_size.ws_row > 0 && window_size.ws_col > 0)
+		TerminalSetSize(terminal, window_size.ws_row, window_size.ws_col);
+	else
+		TerminalSetSize(terminal, TERMINAL_DEFAULT_ROWS, TERMINAL_DEFAULT_COLUMNS);
+}
+#endif
+
+void TerminalRestoreOnExit(void)
+{
+	TerminalRestore(&terminal);
+}
+
+void TerminalSetSize(Terminal* terminal, int rows, int columns)
+{
+	if (rows > TERMINAL_MAX_ROWS)
+		rows = TERMINAL_MAX_ROWS;
+	if (columns > TERMINAL_MAX_COLUMNS)
+		columns = TERMINAL_MAX_COLUMNS;
+	if (terminal->front && rows == terminal->rows && columns == terminal->columns)
+		return;
+
+	size_t cell_count = (size_t)rows * columns;
+	free(terminal->front);
+	free(terminal->back);
+	terminal->front = (char*)malloc(cell_count);
+	terminal->back = (char*)malloc(cell_count);
+	if (terminal->front == NULL || terminal->back == NULL)
+	{
+		printf("Failed to allocate memory for the screen buffers!\nExiting program!\n");
+		exit(2);
+	}
+	memset(terminal->back, ' ', cell_count);
+	terminal->rows = rows;
+	terminal->columns = columns;
+	terminal->is_front_valid = false; // NEW SIZE: THE OLD CONTENT IS WRAPPED OR CUT OFF, EVERY CELL IS DRAWN AGAIN
+}
+
+void TerminalBeginFrame(Terminal* terminal)
+{
+	TerminalResize(terminal);
+	memset(terminal->back, ' ', (size_t)terminal->rows * terminal->columns);
+}
+
+void TerminalPrint(Terminal* terminal, int row, const char* format, ...)
+{
+	if (row < 0 || row >= terminal->rows)
+		return;
+
+	char line[TERMINAL_MAX_COLUMNS + 1];
+	va_list arguments;
+	va_start(arguments, format);
+	int length = vsnprintf(line, terminal->columns, format, arguments); // THE LAST COLUMN STAYS EMPTY: WRITING IT CAN SCROLL THE SCREEN
+	va_end(arguments);
+	if (length < 0)
+		return;
+	if (length > terminal->columns - 1)
+		length = terminal->columns - 1;
+
+	char* cells = terminal->back + (size_t)row * terminal->columns;
+	for (int column = 0; column < length; ++column)
+		cells[column] = ((unsigned char)line[column] < ' ') ? ' ' : line[column]; // A CONTROL CHARACTER WOULD MOVE THE CURSOR
+}
+
+void TerminalFlush(Terminal* terminal)
+{
+	terminal->output_length = 0;
+	if (!terminal->is_front_valid) // THE SCREEN CONTENT IS UNKNOWN: START FROM AN EMPTY SCREEN
+	{
+		BufferAppend(&(terminal->output), &(terminal->output_length), &(terminal->output_capacity), "\x1b[2J", 4);
+		memset(terminal->front, ' ', (size_t)terminal->rows * terminal->columns);
+		terminal->is_front_valid = true;
+	}
+
+	char cursor_move[24];
+	for (int row = 0; row < terminal->rows; ++row)
+	{
+		char* front = terminal->front + (size_t)row * terminal->columns;
+		char* back = terminal->back + (size_t)row * terminal->columns;
+
+		int column = 0;
+		while (column < terminal->columns)
+		{
+			if (front[column] == back[column])
+			{
+				++column;
+				continue;
+			}
+
+			// A RUN OF CHANGED CELLS. SHORT GAPS OF UNCHANGED CELLS ARE WRITTEN AGAIN: THAT IS SHORTER THAN A NEW CURSOR MOVE
+			int run_start = column;
+			int run_end = column + 1;
+			for (int next = column + 1; next < terminal->columns && next - run_end < TERMINAL_RUN_GAP; ++next)
+			{
+				if (front[next] != back[next])
+					run_end = next + 1;
+			}
+
+			int move_length = snprintf(cursor_move, sizeof cursor_move, "\x1b[%d;%dH", row + 1, run_start + 1);
+			BufferAppend(&(terminal->output), &(terminal->output_length), &(terminal->output_capacity), cursor_move, move_length);
+			BufferAppend(&(terminal->output), &(terminal->output_length), &(terminal->output_capacity), back + run_start, run_end - run_start);
+			column = run_end;
+		}
+	}
+
+	int move_length = snprintf(cursor_move, sizeof cursor_move, "\x1b[%d;1H", terminal->rows); // THE CURSOR WAITS ON THE STATUS LINE
+	BufferAppend(&(terminal->output), &(terminal->output_length), &(terminal->output_capacity), cursor_move, move_length);
+
+	fwrite(terminal->output, 1, terminal->output_length, stdout); // ONE WRITE FOR THE WHOLE FRAME
+	fflush(stdout);
+	memcpy(terminal->front, terminal->back, (size_t)terminal->rows * terminal->columns);
+}
+
+void ItemViewRender(Inventory* inventory, Item* item, bool show_details, char* status)
+{
+	TerminalBeginFrame(&terminal);
+
+	int row = 0;
+	TerminalPrint(&terminal, row++, "Item view: N or right arrow = next, P or left arrow = previous, D = details, X = delete, H = help, C = redraw, Q = quit");
+	TerminalPrint(&terminal, row++, "Items in the inventory: %u (%u different)", inventory->item_count, inventory->stack_count);
+	++row;
+	if (item)
+	{
+		char weight_text[NUMBER_WEIGHT_TEXT_MAX];
+		NumberFormatWeight(item->weight, weight_text, sizeof weight_text);
+		TerminalPrint(&terminal, row++, "Index: %.*s", ITEM_STRING_ARGS(item, index));
+		TerminalPrint(&terminal, row++, "Name: %.*s", ITEM_STRING_ARGS(item, name));
+		TerminalPrint(&terminal, row++, "Quantity: %u", item->quantity);
+		TerminalPrint(&terminal, row++, "weight: %s", weight_text);
+		TerminalPrint(&terminal, row++, "Money: %dgp, %dsp, %dcp.", item->money.gp, item->money.sp, item->money.cp);
+		if (show_details)
+		{
+			ItemLoadDetails(item, true);
+			++row;
+			TerminalPrint(&terminal, row++, "Item url: %.*s", ITEM_STRING_ARGS(item, url));
+			TerminalPrint(&terminal, row++, "Equipment category: %.*s", ITEM_STRING_ARGS(item, equipment_category));
+		}
+	}
+	else
+	{
+		TerminalPrint(&terminal, row++, "List is empty.");
+	}
+	TerminalPrint(&terminal, terminal.rows - 1, "%s", status);
+
+	TerminalFlush(&terminal);
+}
+
+void ItemViewMessage(char* status, const char* message)
+{
+	if (terminal.is_raw) // SHOWN ON THE STATUS LINE WHEN THE VIEW IS DRAWN
+		snprintf(status, ITEM_VIEW_STATUS_LENGTH, "%s", message);
+	else
+		printf("%s\n", message);
+}
+
+void PrintInventoryHelpMenu(void)
+{
+	printf("Inventory help menu:\n");
+	printf("- Press H to display the inventory help menu.\n");
+	printf("- Press M to display the current money amount.\n- Press W to display the carrying weight capacity left.\n- Press A to display item amount.\n");
+	printf("- Press L to display basic item information of the whole list.\n- Press I to display item one by one.\n- Press N to add a new item.\n");
+	printf("- Press F to filter the items with a query. Example: category=weapon and weight<5 order by cost desc limit 10\n");
+	printf("- Press T to try a plan before buying or selling. Example: greatsword.json 2 -dagger 1\n");
+	printf("- Press X to drop every copy of the items with a matching index. Example: rations*\n");
+	printf("- Press V to total the value of the items or to change their price. Example: markup 15 category=weapon\n");
+	printf("- Press E to export the inventory to a CSV or JSON Lines file.\n");
+	printf("- Press S to display the runtime statistics.\n");
+	printf("- Press C to clear the screen.\n- Press Q to quit the inventory.\n\n");
+}
+
+void PrintItemHelpMenu(void)
+{
+	printf("Item help menu:\n- Press H to display the item help menu.\n");
+	printf("- Press D to display more data about the current item.\n- Press N to visit the next item.\n- Press P to visit the previous item.\n- Press X to delete the current item.\n- Press Q to quit the item view.\n");
+	printf("- Press C to clear the screen.\n\n");
+}
+
+int64_t convert_to_cp(const Money* money) 
+{
+	return ((int64_t)money->gp * 10000) + ((int64_t)money->sp * 100) + money->cp;
+}
+
+Money convert_from_cp(int64_t total_cp) 
+{
+	Money result;
+	if (total_cp > MONEY_MAX_CP) // THE GOLD IS AN int
+		total_cp = MONEY_MAX_CP;
+	result.gp = (int)(total_cp / 10000);
+	total_cp %= 10000;
+	result.sp = (int)(total_cp / 100);
+	result.cp = (int)(total_cp % 100);
+	return result;
+}
+
+int subtract_money(const Money* available, const Money* cost, Money* remaining) 
+{
+	int64_t total_cp_available = convert_to_cp(available);
+	// printf("Total money available in cp: %lld\n", (long long)total_cp_available);
+	int64_t total_cp_cost = convert_to_cp(cost);
+	// printf("Item money in cp: %lld\n", (long long)total_cp_cost);
+
+	if (total_cp_available < total_cp_cost) 
+	{
+		return 0; 
+	}
+
+	int64_t total_cp_remaining = total_cp_available - total_cp_cost;
+	*remaining = convert_from_cp(total_cp_remaining);
+	return 1; 
+}
+
+void add_money(const Money* available, const Money* cost, Money* inventory_money)
+{
+	printf("Adding money back\n");
+
+	int64_t total_cp_available = convert_to_cp(available);
+	// printf("Total money available in cp: %lld\n", (long long)total_cp_available);
+	int64_t total_cp_cost = convert_to_cp(cost);
+	// printf("Item money in cp: %lld\n", (long long)total_cp_cost);
+
+	int64_t total_cp = total_cp_available + total_cp_cost;
+	*inventory_money = convert_from_cp(total_cp);
+}
+
+void WriteToLogFile(Inventory* inventory, char* log_file_path)
+{
+	/*FILE* file = fopen(log_file_path, "a");
+
+	if (file)
+	{
+		char* weigth_string = "Inventory weigth capacity left: ";
+		fwrite(ltoa(weigth_string), 1, sizeof weigth_string, file);
+		fwrite(inventory->max_weight, 1, sizeof inventory->max_weight, file);
+
+		fclose(file);
+	}
+	else
+	{
+		printf("%s does not exitst.\n", log_file_path);
+	}*/
+
+}
+uint64_t StatsTimeNs(void)
+{
+#ifdef _WIN32 // Windows system
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)((counter.QuadPart / frequency.QuadPart) * 1000000000ULL + ((counter.QuadPart % frequency.QuadPart) * 1000000000ULL) / frequency.QuadPart);
+#else // Linux system
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+void StatsRecordLatency(LatencyHistogram* histogram, uint64_t start_ns)
+{
+	uint64_t elapsed_ns = StatsTimeNs() - start_ns;
+
+	uint8_t bucket = 0; // BUCKET = LOG2 OF THE ELAPSED TIME
+	for (uint64_t rest = elapsed_ns >> 1; rest != 0 && bucket < STATS_LATENCY_BUCKETS - 1; rest >>= 1)
+		++bucket;
+
+	++(histogram->count);
+	++(histogram->buckets[bucket]);
+	histogram->total_ns += elapsed_ns;
+	if (elapsed_ns > histogram->max_ns)
+		histogram->max_ns = elapsed_ns;
+}
+
+void StatsItemBytesAdd(uint64_t bytes)
+{
+	runtime_stats.item_bytes_live += bytes;
+	if (runtime_stats.item_bytes_live > runtime_stats.item_bytes_peak)
+		runtime_stats.item_bytes_peak = runtime_stats.item_bytes_live;
+}
+
+uint64_t StatsLatencyPercentile(LatencyHistogram* histogram, uint8_t percentile)
+{
+	if (histogram->count == 0)
+		return 0;
+
+	uint64_t wanted_count = (histogram->count * percentile + 99) / 100; // ROUND UP: THE P99 OF 10 CALLS IS THE SLOWEST CALL
+	uint64_t seen_count = 0;
+	for (uint8_t bucket = 0; bucket < STATS_LATENCY_BUCKETS; ++bucket)
+	{
+		seen_count += histogram->buckets[bucket];
+		if (seen_count >= wanted_count)
+			return (bucket == STATS_LATENCY_BUCKETS - 1 || (2ULL << bucket) > histogram->max_ns) ? histogram->max_ns : (2ULL << bucket); // THE SLOWEST CALL IS A TIGHTER BOUND THAN THE BUCKET END
+	}
+
+	return histogram->max_ns;
+}
+
+void StatsPrintLatency(char* name, LatencyHistogram* histogram)
+{
+	if (histogram->count == 0)
+	{
+		printf("%s latency: no calls yet\n", name);
+		return;
+	}
+
+	printf("%s latency: avg %.1f us, p50 <= %.1f us, p99 <= %.1f us, max %.1f us\n", name,
+		(histogram->total_ns / (double)histogram->count) / 1000.0,
+		StatsLatencyPercentile(histogram, 50) / 1000.0,
+		StatsLatencyPercentile(histogram, 99) / 1000.0,
+		histogram->max_ns / 1000.0);
+}
+
+void StatsPrint(void)
+{
+	RuntimeStats* stats = &runtime_stats;
+
+	printf("Runtime statistics:\n");
+	printf("JsonParse: %llu files, %llu bytes\n", (unsigned long long)stats->json_files_parsed, (unsigned long long)stats->json_bytes_parsed);
+	StatsPrintLatency("JsonParse", &(stats->json_parse_latency));
+	printf("Parse cache: %llu hits, %llu hits after an mtime change, %llu misses\n", (unsigned long long)stats->parse_cache_hits,
+		(unsigned long long)stats->parse_cache_content_hits, (unsigned long long)stats->parse_cache_misses);
+	printf("Item pack: %llu entries read, %llu bytes decompressed\n", (unsigned long long)stats->pack_entries_read, (unsigned long long)stats->pack_bytes_decompressed);
+	printf("Items: %llu created, %llu freed, %llu live, %llu bytes live, %llu bytes peak\n", (unsigned long long)stats->items_created, (unsigned long long)stats->items_freed,
+		(unsigned long long)stats->items_live, (unsigned long long)stats->item_bytes_live, (unsigned long long)stats->item_bytes_peak);
+	printf("ItemPush: %llu pushed, %llu rejected (weight: %llu, money: %llu)\n", (unsigned long long)stats->items_pushed,
+		(unsigned long long)(stats->push_rejects_weight + stats->push_rejects_money), (unsigned long long)stats->push_rejects_weight, (unsigned long long)stats->push_rejects_money);
+	StatsPrintLatency("ItemPush", &(stats->push_latency));
+	printf("ItemPop: %llu popped, %llu rejected (empty list: %llu, index not found: %llu)\n", (unsigned long long)stats->items_popped,
+		(unsigned long long)(stats->pop_rejects_empty + stats->pop_rejects_not_found), (unsigned long long)stats->pop_rejects_empty, (unsigned long long)stats->pop_rejects_not_found);
+	StatsPrintLatency("ItemPop", &(stats->pop_latency));
+	printf("Tombstones: %llu stacks removed, %llu freed by %llu compactions, %llu stale handles\n", (unsigned long long)stats->stacks_removed,
+		(unsigned long long)stats->tombstones_freed, (unsigned long long)stats->compactions, (unsigned long long)stats->stale_handles);
+	printf("Snapshots: %llu published, %llu reclaimed, %llu bytes live\n", (unsigned long long)stats->snapshots_published,
+		(unsigned long long)stats->snapshots_reclaimed, (unsigned long long)stats->snapshot_bytes_live);
+	printf("File calls: %llu open (%llu failed), %llu read (%llu bytes), %llu write (%llu bytes), %llu seek/tell, %llu close, %llu access checks, %llu directory entries read, %llu mapped (%llu bytes)\n",
+		(unsigned long long)stats->file_opens, (unsigned long long)stats->file_open_failures, (unsigned long long)stats->file_reads, (unsigned long long)stats->file_bytes_read,
+		(unsigned long long)stats->file_writes, (unsigned long long)stats->file_bytes_written,
+		(unsigned long long)stats->file_seeks, (unsigned long long)stats->file_closes, (unsigned long long)stats->file_access_checks, (unsigned long long)stats->directory_reads,
+		(unsigned long long)stats->file_maps, (unsigned long long)stats->file_bytes_mapped);
+	StatsPrintLatency("File read", &(stats->file_read_latency));
+	printf("\n");
+}
+
+void StatsWriteJsonLatency(FILE* file, char* name, LatencyHistogram* histogram)
+{
+	fprintf(file, "\t\t\"%s\": { \"count\": %llu, \"total_ns\": %llu, \"max_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, \"buckets\": [", name,
+		(unsigned long long)histogram->count, (unsigned long long)histogram->total_ns, (unsigned long long)histogram->max_ns,
+		(unsigned long long)StatsLatencyPercentile(histogram, 50), (unsigned long long)StatsLatencyPercentile(histogram, 99));
+	for (uint8_t bucket = 0; bucket < STATS_LATENCY_BUCKETS; ++bucket)
+		fprintf(file, (bucket == 0) ? "%llu" : ", %llu", (unsigned long long)histogram->buckets[bucket]);
+	fprintf(file, "] }");
+}
+
+void StatsWriteJson(char* file_path)
+{
+	FILE* file = fopen(file_path, "w"); // NOT COUNTED IN THE FILE CALLS: THE STATS WOULD CHANGE WHILE THEY ARE WRITTEN
+	if (file == NULL)
+	{
+		printf("Failed to write the runtime statistics to %s.\n", file_path);
+		return;
+	}
+
+	RuntimeStats* stats = &runtime_stats;
+
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"json_parse\": {\n\t\t\"files\": %llu,\n\t\t\"bytes\": %llu,\n", (unsigned long long)stats->json_files_parsed, (unsigned long long)stats->json_bytes_parsed);
+	StatsWriteJsonLatency(file, "latency", &(stats->json_parse_latency));
+	fprintf(file, "\n\t},\n");
+	fprintf(file, "\t\"parse_cache\": {\n\t\t\"hits\": %llu,\n\t\t\"content_hits\": %llu,\n\t\t\"misses\": %llu\n\t},\n",
+		(unsigned long long)stats->parse_cache_hits, (unsigned long long)stats->parse_cache_content_hits, (unsigned long long)stats->parse_cache_misses);
+	fprintf(file, "\t\"pack\": {\n\t\t\"entries_read\": %llu,\n\t\t\"bytes_decompressed\": %llu\n\t},\n",
+		(unsigned long long)stats->pack_entries_read, (unsigned long long)stats->pack_bytes_decompressed);
+	fprintf(file, "\t\"items\": {\n\t\t\"created\": %llu,\n\t\t\"freed\": %llu,\n\t\t\"live\": %llu,\n\t\t\"bytes_live\": %llu,\n\t\t\"bytes_peak\": %llu\n\t},\n",
+		(unsigned long long)stats->items_created, (unsigned long long)stats->items_freed, (unsigned long long)stats->items_live,
+		(unsigned long long)stats->item_bytes_live, (unsigned long long)stats->item_bytes_peak);
+	fprintf(file, "\t\"push\": {\n\t\t\"pushed\": %llu,\n\t\t\"rejects_weight\": %llu,\n\t\t\"rejects_money\": %llu,\n",
+		(unsigned long long)stats->items_pushed, (unsigned long long)stats->push_rejects_weight, (unsigned long long)stats->push_rejects_money);
+	StatsWriteJsonLatency(file, "latency", &(stats->push_latency));
+	fprintf(file, "\n\t},\n");
+	fprintf(file, "\t\"pop\": {\n\t\t\"popped\": %llu,\n\t\t\"rejects_empty\": %llu,\n\t\t\"rejects_not_found\": %llu,\n",
+		(unsigned long long)stats->items_popped, (unsigned long long)stats->pop_rejects_empty, (unsigned long long)stats->pop_rejects_not_found);
+	StatsWriteJsonLatency(file, "latency", &(stats->pop_latency));
+	fprintf(file, "\n\t},\n");
+	fprintf(file, "\t\"tombstones\": {\n\t\t\"stacks_removed\": %llu,\n\t\t\"compactions\": %llu,\n\t\t\"freed\": %llu,\n\t\t\"stale_handles\": %llu\n\t},\n",
+		(unsigned long long)stats->stacks_removed, (unsigned long long)stats->compactions, (unsigned long long)stats->tombstones_freed, (unsigned long long)stats->stale_handles);
+	fprintf(file, "\t\"snapshots\": {\n\t\t\"published\": %llu,\n\t\t\"reclaimed\": %llu,\n\t\t\"bytes_live\": %llu\n\t},\n",
+		(unsigned long long)stats->snapshots_published, (unsigned long long)stats->snapshots_reclaimed, (unsigned long long)stats->snapshot_bytes_live);
+	fprintf(file, "\t\"file_calls\": {\n\t\t\"opens\": %llu,\n\t\t\"open_failures\": %llu,\n\t\t\"reads\": %llu,\n\t\t\"bytes_read\": %llu,\n\t\t\"writes\": %llu,\n\t\t\"bytes_written\": %llu,\n\t\t\"seeks\": %llu,\n\t\t\"closes\": %llu,\n\t\t\"access_checks\": %llu,\n\t\t\"directory_reads\": %llu,\n\t\t\"maps\": %llu,\n\t\t\"bytes_mapped\": %llu,\n",
+		(unsigned long long)stats->file_opens, (unsigned long long)stats->file_open_failures, (unsigned long long)stats->file_reads, (unsigned long long)stats->file_bytes_read,
+		(unsigned long long)stats->file_writes, (unsigned long long)stats->file_bytes_written,
+		(unsigned long long)stats->file_seeks, (unsigned long long)stats->file_closes, (unsigned long long)stats->file_access_checks, (unsigned long long)stats->directory_reads,
+		(unsigned long long)stats->file_maps, (unsigned long long)stats->file_bytes_mapped);
+	StatsWriteJsonLatency(file, "read_latency", &(stats->file_read_latency));
+	fprintf(file, "\n\t}\n}\n");
+
+	fclose(file);
+}
+
+void StatsWriteOnExit(void)
+{
+	StatsWriteJson(STATS_FILE_NAME);
+}
+
+FILE* StatsFileOpen(char* file_path, char* mode)
+{
+	FILE* file = fopen(file_path, mode);
+
+	++(runtime_stats.file_opens);
+	if (file == NULL)
+		++(runtime_stats.file_open_failures);
+
+	return file;
+}
+
+size_t StatsFileRead(void* buffer, size_t size, size_t count, FILE* file)
+{
+	uint64_t start_ns = StatsTimeNs();
+	size_t read_count = fread(buffer, size, count, file);
+
+	++(runtime_stats.file_reads);
+	runtime_stats.file_bytes_read += read_count * size;
+	StatsRecordLatency(&(runtime_stats.file_read_latency), start_ns);
+
+	return read_count;
+}
+
+size_t StatsFileWrite(const void* buffer, size_t size, size_t count, FILE* file)
+{
+	size_t write_count = fwrite(buffer, size, count, file);
+
+	++(runtime_stats.file_writes);
+	runtime_stats.file_bytes_written += write_count * size;
+
+	return write_count;
+}
+
+int StatsFileSeek(FILE* file, long offset, int origin)
+{
+	++(runtime_stats.file_seeks);
+	return fseek(file, offset, origin);
+}
+
+long StatsFileTell(FILE* file)
+{
+	++(runtime_stats.file_seeks);
+	return ftell(file);
+}
+
+int StatsFileClose(FILE* file)
+{
+	++(runtime_stats.file_closes);
+	return fclose(file);
+}
+
+int StatsFileAccess(char* file_path, int mode)
+{
+	++(runtime_stats.file_access_checks);
+	return _access(file_path, mode);
+}
+
+void TraceStart(int argc, char* argv[])
+{
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		if (strcmp(*(argv + i), "--trace") == 0)
+		{
+			int snprintf_ret = snprintf(trace_file_name, sizeof(trace_file_name), "%s", *(argv + i + 1));
+			if (snprintf_ret <= 0 || snprintf_ret >= sizeof(trace_file_name))
+			{
+				printf("Trace file name to long ! => max characters: %d\nExiting program.\n", FILE_PATH_BUFFER_MAX);
+				exit(1);
+			}
+
+			trace_start_ns = StatsTimeNs();
+			trace_enabled = true;
+			atexit(TraceWriteOnExit);
+			printf("Tracing to %s.\n\n", trace_file_name);
+			return;
+		}
+	}
+}
+
+void TraceAddEvent(const char* name, char phase, const char* detail)
+{
+	if (trace_thread_buffer == NULL || trace_thread_buffer->event_count == TRACE_BUFFER_EVENTS)
+		trace_thread_buffer = TraceBufferCreate();
+
+	TraceEvent* event = &(trace_thread_buffer->events[trace_thread_buffer->event_count++]);
+	event->name = name;
+	event->phase = phase;
+	event->time_ns = StatsTimeNs();
+	if (detail)
+		snprintf(event->detail, sizeof(event->detail), "%s", detail);
+	else
+		event->detail[0] = '\0';
+}
+
+TraceBuffer* TraceBufferCreate(void)
+{
+	TraceBuffer* buffer = (TraceBuffer*)malloc(sizeof(TraceBuffer));
+	if (buffer == NULL)
+	{
+		printf("Failed to allocate memory for a trace buffer!\nExiting program!\n");
+		exit(2);
+	}
+
+	if (trace_thread_id == 0) // FIRST EVENT OF THIS THREAD
+		trace_thread_id = atomic_fetch_add(&trace_thread_count, 1) + 1;
+
+	buffer->thread_id = trace_thread_id;
+	buffer->event_count = 0;
+
+	// ADD THE BUFFER TO THE LIST OF ALL BUFFERS: OTHER THREADS CAN ADD THEIR BUFFER AT THE SAME TIME
+	buffer->next = atomic_load(&trace_buffers);
+	while (!atomic_compare_exchange_weak(&trace_buffers, &(buffer->next), buffer))
+		;
+
+	return buffer;
+}
+
+void TraceWriteJsonString(FILE* file, const char* string)
+{
+	fputc('"', file);
+	for (const char* c = string; *c != '\0'; ++c)
+	{
+		if (*c == '"' || *c == '\\') // WINDOWS PATHS CONTAIN BACKSLASHES
+			fputc('\\', file);
+		if ((unsigned char)*c >= 0x20)
+			fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+void TraceWrite(char* file_path)
+{
+	FILE* file = fopen(file_path, "w");
+	if (file == NULL)
+	{
+		printf("Failed to write the trace to %s.\n", file_path);
+		return;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+	fprintf(file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"Inventory\"}}");
+
+	for (TraceBuffer* buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next)
+	{
+		for (uint32_t i = 0; i < buffer->event_count; ++i)
+		{
+			TraceEvent* event = &(buffer->events[i]);
+			uint64_t time_ns = event->time_ns - trace_start_ns;
+
+			fprintf(file, ",\n{\"name\": ");
+			TraceWriteJsonString(file, event->name);
+			fprintf(file, ", \"ph\": \"%c\", \"ts\": %llu.%03llu, \"pid\": 1, \"tid\": %u", event->phase,
+				(unsigned long long)(time_ns / 1000), (unsigned long long)(time_ns % 1000), buffer->thread_id); // ts IS IN MICROSECONDS
+			if (event->detail[0] != '\0')
+			{
+				fprintf(file, ", \"args\": {\"detail\": ");
+				TraceWriteJsonString(file, event->detail);
+				fprintf(file, "}");
+			}
+			fprintf(file, "}");
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+}
+
+void TraceWriteOnExit(void)
+{
+	trace_enabled = false; // EVENTS ADDED WHILE WRITING WOULDN'T END UP IN THE FILE ANYWAY
+	TraceWrite(trace_file_name);
+}
+
+bool SharedSegmentName(char* segment_name, const char* name)
+{
+	if (*name == '/')
+		++name;
+	if (*name == '\0')
+		return false;
+	for (const char* c = name; *c != '\0'; ++c)
+	{
+		if (*c == '/' || *c == '\\') // ONE NAME, NOT A PATH
+			return false;
+	}
+
+#ifdef _WIN32 // Windows system
+	int snprintf_ret = snprintf(segment_name, SHARED_NAME_LENGTH, "Local\\%s", name); // ONLY VISIBLE IN THE LOGIN SESSION OF THE USER
+#else // Linux system
+	int snprintf_ret = snprintf(segment_name, SHARED_NAME_LENGTH, "/%s", name);
+#endif
+	return snprintf_ret > 0 && snprintf_ret < SHARED_NAME_LENGTH;
+}
+
+#ifdef _WIN32 // Windows system
+bool SharedSegmentCreate(SharedSegment* segment)
+{
+	segment->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, SHARED_SEGMENT_SIZE, segment->name);
+	if (segment->mapping == NULL)
+	{
+		printf("Failed to create the shared memory %s. The inventory isn't shared.\n", segment->name);
+		return false;
+	}
+
+	segment->header = (SharedInventoryHeader*)MapViewOfFile(segment->mapping, FILE_MAP_ALL_ACCESS, 0, 0, SHARED_SEGMENT_SIZE);
+	if (segment->header == NULL)
+	{
+		printf("Failed to map the shared memory %s. The inventory isn't shared.\n", segment->name);
+		CloseHandle(segment->mapping);
+		return false;
+	}
+	segment->size = SHARED_SEGMENT_SIZE;
+	segment->header->writer_process_id = (uint32_t)GetCurrentProcessId();
+#else // Linux system
+bool SharedSegmentCreate(SharedSegment* segment)
+{
+	int file_descriptor = shm_open(segment->name, O_CREAT | O_RDWR, 0644);
+	if (file_descriptor == -1 || ftruncate(file_descriptor, SHARED_SEGMENT_SIZE) == -1) // THE PAGES ONLY USE MEMORY WHEN THEY ARE WRITTEN
+	{
+		printf("Failed to create the shared memory %s. The inventory isn't shared.\n", segment->name);
+		if (file_descriptor != -1)
+			close(file_descriptor);
+		return false;
+	}
+
+	void* data = mmap(NULL, SHARED_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+	close(file_descriptor); // THE MAPPING KEEPS THE SEGMENT
+	if (data == MAP_FAILED)
+	{
+		printf("Failed to map the shared memory %s. The inventory isn't shared.\n", segment->name);
+		shm_unlink(segment->name);
+		return false;
+	}
+	segment->header = (SharedInventoryHeader*)data;
+	segment->size = SHARED_SEGMENT_SIZE;
+	segment->header->writer_process_id = (uint32_t)getpid();
+#endif
+
+	// THE MAGIC IS WRITTEN LAST: A READER THAT SEES IT ALSO SEES THE LAYOUT
+	SharedInventoryHeader* header = segment->header;
+	memset(header->magic, 0, sizeof header->magic);
+	header->layout_version = SHARED_LAYOUT_VERSION;
+	header->segment_size = SHARED_SEGMENT_SIZE;
+	header->row_offset = (sizeof(SharedInventoryHeader) + 7) & ~7u;
+	atomic_store(&(header->sequence), 0);
+	atomic_thread_fence(memory_order_release);
+	memcpy(header->magic, SHARED_MAGIC, sizeof header->magic);
+	segment->is_writer = true;
+	return true;
+}
+
+#ifdef _WIN32 // Windows system
+bool SharedSegmentOpen(SharedSegment* segment)
+{
+	segment->mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, segment->name);
+	if (segment->mapping == NULL)
+		return false;
+
+	segment->header = (SharedInventoryHeader*)MapViewOfFile(segment->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (segment->header == NULL)
+	{
+		CloseHandle(segment->mapping);
+		return false;
+	}
+
+	MEMORY_BASIC_INFORMATION memory_info;
+	segment->size = (VirtualQuery(segment->header, &memory_info, sizeof memory_info) != 0) ? memory_info.RegionSize : 0;
+#else // Linux system
+bool SharedSegmentOpen(SharedSegment* segment)
+{
+	int file_descriptor = shm_open(segment->name, O_RDONLY, 0);
+	if (file_descriptor == -1)
+		return false;
+
+	struct stat file_status;
+	if (fstat(file_descriptor, &file_status) == -1 || file_status.st_size < (off_t)sizeof(SharedInventoryHeader))
+	{
+		close(file_descriptor);
+		return false;
+	}
+
+	void* data = mmap(NULL, (size_t)file_status.st_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+	close(file_descriptor);
+	if (data == MAP_FAILED)
+		return false;
+	segment->header = (SharedInventoryHeader*)data;
+	segment->size = (size_t)file_status.st_size;
+#endif
+
+	segment->is_writer = false;
+	if (segment->size < sizeof(SharedInventoryHeader) || memcmp(segment->header->magic, SHARED_MAGIC, sizeof segment->header->magic) != 0
+		|| segment->header->layout_version != SHARED_LAYOUT_VERSION)
+	{
+		printf("Shared memory %s doesn't hold an inventory of this version.\n", segment->name);
+		SharedSegmentClose(segment);
+		return false;
+	}
+	return true;
+}
+
+void SharedSegmentClose(SharedSegment* segment)
+{
+	if (segment->header == NULL)
+		return;
+
+#ifdef _WIN32 // Windows system
+	UnmapViewOfFile(segment->header); // THE NAME IS GONE WHEN THE LAST HANDLE IS CLOSED
+	CloseHandle(segment->mapping);
+#else // Linux system
+	munmap(segment->header, segment->size);
+	if (segment->is_writer) // VIEWERS THAT STILL MAP IT KEEP THEIR MAPPING, NEW VIEWERS DON'T FIND IT
+		shm_unlink(segment->name);
+#endif
+	segment->header = NULL;
+	segment->is_writer = false;
+}
+
+void SharedSegmentCloseOnExit(void)
+{
+	SharedSegmentClose(&shared_segment);
+}
+
+void SharedSegmentWrite(SharedSegment* segment, InventorySnapshot* snapshot)
+{
+	SharedInventoryHeader* header = segment->header;
+	uint32_t string_pool_length = (uint32_t)(snapshot->size - sizeof(InventorySnapshot) - snapshot->stack_count * sizeof(SnapshotRow));
+
+	// THE ROWS THAT FIT: THE STRINGS OF A ROW FOLLOW THE STRINGS OF THE ROW BEFORE IT IN THE POOL
+	uint32_t row_count = snapshot->stack_count;
+	uint32_t pool_used = string_pool_length;
+	while (header->row_offset + row_count * sizeof(SnapshotRow) + pool_used > segment->size)
+	{
+		--row_count;
+		pool_used = snapshot->rows[row_count].index_offset;
+	}
+
+	uint32_t sequence = atomic_load_explicit(&(header->sequence), memory_order_relaxed);
+	atomic_store_explicit(&(header->sequence), sequence + 1, memory_order_relaxed); // ODD: READERS RETRY
+	atomic_thread_fence(memory_order_release);
+
+	header->row_count = row_count;
+	header->string_pool_offset = header->row_offset + row_count * sizeof(SnapshotRow);
+	header->string_pool_length = pool_used;
+	header->item_count = snapshot->item_count;
+	header->stack_count = snapshot->stack_count;
+	header->files_loaded = snapshot->files_loaded;
+	header->files_to_load = snapshot->files_to_load;
+	header->max_weight = snapshot->max_weight;
+	header->money = snapshot->money;
+	header->is_truncated = (row_count < snapshot->stack_count);
+	header->inventory_version = snapshot->version;
+	++(header->publish_count);
+	memcpy((char*)header + header->row_offset, snapshot->rows, row_count * sizeof(SnapshotRow));
+	memcpy((char*)header + header->string_pool_offset, snapshot->string_pool, pool_used);
+
+	atomic_store_explicit(&(header->sequence), sequence + 2, memory_order_release); // EVEN AGAIN: THE SEGMENT IS CONSISTENT
+}
+
+InventorySnapshot* SharedSegmentRead(SharedSegment* segment, uint32_t* stack_count)
+{
+	SharedInventoryHeader* shared_header = segment->header;
+	for (int retry = 0; retry < SHARED_READ_RETRIES; ++retry)
+	{
+		uint32_t sequence = atomic_load_explicit(&(shared_header->sequence), memory_order_acquire);
+		if (sequence & 1) // THE WRITER IS BUSY
+			continue;
+
+		SharedInventoryHeader header;
+		memcpy(&header, shared_header, sizeof header);
+
+		// THE OFFSETS CAN BE TORN BY A WRITE: CHECK THEM BEFORE THEY ARE USED, THE SEQUENCE CHECK BELOW DROPS THE COPY ANYWAY
+		InventorySnapshot* snapshot = NULL;
+		size_t rows_size = (size_t)header.row_count * sizeof(SnapshotRow);
+		if (header.row_offset + rows_size <= segment->size && header.string_pool_offset >= header.row_offset + rows_size
+			&& (size_t)header.string_pool_offset + header.string_pool_length <= segment->size)
+		{
+			size_t snapshot_size = sizeof(InventorySnapshot) + rows_size + header.string_pool_length;
+			snapshot = (InventorySnapshot*)malloc(snapshot_size);
+			if (snapshot == NULL)
+			{
+				printf("Failed to allocate memory for the shared inventory!\nExiting program!\n");
+				exit(2);
+			}
+			snapshot->size = snapshot_size;
+			snapshot->string_pool = (char*)(snapshot->rows + header.row_count);
+			memcpy(snapshot->rows, (char*)shared_header + header.row_offset, rows_size);
+			memcpy(snapshot->string_pool, (char*)shared_header + header.string_pool_offset, header.string_pool_length);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_explicit(&(shared_header->sequence), memory_order_relaxed) != sequence || snapshot == NULL) // A WRITE OVERLAPPED THE COPY
+		{
+			free(snapshot);
+			continue;
+		}
+
+		snapshot->version = header.inventory_version;
+		snapshot->max_weight = header.max_weight;
+		snapshot->money = header.money;
+		snapshot->item_count = header.item_count;
+		snapshot->stack_count = header.row_count; // ONLY THE ROWS THAT ARE IN THE SEGMENT
+		*stack_count = header.stack_count;
+		snapshot->files_loaded = header.files_loaded;
+		snapshot->files_to_load = header.files_to_load;
+		for (uint32_t row = 0; row < header.row_count; ++row) // A CORRUPTED ROW DOESN'T MAKE THE PRINT READ OUTSIDE THE POOL
+		{
+			SnapshotRow* snapshot_row = &(snapshot->rows[row]);
+			if ((uint64_t)snapshot_row->index_offset + snapshot_row->index_length > header.string_pool_length)
+				snapshot_row->index_length = 0;
+			if ((uint64_t)snapshot_row->name_offset + snapshot_row->name_length > header.string_pool_length)
+				snapshot_row->name_length = 0;
+		}
+		return snapshot;
+	}
+
+	return NULL;
+}
+
+bool SharedSegmentView(char* name)
+{
+	SharedSegment segment = { 0 };
+	snprintf(segment.name, sizeof segment.name, "%s", name);
+	if (!SharedSegmentOpen(&segment))
+	{
+		printf("No inventory is shared as %s.\n", name);
+		return false;
+	}
+
+	uint32_t writer_process_id = segment.header->writer_process_id; // ONLY WRITTEN WHEN THE SEGMENT IS CREATED
+	uint32_t stack_count = 0;
+	InventorySnapshot* snapshot = SharedSegmentRead(&segment, &stack_count);
+	SharedSegmentClose(&segment);
+	if (snapshot == NULL)
+	{
+		printf("The shared inventory %s kept changing while it was read.\n", name);
+		return false;
+	}
+
+	printf("Shared inventory %s of process %u, version %llu:\n", name, writer_process_id, (unsigned long long)snapshot->version);
+	printf("Total item amount: %u (%u different items)\n", snapshot->item_count, stack_count);
+	printf("Carring weight left: %.2f\n", snapshot->max_weight);
+	printf("Money amount: %dgp %dsp %dcp\n\n", snapshot->money.gp, snapshot->money.sp, snapshot->money.cp);
+	ItemPrintList(snapshot);
+	if (snapshot->stack_count < stack_count)
+		printf("The segment only holds the first %u of the %u items.\n", snapshot->stack_count, stack_count);
+	ItemLoaderPrintProgress(snapshot);
+
+	free(snapshot);
+	return true;
+}
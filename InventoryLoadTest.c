@@ -0,0 +1,867 @@
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h> // CreateProcess
+#include <psapi.h> // GetProcessMemoryInfo
+#include <direct.h> // _mkdir
+#include <io.h> // _findfirst
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h> // fork
+#include <dirent.h> // opendir
+#include <fcntl.h> // open
+#include <sys/stat.h> // mkdir
+#include <sys/wait.h> // WIFEXITED
+#include <sys/resource.h> // wait4
+#include <time.h> // clock_gettime
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+// End to end load test of the inventory program: generates a synthetic item folder and loadout, runs the inventory binary
+// with piped commands and compares wall time, peak memory and file calls against a stored baseline.
+// Example: InventoryLoadTest ./Inventory --items 5000 --copies 3 --runs 5 --save-baseline (stores the results as the baseline)
+//          InventoryLoadTest ./Inventory --items 5000 --copies 3 --runs 5                 (compares with the baseline)
+// Exit codes: 0 no regression, 1 invalid arguments, 2 out of memory, 3 file or process error, 4 regression past the threshold
+
+#define LOAD_ITEM_PREFIX      "load-item-"           // Only these files of the item folder are generated and deleted
+#define LOAD_WORK_DIR         "InventoryLoadTest_work"
+#define LOAD_BASELINE_FILE    "InventoryLoadTest_baseline.txt"
+#define LOAD_STATS_FILE       "Inventory_stats.json" // Written by the inventory on exit, in its working directory
+#define LOAD_CACHE_FILE       "Inventory_cache.bin"  // Parse cache of the inventory, next to its executable
+#define LOAD_COMMANDS_FILE    "commands.txt"         // Piped to the menu of the inventory
+#define LOAD_LOADOUT_FILE     "loadout.txt"          // @response file with the generated items
+#ifdef _WIN32
+#define LOAD_INVENTORY_COPY   "Inventory.exe"        // The binary is copied into the work folder: its parse cache stays there too
+#define PATH_SEPARATOR        "\\"
+#else
+#define LOAD_INVENTORY_COPY   "Inventory"
+#define PATH_SEPARATOR        "/"
+#endif
+#define LOAD_PATH_MAX         512
+#define LOAD_DIR_MAX          256                    // The work folder: the file names in it always fit in LOAD_PATH_MAX
+#define LOAD_MAX_RUNS         31
+#define LOAD_MIN_FILE_SIZE    320                    // The json fields without description padding
+
+#define SIZE_PROFILE_FIXED    0 // Every file has --min-size bytes
+#define SIZE_PROFILE_UNIFORM  1 // Uniform between --min-size and --max-size
+#define SIZE_PROFILE_SKEWED   2 // Like the real item folder: 9 of 10 files are small, the others have long descriptions up to --max-size
+
+#define SCENARIO_STARTUP          0 // No items: time until the menu quits
+#define SCENARIO_BULK_ADD_COLD    1 // The loadout without parse cache: every file is parsed
+#define SCENARIO_BULK_ADD_CACHED  2 // The loadout with the parse cache of the previous runs
+#define SCENARIO_BULK_DELETE      3 // The loadout, then --deletes copies deleted one by one in the item viewer
+#define SCENARIO_COUNT            4
+
+#define METRIC_WALL_MS      0
+#define METRIC_USER_MS      1
+#define METRIC_SYSTEM_MS    2
+#define METRIC_PEAK_RSS_KB  3
+#define METRIC_FILE_CALLS   4 // stdio calls counted by the inventory itself (file_calls in Inventory_stats.json)
+#define METRIC_COUNT        5
+
+const char* scenario_names[SCENARIO_COUNT] = { "startup", "bulk_add_cold", "bulk_add_cached", "bulk_delete" };
+const char* metric_names[METRIC_COUNT] = { "wall_ms", "user_ms", "system_ms", "peak_rss_kb", "file_calls" };
+const bool is_metric_gated[METRIC_COUNT] = { true, false, false, true, true }; // CPU times are already part of the wall time
+const char* size_profile_names[3] = { "fixed", "uniform", "skewed" };
+
+typedef struct LoadConfig
+{
+	char inventory_path[LOAD_PATH_MAX]; // The executable under test
+	char work_dir[LOAD_DIR_MAX];
+	char baseline_path[LOAD_PATH_MAX];
+	uint32_t item_count;
+	uint32_t copies;          // Copies of every item in the loadout
+	uint32_t delete_count;    // Copies deleted in the bulk delete scenario
+	uint32_t runs;            // The median of the runs is kept
+	uint32_t min_size;
+	uint32_t max_size;
+	uint8_t size_profile;
+	uint64_t seed;
+	double threshold_percent;
+	double slack_ms;          // Wall time differences below this are noise, also when they are a big percentage
+	double slack_kb;          // The same for peak memory
+	bool is_argv_loadout;     // The items as separate arguments instead of an @response file
+	bool is_baseline_saved;
+} LoadConfig;
+
+// ARGUMENTS
+void PrintUsage(void);
+void ParseArgs(int argc, char* argv[], LoadConfig* config);
+bool ParseUnsigned(const char* text, uint32_t* value);
+
+// SYNTHETIC ITEM FOLDER AND LOADOUT
+uint64_t RandomNext(uint64_t* state);                    // xorshift64*: the same seed gives the same folder on every system
+uint32_t RandomFileSize(LoadConfig* config, uint64_t* random_state);
+bool GenerateItemFolder(LoadConfig* config);             // Replaces the generated json files of a previous run
+bool RemoveGeneratedItems(char* folder_path);
+bool WriteLoadout(LoadConfig* config);
+bool WriteCommands(LoadConfig* config, uint8_t scenario);
+bool CopyExecutable(char* source_path, char* destination_path);
+bool MakeDirectory(char* path);
+
+// RUNNING THE INVENTORY
+bool RunScenario(LoadConfig* config, uint8_t scenario, double metrics[METRIC_COUNT]); // One run, false if the inventory couldn't run or failed
+bool RunInventory(LoadConfig* config, char** arguments, double metrics[METRIC_COUNT]); // Fills wall, cpu and memory metrics
+double ReadFileCalls(char* stats_path);                  // Sum of the file call counters of the inventory, -1 if the stats file is missing
+double MedianOf(double* values, uint32_t count);
+
+// BASELINE
+bool SaveBaseline(LoadConfig* config, double results[SCENARIO_COUNT][METRIC_COUNT]);
+int CompareBaseline(LoadConfig* config, double results[SCENARIO_COUNT][METRIC_COUNT]); // Exit code: 0, 3 or 4
+void FormatConfig(LoadConfig* config, char* buffer, size_t buffer_size);               // The settings that have to match between baseline and run
+
+int main(int argc, char* argv[])
+{
+	LoadConfig config = { 0 };
+	ParseArgs(argc, argv, &config);
+
+	char config_text[256];
+	FormatConfig(&config, config_text, sizeof config_text);
+	printf("Inventory load test: %s, %u runs\n", config_text, config.runs);
+
+	if (!GenerateItemFolder(&config) || !WriteLoadout(&config))
+		return 3;
+
+	char inventory_copy_path[LOAD_PATH_MAX];
+	snprintf(inventory_copy_path, sizeof inventory_copy_path, "%s" PATH_SEPARATOR LOAD_INVENTORY_COPY, config.work_dir);
+	if (!CopyExecutable(config.inventory_path, inventory_copy_path))
+	{
+		printf("Failed to copy %s to %s!\nExiting program!\n", config.inventory_path, inventory_copy_path);
+		return 3;
+	}
+
+	double warmup_metrics[METRIC_COUNT];
+	if (!RunScenario(&config, SCENARIO_STARTUP, warmup_metrics)) // LOADS THE BINARY AND THE FOLDER INTO THE OS CACHE, NOT COUNTED
+		return 3;
+
+	double results[SCENARIO_COUNT][METRIC_COUNT] = { 0 };
+	printf("\n%-16s %10s %10s %10s %12s %11s\n", "scenario", "wall ms", "user ms", "system ms", "peak RSS KB", "file calls");
+	for (uint8_t scenario = 0; scenario < SCENARIO_COUNT; ++scenario)
+	{
+		double run_metrics[METRIC_COUNT][LOAD_MAX_RUNS];
+		for (uint32_t run = 0; run < config.runs; ++run)
+		{
+			double metrics[METRIC_COUNT];
+			if (!RunScenario(&config, scenario, metrics))
+				return 3;
+			for (uint8_t metric = 0; metric < METRIC_COUNT; ++metric)
+				run_metrics[metric][run] = metrics[metric];
+		}
+
+		for (uint8_t metric = 0; metric < METRIC_COUNT; ++metric)
+			results[scenario][metric] = MedianOf(run_metrics[metric], config.runs);
+		printf("%-16s %10.1f %10.1f %10.1f %12.0f %11.0f\n", scenario_names[scenario], results[scenario][METRIC_WALL_MS], results[scenario][METRIC_USER_MS],
+			results[scenario][METRIC_SYSTEM_MS], results[scenario][METRIC_PEAK_RSS_KB], results[scenario][METRIC_FILE_CALLS]);
+	}
+	printf("\n");
+
+	if (config.is_baseline_saved)
+		return (SaveBaseline(&config, results)) ? 0 : 3;
+	return CompareBaseline(&config, results);
+}
+
+void PrintUsage(void)
+{
+	printf("Usage: InventoryLoadTest <inventory executable> [options]\n");
+	printf("  --items N            json files in the generated item folder (default 2000)\n");
+	printf("  --copies N           copies of every item in the loadout (default 3)\n");
+	printf("  --deletes N          copies deleted one by one in the bulk delete scenario (default 500)\n");
+	printf("  --size-profile P     fixed, uniform or skewed file sizes (default skewed)\n");
+	printf("  --min-size B         smallest json file in bytes (default 400)\n");
+	printf("  --max-size B         biggest json file in bytes (default 16384)\n");
+	printf("  --seed N             seed of the generated folder (default 1)\n");
+	printf("  --runs N             runs per scenario, the median is kept (default 3, max %d)\n", LOAD_MAX_RUNS);
+	printf("  --argv-loadout       pass the items as arguments instead of an @response file\n");
+	printf("  --work-dir DIR       folder for the generated files (default %s)\n", LOAD_WORK_DIR);
+	printf("  --baseline FILE      baseline file (default %s)\n", LOAD_BASELINE_FILE);
+	printf("  --save-baseline      store the results as the new baseline instead of comparing\n");
+	printf("  --threshold PCT      allowed regression in percent (default 10)\n");
+	printf("  --slack-ms MS        wall time difference that is always allowed (default 5)\n");
+	printf("  --slack-kb KB        peak memory difference that is always allowed (default 1024)\n");
+}
+
+void ParseArgs(int argc, char* argv[], LoadConfig* config)
+{
+	config->item_count = 2000;
+	config->copies = 3;
+	config->delete_count = 500;
+	config->runs = 3;
+	config->min_size = 400;
+	config->max_size = 16384;
+	config->size_profile = SIZE_PROFILE_SKEWED;
+	config->seed = 1;
+	config->threshold_percent = 10.0;
+	config->slack_ms = 5.0;
+	config->slack_kb = 1024.0;
+	snprintf(config->work_dir, sizeof config->work_dir, "%s", LOAD_WORK_DIR);
+	snprintf(config->baseline_path, sizeof config->baseline_path, "%s", LOAD_BASELINE_FILE);
+
+	if (argc < 2 || *argv[1] == '-')
+	{
+		PrintUsage();
+		exit(1);
+	}
+	snprintf(config->inventory_path, sizeof config->inventory_path, "%s", argv[1]);
+
+	for (int i = 2; i < argc; ++i)
+	{
+		char* option = argv[i];
+		char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		bool is_valid = true;
+
+		if (strcmp(option, "--argv-loadout") == 0)
+		{
+			config->is_argv_loadout = true;
+			continue;
+		}
+		else if (strcmp(option, "--save-baseline") == 0)
+		{
+			config->is_baseline_saved = true;
+			continue;
+		}
+		else if (value == NULL)
+			is_valid = false;
+		else if (strcmp(option, "--items") == 0)
+			is_valid = ParseUnsigned(value, &(config->item_count)) && config->item_count > 0 && config->item_count <= 999999;
+		else if (strcmp(option, "--copies") == 0)
+			is_valid = ParseUnsigned(value, &(config->copies)) && config->copies > 0;
+		else if (strcmp(option, "--deletes") == 0)
+			is_valid = ParseUnsigned(value, &(config->delete_count));
+		else if (strcmp(option, "--runs") == 0)
+			is_valid = ParseUnsigned(value, &(config->runs)) && config->runs > 0 && config->runs <= LOAD_MAX_RUNS;
+		else if (strcmp(option, "--min-size") == 0)
+			is_valid = ParseUnsigned(value, &(config->min_size));
+		else if (strcmp(option, "--max-size") == 0)
+			is_valid = ParseUnsigned(value, &(config->max_size));
+		else if (strcmp(option, "--seed") == 0)
+		{
+			uint32_t seed = 0;
+			is_valid = ParseUnsigned(value, &seed);
+			config->seed = seed;
+		}
+		else if (strcmp(option, "--size-profile") == 0)
+		{
+			if (strcmp(value, "fixed") == 0)
+				config->size_profile = SIZE_PROFILE_FIXED;
+			else if (strcmp(value, "uniform") == 0)
+				config->size_profile = SIZE_PROFILE_UNIFORM;
+			else if (strcmp(value, "skewed") == 0)
+				config->size_profile = SIZE_PROFILE_SKEWED;
+			else
+				is_valid = false;
+		}
+		else if (strcmp(option, "--threshold") == 0 || strcmp(option, "--slack-ms") == 0 || strcmp(option, "--slack-kb") == 0)
+		{
+			char* number_end = NULL;
+			double number = strtod(value, &number_end);
+			is_valid = number_end != value && *number_end == '\0' && number >= 0.0;
+			if (strcmp(option, "--threshold") == 0)
+				config->threshold_percent = number;
+			else if (strcmp(option, "--slack-ms") == 0)
+				config->slack_ms = number;
+			else
+				config->slack_kb = number;
+		}
+		else if (strcmp(option, "--work-dir") == 0)
+			is_valid = snprintf(config->work_dir, sizeof config->work_dir, "%s", value) < (int)sizeof config->work_dir;
+		else if (strcmp(option, "--baseline") == 0)
+			is_valid = snprintf(config->baseline_path, sizeof config->baseline_path, "%s", value) < (int)sizeof config->baseline_path;
+		else
+		{
+			printf("Unknown option: %s\n", option);
+			PrintUsage();
+			exit(1);
+		}
+
+		if (!is_valid)
+		{
+			printf("Invalid value for %s.\n", option);
+			PrintUsage();
+			exit(1);
+		}
+		++i; // THE VALUE OF THE OPTION
+	}
+
+	if (config->min_size < LOAD_MIN_FILE_SIZE)
+		config->min_size = LOAD_MIN_FILE_SIZE;
+	if (config->max_size < config->min_size)
+		config->max_size = config->min_size;
+	if ((uint64_t)config->delete_count > (uint64_t)config->item_count * config->copies)
+		config->delete_count = config->item_count * config->copies;
+}
+
+bool ParseUnsigned(const char* text, uint32_t* value)
+{
+	uint64_t number = 0;
+	const char* c = text;
+	for (; *c >= '0' && *c <= '9'; ++c)
+	{
+		number = number * 10 + (uint64_t)(*c - '0');
+		if (number > UINT32_MAX)
+			return false;
+	}
+
+	if (c == text || *c != '\0')
+		return false;
+	*value = (uint32_t)number;
+	return true;
+}
+
+uint64_t RandomNext(uint64_t* state)
+{
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t RandomFileSize(LoadConfig* config, uint64_t* random_state)
+{
+	uint32_t range = config->max_size - config->min_size + 1;
+	switch (config->size_profile)
+	{
+	case SIZE_PROFILE_UNIFORM:
+		return config->min_size + (uint32_t)(RandomNext(random_state) % range);
+	case SIZE_PROFILE_SKEWED:
+		if (RandomNext(random_state) % 10 != 0) // MOST ITEMS: A SHORT DESCRIPTION, AT MOST 2x THE SMALLEST FILE
+		{
+			uint32_t small_range = (range < config->min_size) ? range : config->min_size;
+			return config->min_size + (uint32_t)(RandomNext(random_state) % small_range);
+		}
+		return config->min_size + (uint32_t)(RandomNext(random_state) % range);
+	default:
+		return config->min_size;
+	}
+}
+
+bool GenerateItemFolder(LoadConfig* config)
+{
+	static const char filler[] = "A generated item description to give the json file its size. ";
+
+	char folder_path[LOAD_DIR_MAX + 16];
+	snprintf(folder_path, sizeof folder_path, "%s" PATH_SEPARATOR "Items_JSON", config->work_dir);
+	if (!MakeDirectory(config->work_dir) || !MakeDirectory(folder_path) || !RemoveGeneratedItems(folder_path))
+	{
+		printf("Failed to prepare the item folder %s!\nExiting program!\n", folder_path);
+		return false;
+	}
+
+	char* json = (char*)malloc((size_t)config->max_size + 1024);
+	if (json == NULL)
+	{
+		printf("Failed to allocate memory for the json text!\nExiting program!\n");
+		exit(2);
+	}
+
+	static const char* units[3] = { "gp", "sp", "cp" };
+	uint64_t random_state = config->seed * 0x9E3779B97F4A7C15ULL + 1; // xorshift NEEDS A STATE THAT ISN'T 0
+	uint64_t bytes_written = 0;
+	for (uint32_t i = 0; i < config->item_count; ++i)
+	{
+		uint32_t target_size = RandomFileSize(config, &random_state);
+		uint64_t unit_choice = RandomNext(&random_state) % 5; // 1 IN 5 COSTS GOLD: THE WHOLE LOADOUT STAYS AFFORDABLE
+		const char* unit = units[(unit_choice == 0) ? 0 : (unit_choice <= 2) ? 1 : 2];
+		uint32_t quantity = 1 + (uint32_t)(RandomNext(&random_state) % ((unit_choice == 0) ? 20 : 99));
+		uint32_t weight_quarters = (uint32_t)(RandomNext(&random_state) % 81); // 0 TO 20 IN STEPS OF 0.25
+
+		int length = snprintf(json, (size_t)config->max_size + 1024,
+			"{\n  \"index\": \"" LOAD_ITEM_PREFIX "%06u\",\n  \"name\": \"Load Item %u\",\n"
+			"  \"equipment_category\": {\n    \"index\": \"adventuring-gear\",\n    \"name\": \"Adventuring Gear\",\n    \"url\": \"/api/equipment-categories/adventuring-gear\"\n  },\n"
+			"  \"cost\": {\n    \"quantity\": %u,\n    \"unit\": \"%s\"\n  },\n  \"weight\": %u.%02u,\n  \"desc\": [\n    \"",
+			i, i, quantity, unit, weight_quarters / 4, (weight_quarters % 4) * 25);
+		const char* tail_format = "\"\n  ],\n  \"url\": \"/api/equipment/" LOAD_ITEM_PREFIX "%06u\"\n}\n";
+		int tail_length = (int)strlen(tail_format) - 4 + 6; // "%06u" BECOMES 6 DIGITS
+
+		int padding = (int)target_size - length - tail_length;
+		for (int p = 0; p < padding; ++p)
+			json[length++] = filler[p % (sizeof filler - 1)];
+		length += snprintf(json + length, (size_t)config->max_size + 1024 - length, tail_format, i);
+
+		char file_path[LOAD_PATH_MAX];
+		snprintf(file_path, sizeof file_path, "%s" PATH_SEPARATOR LOAD_ITEM_PREFIX "%06u.json", folder_path, i);
+		FILE* file = fopen(file_path, "wb");
+		if (file == NULL || fwrite(json, 1, length, file) != (size_t)length)
+		{
+			printf("Failed to write %s!\nExiting program!\n", file_path);
+			if (file)
+				fclose(file);
+			free(json);
+			return false;
+		}
+		fclose(file);
+		bytes_written += length;
+	}
+
+	free(json);
+	printf("Generated %u json files (%llu bytes, %s sizes) in %s.\n", config->item_count, (unsigned long long)bytes_written, size_profile_names[config->size_profile], folder_path);
+	return true;
+}
+
+#ifdef _WIN32 // Windows system
+bool RemoveGeneratedItems(char* folder_path)
+{
+	char pattern[LOAD_PATH_MAX];
+	snprintf(pattern, sizeof pattern, "%s\\" LOAD_ITEM_PREFIX "*.json", folder_path);
+
+	struct _finddata_t file_info;
+	intptr_t find_handle = _findfirst(pattern, &file_info);
+	if (find_handle == -1)
+		return true; // NOTHING GENERATED YET
+
+	do
+	{
+		char file_path[LOAD_PATH_MAX];
+		snprintf(file_path, sizeof file_path, "%s\\%s", folder_path, file_info.name);
+		remove(file_path);
+	} while (_findnext(find_handle, &file_info) == 0);
+
+	_findclose(find_handle);
+	return true;
+}
+
+bool MakeDirectory(char* path)
+{
+	return _mkdir(path) == 0 || errno == EEXIST;
+}
+#else // Linux system
+bool RemoveGeneratedItems(char* folder_path)
+{
+	DIR* folder = opendir(folder_path);
+	if (folder == NULL)
+		return false;
+
+	struct dirent* entry = NULL;
+	while ((entry = readdir(folder)) != NULL)
+	{
+		size_t name_length = strlen(entry->d_name);
+		if (strncmp(entry->d_name, LOAD_ITEM_PREFIX, sizeof LOAD_ITEM_PREFIX - 1) == 0 && name_length > 5 && strcmp(entry->d_name + name_length - 5, ".json") == 0)
+		{
+			char file_path[LOAD_PATH_MAX];
+			snprintf(file_path, sizeof file_path, "%s/%s", folder_path, entry->d_name);
+			unlink(file_path);
+		}
+	}
+
+	closedir(folder);
+	return true;
+}
+
+bool MakeDirectory(char* path)
+{
+	return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+#endif
+
+bool WriteLoadout(LoadConfig* config)
+{
+	char loadout_path[LOAD_PATH_MAX];
+	snprintf(loadout_path, sizeof loadout_path, "%s" PATH_SEPARATOR LOAD_LOADOUT_FILE, config->work_dir);
+	FILE* file = fopen(loadout_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to write %s!\nExiting program!\n", loadout_path);
+		return false;
+	}
+
+	fprintf(file, "# Generated by InventoryLoadTest: %u items, %u copies each\n", config->item_count, config->copies);
+	for (uint32_t i = 0; i < config->item_count; ++i)
+		fprintf(file, LOAD_ITEM_PREFIX "%06u.json %u\n", i, config->copies);
+
+	return fclose(file) == 0;
+}
+
+bool WriteCommands(LoadConfig* config, uint8_t scenario)
+{
+	char commands_path[LOAD_PATH_MAX];
+	snprintf(commands_path, sizeof commands_path, "%s" PATH_SEPARATOR LOAD_COMMANDS_FILE, config->work_dir);
+	FILE* file = fopen(commands_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to write %s!\nExiting program!\n", commands_path);
+		return false;
+	}
+
+	if (scenario == SCENARIO_BULK_DELETE)
+	{
+		fputs("I\n", file); // THE ITEM VIEWER DELETES ONE COPY PER X, CONFIRMED WITH Y
+		for (uint32_t i = 0; i < config->delete_count; ++i)
+			fputs("X\nY\n", file);
+		fputs("Q\n", file);
+	}
+	fputs("Q\nY\n", file);
+
+	return fclose(file) == 0;
+}
+
+bool CopyExecutable(char* source_path, char* destination_path)
+{
+	FILE* source = fopen(source_path, "rb");
+	if (source == NULL)
+		return false;
+	FILE* destination = fopen(destination_path, "wb");
+	if (destination == NULL)
+	{
+		fclose(source);
+		return false;
+	}
+
+	char buffer[65536];
+	size_t read_count = 0;
+	bool is_copied = true;
+	while (is_copied && (read_count = fread(buffer, 1, sizeof buffer, source)) > 0)
+		is_copied = fwrite(buffer, 1, read_count, destination) == read_count;
+
+	fclose(source);
+	is_copied = (fclose(destination) == 0) && is_copied;
+#ifndef _WIN32 // Linux system
+	is_copied = is_copied && chmod(destination_path, 0755) == 0;
+#endif
+	return is_copied;
+}
+
+bool RunScenario(LoadConfig* config, uint8_t scenario, double metrics[METRIC_COUNT])
+{
+	char stats_path[LOAD_PATH_MAX];
+	char cache_path[LOAD_PATH_MAX];
+	snprintf(stats_path, sizeof stats_path, "%s" PATH_SEPARATOR LOAD_STATS_FILE, config->work_dir);
+	snprintf(cache_path, sizeof cache_path, "%s" PATH_SEPARATOR LOAD_CACHE_FILE, config->work_dir);
+	remove(stats_path);
+	if (scenario == SCENARIO_BULK_ADD_COLD)
+		remove(cache_path);
+
+	if (!WriteCommands(config, scenario))
+		return false;
+
+	// ARGUMENTS: MONEY AND WEIGHT ENOUGH FOR THE WHOLE LOADOUT, THEN THE LOADOUT AS RESPONSE FILE OR AS SEPARATE ARGUMENTS
+	uint32_t argument_capacity = 10 + ((config->is_argv_loadout) ? config->item_count * 2 : 1);
+	char** arguments = (char**)calloc(argument_capacity, sizeof(char*));
+	char* argument_text = (char*)malloc((config->is_argv_loadout) ? (size_t)config->item_count * 40 : 1);
+	if (arguments == NULL || argument_text == NULL)
+	{
+		printf("Failed to allocate memory for the arguments!\nExiting program!\n");
+		exit(2);
+	}
+
+	char inventory_path[LOAD_PATH_MAX];
+#ifdef _WIN32 // Windows system
+	char work_dir_full[LOAD_PATH_MAX];
+	if (_fullpath(work_dir_full, config->work_dir, sizeof work_dir_full) == NULL)
+		snprintf(work_dir_full, sizeof work_dir_full, "%s", config->work_dir);
+	snprintf(inventory_path, sizeof inventory_path, "%s\\" LOAD_INVENTORY_COPY, work_dir_full);
+#else // Linux system
+	snprintf(inventory_path, sizeof inventory_path, "./" LOAD_INVENTORY_COPY); // THE CHILD RUNS IN THE WORK FOLDER
+#endif
+
+	uint32_t argument_count = 0;
+	arguments[argument_count++] = inventory_path;
+	arguments[argument_count++] = "-w";
+	arguments[argument_count++] = "100000000";
+	arguments[argument_count++] = "-m";
+	arguments[argument_count++] = "200000gp";
+	arguments[argument_count++] = "0sp";
+	arguments[argument_count++] = "0cp";
+	if (scenario != SCENARIO_STARTUP && config->is_argv_loadout)
+	{
+		char* text = argument_text;
+		for (uint32_t i = 0; i < config->item_count; ++i)
+		{
+			arguments[argument_count++] = text;
+			text += sprintf(text, LOAD_ITEM_PREFIX "%06u.json", i) + 1;
+			arguments[argument_count++] = text;
+			text += sprintf(text, "%u", config->copies) + 1;
+		}
+	}
+	else if (scenario != SCENARIO_STARTUP)
+		arguments[argument_count++] = "@" LOAD_LOADOUT_FILE;
+	arguments[argument_count] = NULL;
+
+	bool is_run = RunInventory(config, arguments, metrics);
+	free(arguments);
+	free(argument_text);
+	if (!is_run)
+		return false;
+
+	metrics[METRIC_FILE_CALLS] = ReadFileCalls(stats_path);
+	if (metrics[METRIC_FILE_CALLS] < 0.0)
+	{
+		printf("The inventory didn't write %s!\nExiting program!\n", stats_path);
+		return false;
+	}
+	return true;
+}
+
+#ifdef _WIN32 // Windows system
+bool RunInventory(LoadConfig* config, char** arguments, double metrics[METRIC_COUNT])
+{
+	char command_line[32768] = { 0 }; // THE LIMIT OF CreateProcess
+	size_t command_length = 0;
+	for (char** argument = arguments; *argument != NULL; ++argument)
+	{
+		int written = snprintf(command_line + command_length, sizeof command_line - command_length, "%s\"%s\"", (argument == arguments) ? "" : " ", *argument);
+		if (written < 0 || (size_t)written >= sizeof command_line - command_length)
+		{
+			printf("The command line is too long for Windows, use the @response file loadout.\nExiting program!\n");
+			return false;
+		}
+		command_length += written;
+	}
+
+	char commands_path[LOAD_PATH_MAX];
+	snprintf(commands_path, sizeof commands_path, "%s\\" LOAD_COMMANDS_FILE, config->work_dir);
+	SECURITY_ATTRIBUTES inherit = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+	HANDLE input = CreateFileA(commands_path, GENERIC_READ, FILE_SHARE_READ, &inherit, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	HANDLE output = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &inherit, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (input == INVALID_HANDLE_VALUE || output == INVALID_HANDLE_VALUE)
+	{
+		printf("Failed to open %s or NUL!\nExiting program!\n", commands_path);
+		return false;
+	}
+
+	STARTUPINFOA startup_info = { 0 };
+	startup_info.cb = sizeof startup_info;
+	startup_info.dwFlags = STARTF_USESTDHANDLES;
+	startup_info.hStdInput = input;
+	startup_info.hStdOutput = output;
+	startup_info.hStdError = output;
+	PROCESS_INFORMATION process = { 0 };
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	bool is_started = CreateProcessA(arguments[0], command_line, NULL, NULL, TRUE, 0, NULL, config->work_dir, &startup_info, &process);
+	CloseHandle(input);
+	CloseHandle(output);
+	if (!is_started)
+	{
+		printf("Failed to start %s!\nExiting program!\n", arguments[0]);
+		return false;
+	}
+
+	WaitForSingleObject(process.hProcess, INFINITE);
+	QueryPerformanceCounter(&end);
+
+	DWORD exit_code = 0;
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	PROCESS_MEMORY_COUNTERS memory = { 0 };
+	GetExitCodeProcess(process.hProcess, &exit_code);
+	GetProcessTimes(process.hProcess, &creation_time, &exit_time, &kernel_time, &user_time);
+	GetProcessMemoryInfo(process.hProcess, &memory, sizeof memory);
+	CloseHandle(process.hProcess);
+	CloseHandle(process.hThread);
+
+	metrics[METRIC_WALL_MS] = (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+	metrics[METRIC_USER_MS] = (double)(((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime) / 10000.0;     // 100 ns UNITS
+	metrics[METRIC_SYSTEM_MS] = (double)(((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) / 10000.0;
+	metrics[METRIC_PEAK_RSS_KB] = (double)memory.PeakWorkingSetSize / 1024.0;
+
+	if (exit_code != 0)
+	{
+		printf("The inventory exited with code %lu!\nExiting program!\n", (unsigned long)exit_code);
+		return false;
+	}
+	return true;
+}
+#else // Linux system
+bool RunInventory(LoadConfig* config, char** arguments, double metrics[METRIC_COUNT])
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	pid_t child = fork();
+	if (child < 0)
+	{
+		printf("Failed to start %s!\nExiting program!\n", arguments[0]);
+		return false;
+	}
+	if (child == 0) // THE INVENTORY: RUNS IN THE WORK FOLDER, READS THE COMMANDS FILE, ITS OUTPUT ISN'T KEPT
+	{
+		int input = -1;
+		int output = open("/dev/null", O_WRONLY);
+		if (chdir(config->work_dir) != 0 || (input = open(LOAD_COMMANDS_FILE, O_RDONLY)) < 0 || output < 0)
+			_exit(127);
+		dup2(input, STDIN_FILENO);
+		dup2(output, STDOUT_FILENO);
+		dup2(output, STDERR_FILENO);
+		execv(arguments[0], arguments);
+		_exit(127);
+	}
+
+	int status = 0;
+	struct rusage usage = { 0 };
+	if (wait4(child, &status, 0, &usage) != child)
+	{
+		printf("Failed to wait for %s!\nExiting program!\n", arguments[0]);
+		return false;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	metrics[METRIC_WALL_MS] = (double)(end.tv_sec - start.tv_sec) * 1000.0 + (double)(end.tv_nsec - start.tv_nsec) / 1000000.0;
+	metrics[METRIC_USER_MS] = (double)usage.ru_utime.tv_sec * 1000.0 + (double)usage.ru_utime.tv_usec / 1000.0;
+	metrics[METRIC_SYSTEM_MS] = (double)usage.ru_stime.tv_sec * 1000.0 + (double)usage.ru_stime.tv_usec / 1000.0;
+	metrics[METRIC_PEAK_RSS_KB] = (double)usage.ru_maxrss; // KILOBYTES ON LINUX
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		printf("The inventory %s with code %d!\nExiting program!\n", WIFEXITED(status) ? "exited" : "was stopped by signal", WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+		return false;
+	}
+	return true;
+}
+#endif
+
+double ReadFileCalls(char* stats_path)
+{
+	static const char* counters[] = { "\"opens\":", "\"reads\":", "\"writes\":", "\"seeks\":", "\"closes\":", "\"access_checks\":", "\"directory_reads\":", "\"maps\":" };
+
+	FILE* file = fopen(stats_path, "rb");
+	if (file == NULL)
+		return -1.0;
+
+	char text[16384]; // THE STATS FILE IS A FEW KILOBYTES
+	size_t length = fread(text, 1, sizeof text - 1, file);
+	fclose(file);
+	text[length] = '\0';
+
+	char* file_calls = strstr(text, "\"file_calls\"");
+	if (file_calls == NULL)
+		return -1.0;
+
+	double total = 0.0;
+	for (size_t i = 0; i < sizeof counters / sizeof counters[0]; ++i)
+	{
+		char* counter = strstr(file_calls, counters[i]);
+		if (counter != NULL) // OLDER BUILDS DON'T HAVE EVERY COUNTER
+			total += strtod(counter + strlen(counters[i]), NULL);
+	}
+	return total;
+}
+
+double MedianOf(double* values, uint32_t count)
+{
+	for (uint32_t i = 1; i < count; ++i) // INSERTION SORT: AT MOST LOAD_MAX_RUNS VALUES
+	{
+		double value = values[i];
+		uint32_t j = i;
+		for (; j > 0 && values[j - 1] > value; --j)
+			values[j] = values[j - 1];
+		values[j] = value;
+	}
+	return (count % 2 == 1) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0;
+}
+
+void FormatConfig(LoadConfig* config, char* buffer, size_t buffer_size)
+{
+	snprintf(buffer, buffer_size, "items %u copies %u deletes %u size-profile %s min-size %u max-size %u seed %llu loadout %s",
+		config->item_count, config->copies, config->delete_count, size_profile_names[config->size_profile], config->min_size, config->max_size,
+		(unsigned long long)config->seed, (config->is_argv_loadout) ? "argv" : "response-file");
+}
+
+bool SaveBaseline(LoadConfig* config, double results[SCENARIO_COUNT][METRIC_COUNT])
+{
+	FILE* file = fopen(config->baseline_path, "wb");
+	if (file == NULL)
+	{
+		printf("Failed to write baseline %s!\nExiting program!\n", config->baseline_path);
+		return false;
+	}
+
+	char config_text[256];
+	FormatConfig(config, config_text, sizeof config_text);
+	fprintf(file, "# InventoryLoadTest baseline: <scenario> <metric> <median>\nconfig %s\n", config_text);
+	for (uint8_t scenario = 0; scenario < SCENARIO_COUNT; ++scenario)
+	{
+		for (uint8_t metric = 0; metric < METRIC_COUNT; ++metric)
+			fprintf(file, "%s %s %.3f\n", scenario_names[scenario], metric_names[metric], results[scenario][metric]);
+	}
+
+	if (fclose(file) != 0)
+	{
+		printf("Failed to write baseline %s!\nExiting program!\n", config->baseline_path);
+		return false;
+	}
+	printf("Baseline saved to %s.\n", config->baseline_path);
+	return true;
+}
+
+int CompareBaseline(LoadConfig* config, double results[SCENARIO_COUNT][METRIC_COUNT])
+{
+	FILE* file = fopen(config->baseline_path, "rb");
+	if (file == NULL)
+	{
+		printf("No baseline %s found. Run with --save-baseline first.\n", config->baseline_path);
+		return 3;
+	}
+
+	double baseline[SCENARIO_COUNT][METRIC_COUNT];
+	bool is_known[SCENARIO_COUNT][METRIC_COUNT] = { { false } };
+	bool is_config_matching = false;
+	char config_text[256];
+	FormatConfig(config, config_text, sizeof config_text);
+
+	char line[512];
+	while (fgets(line, sizeof line, file) != NULL)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		if (*line == '#' || *line == '\0')
+			continue;
+		if (strncmp(line, "config ", 7) == 0)
+		{
+			is_config_matching = (strcmp(line + 7, config_text) == 0);
+			continue;
+		}
+
+		char scenario_name[64];
+		char metric_name[64];
+		double value = 0.0;
+		if (sscanf(line, "%63s %63s %lf", scenario_name, metric_name, &value) != 3)
+			continue;
+		for (uint8_t scenario = 0; scenario < SCENARIO_COUNT; ++scenario)
+		{
+			for (uint8_t metric = 0; metric < METRIC_COUNT; ++metric)
+			{
+				if (strcmp(scenario_name, scenario_names[scenario]) == 0 && strcmp(metric_name, metric_names[metric]) == 0)
+				{
+					baseline[scenario][metric] = value;
+					is_known[scenario][metric] = true;
+				}
+			}
+		}
+	}
+	fclose(file);
+
+	if (!is_config_matching) // OTHER SETTINGS: THE NUMBERS CAN'T BE COMPARED
+	{
+		printf("The baseline %s was recorded with other settings. Run with the same settings or with --save-baseline.\nThis run: %s\n", config->baseline_path, config_text);
+		return 3;
+	}
+
+	uint32_t regression_count = 0;
+	printf("Compared with %s (threshold %.1f%%):\n", config->baseline_path, config->threshold_percent);
+	for (uint8_t scenario = 0; scenario < SCENARIO_COUNT; ++scenario)
+	{
+		for (uint8_t metric = 0; metric < METRIC_COUNT; ++metric)
+		{
+			if (!is_metric_gated[metric] || !is_known[scenario][metric])
+				continue;
+
+			double slack = (metric == METRIC_WALL_MS) ? config->slack_ms : (metric == METRIC_PEAK_RSS_KB) ? config->slack_kb : 0.0; // FILE CALLS ARE EXACT COUNTS
+			double allowed = baseline[scenario][metric] * (1.0 + config->threshold_percent / 100.0) + slack;
+			double change_percent = (baseline[scenario][metric] > 0.0) ? (results[scenario][metric] / baseline[scenario][metric] - 1.0) * 100.0 : 0.0;
+			bool is_regression = results[scenario][metric] > allowed;
+			regression_count += is_regression;
+			printf("  %-16s %-12s %12.1f baseline %12.1f (%+6.1f%%) %s\n", scenario_names[scenario], metric_names[metric], results[scenario][metric],
+				baseline[scenario][metric], change_percent, (is_regression) ? "REGRESSION" : "ok");
+		}
+	}
+
+	if (regression_count > 0)
+	{
+		printf("%u regressions past the threshold.\n", regression_count);
+		return 4;
+	}
+	printf("No regressions.\n");
+	return 0;
+}